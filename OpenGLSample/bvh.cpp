@@ -0,0 +1,530 @@
+#include <algorithm>        // fill, min, max, swap
+#include <cmath>            // fabs
+#include <limits>           // numeric_limits
+
+#include "bvh.h"
+
+using namespace std; // Standard namespace
+
+/* Surface area heuristic build with binned split candidates, after Wald, "On fast Construction of SAH-based
+ * Bounding Volume Hierarchies" (2007).
+ *
+ * A ray or frustum reaches a child with a probability proportional to the child's surface area, so splitting
+ * a node costs roughly TRAVERSAL_COST plus, for each side, its area over the node's times its object count.
+ * Each node sorts its objects' centers into SAH_BINS slots along every axis and evaluates the planes between
+ * slots; it stays a leaf when no split beats testing its objects directly.
+ */
+
+// Unnamed namespace
+namespace
+{
+    const uint32_t MAX_LEAF_OBJECTS = 8;    // more are always split, even when the heuristic disagrees
+    const uint32_t SAH_BINS = 16;
+    const float TRAVERSAL_COST = 1.0f;      // visiting a node, relative to testing one object
+
+    // Axis-aligned box as corners; starts inside out so the first Grow sets it
+    struct Aabb
+    {
+        glm::vec3 low = glm::vec3(numeric_limits<float>::max());
+        glm::vec3 high = glm::vec3(-numeric_limits<float>::max());
+
+        void Grow(const glm::vec3& point) { low = glm::min(low, point); high = glm::max(high, point); }
+        void Grow(const Aabb& box) { low = glm::min(low, box.low); high = glm::max(high, box.high); }
+
+        // Half the surface area: only ratios of areas matter
+        float HalfArea() const
+        {
+            const glm::vec3 size = high - low;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+    };
+
+    inline glm::vec3 UObjectCenter(const BoundingBoxes& boxes, uint32_t object)
+    {
+        return glm::vec3(boxes.centerX[object], boxes.centerY[object], boxes.centerZ[object]);
+    }
+
+    inline Aabb UObjectBox(const BoundingBoxes& boxes, uint32_t object)
+    {
+        const glm::vec3 center = UObjectCenter(boxes, object);
+        const glm::vec3 extent(boxes.extentX[object], boxes.extentY[object], boxes.extentZ[object]);
+        Aabb box;
+        box.low = center - extent;
+        box.high = center + extent;
+        return box;
+    }
+
+    inline Aabb UNodeBox(const BvhNode& node)
+    {
+        Aabb box;
+        box.low = node.boundsMin;
+        box.high = node.boundsMax;
+        return box;
+    }
+
+    // An object while the tree is built: box and center copied out of the structure of arrays,
+    // so partitioning moves them along and every pass over a node's objects reads memory in order
+    struct BuildObject
+    {
+        Aabb box;
+        glm::vec3 center;
+        uint32_t index;
+    };
+
+    // Recomputes a node's bounds from its objects or its two children; returns whether they changed
+    bool URefitNode(Bvh& bvh, const BoundingBoxes& boxes, uint32_t index)
+    {
+        BvhNode& node = bvh.nodes[index];
+        Aabb box;
+        if (node.IsLeaf())
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                box.Grow(UObjectBox(boxes, bvh.objects[i]));
+        }
+        else
+        {
+            box.Grow(UNodeBox(bvh.nodes[index + 1]));
+            box.Grow(UNodeBox(bvh.nodes[node.first]));
+        }
+
+        const bool changed = box.low != node.boundsMin || box.high != node.boundsMax;
+        node.boundsMin = box.low;
+        node.boundsMax = box.high;
+        return changed;
+    }
+
+    // Slot of a center along axis, the same in the binning and the partition
+    inline uint32_t UBin(float center, float low, float scale)
+    {
+        return min(SAH_BINS - 1, (uint32_t)((center - low) * scale));
+    }
+
+    // Bounds and center bounds of the objects in [begin, end)
+    void UMeasureObjects(const vector<BuildObject>& objects, uint32_t begin, uint32_t end, Aabb& bounds, Aabb& centers)
+    {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            bounds.Grow(objects[i].box);
+            centers.Grow(objects[i].center);
+        }
+    }
+
+    // Splits the objects in [begin, end) at the cheapest binned plane and returns where the second half starts,
+    // or begin when the node should stay a leaf. One pass bins all three axes and one partitions, measuring
+    // the two halves' bounds on the way, so no node ever walks its objects a third time.
+    uint32_t UPartitionObjects(vector<BuildObject>& objects, uint32_t begin, uint32_t end, const Aabb& bounds, const Aabb& centers,
+        Aabb childBounds[2], Aabb childCenters[2])
+    {
+        const uint32_t count = end - begin;
+        if (count <= 1)
+            return begin;
+
+        glm::vec3 scale;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float extent = centers.high[axis] - centers.low[axis];
+            scale[axis] = extent > 0.0f ? SAH_BINS / extent : 0.0f;
+        }
+
+        Aabb bins[3][SAH_BINS];
+        uint32_t binCounts[3][SAH_BINS] = {};
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const uint32_t bin = UBin(objects[i].center[axis], centers.low[axis], scale[axis]);
+                binCounts[axis][bin]++;
+                bins[axis][bin].Grow(objects[i].box);
+            }
+        }
+
+        float bestCost = numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (scale[axis] == 0.0f)
+                continue;
+
+            // Cost of everything right of each plane, then sweep from the left
+            float rightCosts[SAH_BINS] = {};
+            Aabb side;
+            uint32_t sideCount = 0;
+            for (uint32_t bin = SAH_BINS - 1; bin > 0; --bin)
+            {
+                side.Grow(bins[axis][bin]);
+                sideCount += binCounts[axis][bin];
+                rightCosts[bin] = sideCount > 0 ? side.HalfArea() * sideCount : 0.0f;
+            }
+
+            side = Aabb();
+            sideCount = 0;
+            for (uint32_t bin = 0; bin + 1 < SAH_BINS; ++bin)
+            {
+                side.Grow(bins[axis][bin]);
+                sideCount += binCounts[axis][bin];
+                if (sideCount == 0 || sideCount == count)
+                    continue;
+
+                const float cost = side.HalfArea() * sideCount + rightCosts[bin + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        // Every center in the same place: no plane separates them, so halve the list if it is too long for a leaf
+        if (bestAxis < 0)
+        {
+            if (count <= MAX_LEAF_OBJECTS)
+                return begin;
+            const uint32_t middle = begin + count / 2;
+            UMeasureObjects(objects, begin, middle, childBounds[0], childCenters[0]);
+            UMeasureObjects(objects, middle, end, childBounds[1], childCenters[1]);
+            return middle;
+        }
+
+        const float area = bounds.HalfArea();
+        const float splitCost = area > 0.0f ? TRAVERSAL_COST + bestCost / area : TRAVERSAL_COST;
+        if (count <= MAX_LEAF_OBJECTS && splitCost >= (float)count)
+            return begin;
+
+        // Objects up to bestBin go first; each is looked at once, the ones swapped in from the back included
+        uint32_t i = begin, j = end;
+        while (i < j)
+        {
+            const BuildObject& object = objects[i];
+            if (UBin(object.center[bestAxis], centers.low[bestAxis], scale[bestAxis]) <= bestBin)
+            {
+                childBounds[0].Grow(object.box);
+                childCenters[0].Grow(object.center);
+                ++i;
+            }
+            else
+            {
+                swap(objects[i], objects[--j]);
+                childBounds[1].Grow(objects[j].box);
+                childCenters[1].Grow(objects[j].center);
+            }
+        }
+        return i;
+    }
+
+    // Frustum test of a box against the planes still set in planeMask. Returns false when the box is outside one;
+    // clears the planes it is entirely in front of, so the objects below need not test them again.
+    inline bool UBoxInFrustum(const Frustum& frustum, const glm::vec3& center, const glm::vec3& extent, uint32_t& planeMask)
+    {
+        for (int p = 0; p < 6; ++p)
+        {
+            if (!(planeMask & (1u << p)))
+                continue;
+
+            const glm::vec4& plane = frustum.planes[p];
+            const float distance = plane.x * center.x + (plane.y * center.y + (plane.z * center.z + plane.w));
+            const float radius = fabs(plane.x) * extent.x + (fabs(plane.y) * extent.y + fabs(plane.z) * extent.z);
+            if (distance < -radius)
+                return false;
+            if (distance >= radius)
+                planeMask &= ~(1u << p);
+        }
+        return true;
+    }
+
+    // Distance along the ray at which it enters the box (0 when it starts inside), or false when it misses it
+    // or enters beyond maxDistance
+    inline bool URayBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& low, const glm::vec3& high,
+        float maxDistance, float& entry)
+    {
+        const glm::vec3 t1 = (low - origin) * inverseDirection;
+        const glm::vec3 t2 = (high - origin) * inverseDirection;
+        const glm::vec3 entering = glm::min(t1, t2), leaving = glm::max(t1, t2);
+        const float enter = max(max(entering.x, entering.y), max(entering.z, 0.0f));
+        const float exit = min(min(leaving.x, leaving.y), leaving.z);
+        entry = enter;
+        return enter <= exit && enter < maxDistance;
+    }
+
+    // Squared distance from a point to a box, 0 inside it
+    inline float UDistanceSquared(const glm::vec3& point, const glm::vec3& low, const glm::vec3& high)
+    {
+        const glm::vec3 outside = glm::max(glm::max(low - point, point - high), glm::vec3(0.0f));
+        return glm::dot(outside, outside);
+    }
+}
+
+
+// Top-down build with an explicit stack. Nodes are appended as they are taken off the stack and the first
+// child is always taken next, which lays the tree out depth first; the second child patches its index into the parent.
+void UBuildBvh(Bvh& bvh, const BoundingBoxes& boxes)
+{
+    const uint32_t objectCount = (uint32_t)boxes.Size();
+    bvh.nodes.clear();
+    bvh.parents.clear();
+    bvh.objects.resize(objectCount);
+    bvh.objectLeaves.assign(objectCount, BVH_NO_OBJECT);
+    if (objectCount == 0)
+        return;
+
+    vector<BuildObject> objects(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i)
+        objects[i] = { UObjectBox(boxes, i), UObjectCenter(boxes, i), i };
+
+    bvh.nodes.reserve(2 * objectCount);
+    bvh.parents.reserve(2 * objectCount);
+
+    struct BuildTask
+    {
+        uint32_t begin, end;
+        uint32_t parent;
+        bool secondChild;
+        Aabb bounds, centers;
+    };
+    vector<BuildTask> stack;
+    stack.push_back({ 0, objectCount, BVH_NO_OBJECT, false });
+    UMeasureObjects(objects, 0, objectCount, stack.back().bounds, stack.back().centers);
+    while (!stack.empty())
+    {
+        const BuildTask task = stack.back();
+        stack.pop_back();
+
+        const uint32_t index = (uint32_t)bvh.nodes.size();
+        bvh.nodes.push_back(BvhNode());
+        bvh.parents.push_back(task.parent);
+        if (task.secondChild)
+            bvh.nodes[task.parent].first = index;
+
+        bvh.nodes[index].boundsMin = task.bounds.low;
+        bvh.nodes[index].boundsMax = task.bounds.high;
+
+        Aabb childBounds[2], childCenters[2];
+        const uint32_t middle = UPartitionObjects(objects, task.begin, task.end, task.bounds, task.centers, childBounds, childCenters);
+        if (middle == task.begin)
+        {
+            bvh.nodes[index].first = task.begin;
+            bvh.nodes[index].count = task.end - task.begin;
+            for (uint32_t i = task.begin; i < task.end; ++i)
+            {
+                bvh.objects[i] = objects[i].index;
+                bvh.objectLeaves[objects[i].index] = index;
+            }
+            continue;
+        }
+
+        bvh.nodes[index].count = 0;
+        stack.push_back({ middle, task.end, index, true, childBounds[1], childCenters[1] });
+        stack.push_back({ task.begin, middle, index, false, childBounds[0], childCenters[0] });
+    }
+}
+
+
+// Children come after their parent, so one backwards pass sees every child before its parent
+void URefitBvh(Bvh& bvh, const BoundingBoxes& boxes)
+{
+    for (size_t index = bvh.nodes.size(); index-- > 0;)
+        URefitNode(bvh, boxes, (uint32_t)index);
+}
+
+
+// Walks from each changed object's leaf towards the root, stopping at the first node whose bounds did not change:
+// the ones above it cannot have changed either. A large share of moved objects is cheaper with the full pass.
+void URefitBvh(Bvh& bvh, const BoundingBoxes& boxes, const std::vector<uint32_t>& changedObjects)
+{
+    if (changedObjects.size() * 4 >= bvh.objects.size())
+    {
+        URefitBvh(bvh, boxes);
+        return;
+    }
+
+    for (uint32_t object : changedObjects)
+    {
+        uint32_t index = bvh.objectLeaves[object];
+        while (index != BVH_NO_OBJECT && URefitNode(bvh, boxes, index))
+            index = bvh.parents[index];
+    }
+}
+
+
+// Expected cost of a query relative to the root's area: TRAVERSAL_COST per inner node and one per leaf object,
+// each weighted by the node's area. Refitting moved objects only grows boxes, so this rises until the next rebuild.
+float UBvhCost(const Bvh& bvh)
+{
+    if (bvh.nodes.empty())
+        return 0.0f;
+
+    const float rootArea = UNodeBox(bvh.nodes[0]).HalfArea();
+    if (rootArea <= 0.0f)
+        return 0.0f;
+
+    float cost = 0.0f;
+    for (const BvhNode& node : bvh.nodes)
+        cost += UNodeBox(node).HalfArea() * (node.IsLeaf() ? (float)node.count : TRAVERSAL_COST);
+    return cost / rootArea;
+}
+
+
+// Skips every subtree whose box is outside a plane. Planes a node is entirely in front of are dropped for its
+// subtree, so once a node is inside all six its objects are accepted without any test. The objects of leaves that
+// straddle a plane are gathered and tested afterwards with UCullBoxes, SIMD_WIDTH boxes at a time.
+size_t UCullBvh(const Bvh& bvh, const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible)
+{
+    fill(visible, visible + boxes.Size(), (uint8_t)0);
+    if (bvh.nodes.empty())
+        return 0;
+
+    struct CullEntry
+    {
+        uint32_t node;
+        uint32_t planeMask;
+    };
+    vector<CullEntry> stack;
+    stack.push_back({ 0, 0x3F });
+
+    // Objects of the leaves still crossing a plane, in leaf order
+    vector<uint32_t> candidates;
+
+    size_t visibleCount = 0;
+    while (!stack.empty())
+    {
+        const CullEntry entry = stack.back();
+        stack.pop_back();
+
+        const BvhNode& node = bvh.nodes[entry.node];
+        uint32_t planeMask = entry.planeMask;
+        if (planeMask != 0 && !UBoxInFrustum(frustum, (node.boundsMin + node.boundsMax) * 0.5f, (node.boundsMax - node.boundsMin) * 0.5f, planeMask))
+            continue;
+
+        if (!node.IsLeaf())
+        {
+            stack.push_back({ node.first, planeMask });
+            stack.push_back({ entry.node + 1, planeMask });
+            continue;
+        }
+
+        if (planeMask != 0)
+        {
+            candidates.insert(candidates.end(), bvh.objects.begin() + node.first, bvh.objects.begin() + node.first + node.count);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            visible[bvh.objects[i]] = 1;
+        visibleCount += node.count;
+    }
+
+    // Gathered into their own structure of arrays, the candidates go through the batched test
+    BoundingBoxes candidateBoxes;
+    candidateBoxes.Resize(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const uint32_t object = candidates[i];
+        candidateBoxes.Set(i, UObjectCenter(boxes, object), glm::vec3(boxes.extentX[object], boxes.extentY[object], boxes.extentZ[object]));
+    }
+    vector<uint8_t> candidateVisible(candidates.size());
+    visibleCount += UCullBoxes(frustum, candidateBoxes, candidateVisible.data());
+    for (size_t i = 0; i < candidates.size(); ++i)
+        visible[candidates[i]] = candidateVisible[i];
+    return visibleCount;
+}
+
+
+// Front to back: the nearer child is visited first and subtrees entered beyond the closest hit so far are skipped.
+// Hits are on the objects' boxes; distance is in units of direction's length.
+uint32_t URaycastBvh(const Bvh& bvh, const BoundingBoxes& boxes, const glm::vec3& origin, const glm::vec3& direction, float& distance)
+{
+    uint32_t hit = BVH_NO_OBJECT;
+    distance = numeric_limits<float>::max();
+    const glm::vec3 inverseDirection = glm::vec3(1.0f) / direction;
+    float entry;
+    if (bvh.nodes.empty() || !URayBox(origin, inverseDirection, bvh.nodes[0].boundsMin, bvh.nodes[0].boundsMax, distance, entry))
+        return hit;
+
+    struct RayEntry
+    {
+        uint32_t node;
+        float distance;
+    };
+    vector<RayEntry> stack;
+    stack.push_back({ 0, entry });
+    while (!stack.empty())
+    {
+        const RayEntry current = stack.back();
+        stack.pop_back();
+        if (current.distance >= distance)
+            continue;
+
+        const BvhNode& node = bvh.nodes[current.node];
+        if (node.IsLeaf())
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const Aabb box = UObjectBox(boxes, bvh.objects[i]);
+                if (URayBox(origin, inverseDirection, box.low, box.high, distance, entry))
+                {
+                    distance = entry;
+                    hit = bvh.objects[i];
+                }
+            }
+            continue;
+        }
+
+        const uint32_t first = current.node + 1, second = node.first;
+        float firstEntry, secondEntry;
+        const bool firstHit = URayBox(origin, inverseDirection, bvh.nodes[first].boundsMin, bvh.nodes[first].boundsMax, distance, firstEntry);
+        const bool secondHit = URayBox(origin, inverseDirection, bvh.nodes[second].boundsMin, bvh.nodes[second].boundsMax, distance, secondEntry);
+        if (firstHit && secondHit)
+        {
+            // Push the farther one first so the nearer one is popped next
+            if (firstEntry <= secondEntry)
+            {
+                stack.push_back({ second, secondEntry });
+                stack.push_back({ first, firstEntry });
+            }
+            else
+            {
+                stack.push_back({ first, firstEntry });
+                stack.push_back({ second, secondEntry });
+            }
+        }
+        else if (firstHit)
+            stack.push_back({ first, firstEntry });
+        else if (secondHit)
+            stack.push_back({ second, secondEntry });
+    }
+    return hit;
+}
+
+
+// Appends the objects whose box is within radius of center, e.g. the ones a point light reaches
+void UQueryBvhSphere(const Bvh& bvh, const BoundingBoxes& boxes, const glm::vec3& center, float radius, std::vector<uint32_t>& objects)
+{
+    if (bvh.nodes.empty())
+        return;
+
+    const float radiusSquared = radius * radius;
+    vector<uint32_t> stack;
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const BvhNode& node = bvh.nodes[index];
+        if (UDistanceSquared(center, node.boundsMin, node.boundsMax) > radiusSquared)
+            continue;
+
+        if (!node.IsLeaf())
+        {
+            stack.push_back(node.first);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+            const Aabb box = UObjectBox(boxes, bvh.objects[i]);
+            if (UDistanceSquared(center, box.low, box.high) <= radiusSquared)
+                objects.push_back(bvh.objects[i]);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "frustum.h"        // Frustum planes and world bounding boxes
+
+// Returned by the queries when nothing was hit
+const uint32_t BVH_NO_OBJECT = 0xFFFFFFFFu;
+
+// One node of the flattened hierarchy, 32 bytes so two share a cache line.
+// Nodes are stored depth first: an inner node's first child is the next node, so only the second one needs an index.
+struct BvhNode
+{
+    glm::vec3 boundsMin;
+    uint32_t first;         // leaf: first entry in Bvh::objects; inner node: index of the second child
+    glm::vec3 boundsMax;
+    uint32_t count;         // leaf: number of objects; 0 for inner nodes
+
+    bool IsLeaf() const { return count > 0; }
+};
+
+// Bounding volume hierarchy over a set of world-space boxes (BoundingBoxes), built with the surface area heuristic.
+// The objects of every leaf, and of every subtree, are contiguous in objects.
+struct Bvh
+{
+    std::vector<BvhNode> nodes;
+    std::vector<uint32_t> objects;          // object indices in leaf order
+    std::vector<uint32_t> parents;          // parent of every node, BVH_NO_OBJECT for the root
+    std::vector<uint32_t> objectLeaves;     // leaf holding every object, so a moved object can refit upwards from it
+
+    bool Empty() const { return nodes.empty(); }
+};
+
+/* Bounding volume hierarchy function prototypes to:
+ * build the hierarchy over boxes (binned SAH, a few objects per leaf),
+ * refit the node bounds to moved boxes, all of them or only the ancestors of the changed objects,
+ * compute the SAH cost of the tree (how much refits have degraded it compared to a rebuild),
+ * mark the objects whose box intersects a frustum (1 visible, 0 culled) and return how many are visible,
+ * find the nearest box a ray enters, and list the objects whose box intersects a sphere
+ */
+void UBuildBvh(Bvh& bvh, const BoundingBoxes& boxes);
+void URefitBvh(Bvh& bvh, const BoundingBoxes& boxes);
+void URefitBvh(Bvh& bvh, const BoundingBoxes& boxes, const std::vector<uint32_t>& changedObjects);
+float UBvhCost(const Bvh& bvh);
+size_t UCullBvh(const Bvh& bvh, const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible);
+uint32_t URaycastBvh(const Bvh& bvh, const BoundingBoxes& boxes, const glm::vec3& origin, const glm::vec3& direction, float& distance);
+void UQueryBvhSphere(const Bvh& bvh, const BoundingBoxes& boxes, const glm::vec3& center, float radius, std::vector<uint32_t>& objects);
+
+#endif
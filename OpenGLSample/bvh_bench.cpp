@@ -0,0 +1,219 @@
+#include <iostream>         // cout, cerr
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp
+#include <cmath>            // fabs
+#include <chrono>           // steady_clock
+#include <random>           // mt19937
+#include <algorithm>        // min, max
+#include <limits>           // numeric_limits
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bvh.h"            // Bounding volume hierarchy
+#include "frustum.h"        // Flat culling to compare against
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Object counts measured, queries per run, and how often each timing repeats (the fastest run is reported;
+    // the brute force queries run once)
+    const size_t OBJECT_COUNTS[] = { 10000, 100000, 1000000 };
+    const int QUERY_COUNT = 1000;
+    int gRepeats = 5;
+
+    // Objects are scattered in a cube of this half size; the camera at its center sees roughly a tenth of it
+    const float WORLD_HALF_SIZE = 100.0f;
+
+    // Share of the objects moved before the incremental refit, how far they move, and the light radius of the sphere queries
+    const float MOVED_FRACTION = 0.01f;
+    const float MOVE_DISTANCE = 1.0f;
+    const float QUERY_RADIUS = 5.0f;
+
+    // Fastest of repeats runs of work, in milliseconds
+    template <typename Work>
+    double UTimeBest(Work work, int repeats = gRepeats)
+    {
+        double best = 1e30;
+        for (int run = 0; run < repeats; ++run)
+        {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            work();
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    inline glm::vec3 UCenter(const BoundingBoxes& boxes, size_t i)
+    {
+        return glm::vec3(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+    }
+
+    inline glm::vec3 UExtent(const BoundingBoxes& boxes, size_t i)
+    {
+        return glm::vec3(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+    }
+
+    // Nearest box entered by the ray, testing every box
+    float URaycastAll(const BoundingBoxes& boxes, const glm::vec3& origin, const glm::vec3& direction)
+    {
+        const glm::vec3 inverseDirection = glm::vec3(1.0f) / direction;
+        float nearest = numeric_limits<float>::max();
+        for (size_t i = 0; i < boxes.Size(); ++i)
+        {
+            const glm::vec3 t1 = (UCenter(boxes, i) - UExtent(boxes, i) - origin) * inverseDirection;
+            const glm::vec3 t2 = (UCenter(boxes, i) + UExtent(boxes, i) - origin) * inverseDirection;
+            const glm::vec3 entering = glm::min(t1, t2), leaving = glm::max(t1, t2);
+            const float enter = max(max(entering.x, entering.y), max(entering.z, 0.0f));
+            const float exit = min(min(leaving.x, leaving.y), leaving.z);
+            if (enter <= exit && enter < nearest)
+                nearest = enter;
+        }
+        return nearest;
+    }
+
+    // Number of boxes within radius of center, testing every box
+    size_t UQuerySphereAll(const BoundingBoxes& boxes, const glm::vec3& center, float radius)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < boxes.Size(); ++i)
+        {
+            const glm::vec3 outside = glm::max(glm::abs(UCenter(boxes, i) - center) - UExtent(boxes, i), glm::vec3(0.0f));
+            count += glm::dot(outside, outside) <= radius * radius;
+        }
+        return count;
+    }
+}
+
+
+// Builds the hierarchy over random boxes and compares frustum culling, ray casts and sphere queries through it
+// against testing every box, then measures refitting after some objects moved. Reports times, the SAH cost
+// and how many results disagree with the brute force ones (should be 0) as JSON.
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+            gRepeats = max(1, atoi(argv[++i]));
+        else
+        {
+            cerr << "usage: bvh_bench [--repeats N]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The viewer's camera: 45 degree field of view, looking down -z from the origin
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, WORLD_HALF_SIZE);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = UExtractFrustum(projection * view);
+
+    cout << "{\n";
+    cout << "  \"repeats\": " << gRepeats << ",\n";
+    cout << "  \"queries\": " << QUERY_COUNT << ",\n";
+    cout << "  \"results\": [\n";
+    const size_t countCount = sizeof(OBJECT_COUNTS) / sizeof(OBJECT_COUNTS[0]);
+    for (size_t c = 0; c < countCount; ++c)
+    {
+        const size_t count = OBJECT_COUNTS[c];
+        mt19937 random(1);
+        uniform_real_distribution<float> position(-WORLD_HALF_SIZE, WORLD_HALF_SIZE);
+        uniform_real_distribution<float> size(0.1f, 2.0f);
+        uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        BoundingBoxes boxes;
+        boxes.Resize(count);
+        for (size_t i = 0; i < count; ++i)
+            boxes.Set(i, glm::vec3(position(random), position(random), position(random)), glm::vec3(size(random), size(random), size(random)));
+
+        // Build
+        Bvh bvh;
+        const double buildMs = UTimeBest([&] { UBuildBvh(bvh, boxes); });
+        const float builtCost = UBvhCost(bvh);
+
+        // Frustum culling against the flat SIMD loop
+        vector<uint8_t> flatVisible(count), bvhVisible(count);
+        size_t visible = 0;
+        const double flatCullMs = UTimeBest([&] { UCullBoxes(frustum, boxes, flatVisible.data()); });
+        const double bvhCullMs = UTimeBest([&] { visible = UCullBvh(bvh, frustum, boxes, bvhVisible.data()); });
+        size_t cullMismatches = 0;
+        for (size_t i = 0; i < count; ++i)
+            cullMismatches += flatVisible[i] != bvhVisible[i];
+
+        // Rays from random points in random directions: nearest hit distance
+        vector<glm::vec3> origins(QUERY_COUNT), directions(QUERY_COUNT);
+        for (int q = 0; q < QUERY_COUNT; ++q)
+        {
+            origins[q] = glm::vec3(position(random), position(random), position(random));
+            directions[q] = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+        }
+        vector<float> bvhDistances(QUERY_COUNT), allDistances(QUERY_COUNT);
+        const double bvhRayMs = UTimeBest([&]
+            {
+                for (int q = 0; q < QUERY_COUNT; ++q)
+                    URaycastBvh(bvh, boxes, origins[q], directions[q], bvhDistances[q]);
+            });
+        const double allRayMs = UTimeBest([&]
+            {
+                for (int q = 0; q < QUERY_COUNT; ++q)
+                    allDistances[q] = URaycastAll(boxes, origins[q], directions[q]);
+            }, 1);
+        size_t rayMismatches = 0;
+        for (int q = 0; q < QUERY_COUNT; ++q)
+            rayMismatches += fabs(bvhDistances[q] - allDistances[q]) > 1e-4f * max(1.0f, allDistances[q]);
+
+        // Light-sized spheres around the ray origins: objects reached
+        vector<uint32_t> found;
+        size_t bvhFound = 0, allFound = 0;
+        const double bvhSphereMs = UTimeBest([&]
+            {
+                bvhFound = 0;
+                for (int q = 0; q < QUERY_COUNT; ++q)
+                {
+                    found.clear();
+                    UQueryBvhSphere(bvh, boxes, origins[q], QUERY_RADIUS, found);
+                    bvhFound += found.size();
+                }
+            });
+        const double allSphereMs = UTimeBest([&]
+            {
+                allFound = 0;
+                for (int q = 0; q < QUERY_COUNT; ++q)
+                    allFound += UQuerySphereAll(boxes, origins[q], QUERY_RADIUS);
+            }, 1);
+
+        // Move a few objects and refit only their ancestors, then refit everything
+        vector<uint32_t> moved((size_t)(count * MOVED_FRACTION));
+        uniform_int_distribution<uint32_t> pick(0, (uint32_t)count - 1);
+        for (uint32_t& object : moved)
+        {
+            object = pick(random);
+            boxes.Set(object, UCenter(boxes, object) + MOVE_DISTANCE * glm::vec3(unit(random), unit(random), unit(random)), UExtent(boxes, object));
+        }
+        const double incrementalRefitMs = UTimeBest([&] { URefitBvh(bvh, boxes, moved); }, 1);     // a second run would find nothing to do
+        const double fullRefitMs = UTimeBest([&] { URefitBvh(bvh, boxes); });
+
+        // Scatter every object again: a refit keeps the old grouping, a rebuild finds a new one
+        for (size_t i = 0; i < count; ++i)
+            boxes.Set(i, glm::vec3(position(random), position(random), position(random)), UExtent(boxes, i));
+        URefitBvh(bvh, boxes);
+        const float refitCost = UBvhCost(bvh);
+        UBuildBvh(bvh, boxes);
+        const float rebuiltCost = UBvhCost(bvh);
+
+        cout << "    { \"objects\": " << count << ", \"nodes\": " << bvh.nodes.size() << ",\n";
+        cout << "      \"build_ms\": " << buildMs << ", \"sah_cost\": " << builtCost << ",\n";
+        cout << "      \"frustum\": { \"visible\": " << visible << ", \"flat_simd_ms\": " << flatCullMs << ", \"bvh_ms\": " << bvhCullMs
+             << ", \"mismatches\": " << cullMismatches << " },\n";
+        cout << "      \"rays\": { \"all_ms\": " << allRayMs << ", \"bvh_ms\": " << bvhRayMs << ", \"mismatches\": " << rayMismatches << " },\n";
+        cout << "      \"spheres\": { \"found\": " << bvhFound << ", \"all_ms\": " << allSphereMs << ", \"bvh_ms\": " << bvhSphereMs
+             << ", \"mismatches\": " << (bvhFound > allFound ? bvhFound - allFound : allFound - bvhFound) << " },\n";
+        cout << "      \"refit\": { \"moved\": " << moved.size() << ", \"incremental_ms\": " << incrementalRefitMs << ", \"full_ms\": " << fullRefitMs
+             << ", \"scattered_refit_cost\": " << refitCost << ", \"scattered_rebuilt_cost\": " << rebuiltCost << " } }"
+             << (c + 1 < countCount ? ",\n" : "\n");
+    }
+    cout << "  ]\n";
+    cout << "}" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+
+// A camera pose at a point in time
+struct CameraKeyframe
+{
+    float time;          // seconds from the start of the path
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// A camera path made of keyframes, either recorded from the viewer or generated procedurally.
+// Poses between keyframes are linearly interpolated and the path loops once it reaches its end.
+class CameraPath
+{
+public:
+    std::vector<CameraKeyframe> keyframes;
+
+    // loads a path written by Save: one "time x y z yaw pitch" line per keyframe, '#' starts a comment
+    bool Load(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open())
+            return false;
+
+        keyframes.clear();
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            CameraKeyframe key;
+            if (sscanf(line.c_str(), "%f %f %f %f %f %f", &key.time, &key.position.x, &key.position.y, &key.position.z, &key.yaw, &key.pitch) == 6)
+                keyframes.push_back(key);
+        }
+        return !keyframes.empty();
+    }
+
+    // writes the keyframes in the format Load reads
+    bool Save(const std::string& filename) const
+    {
+        std::ofstream file(filename);
+        if (!file.is_open())
+            return false;
+
+        file << "# time x y z yaw pitch\n";
+        for (const CameraKeyframe& key : keyframes)
+            file << key.time << " " << key.position.x << " " << key.position.y << " " << key.position.z << " " << key.yaw << " " << key.pitch << "\n";
+        return true;
+    }
+
+    // appends the camera's current pose
+    void Record(const Camera& camera, float time)
+    {
+        keyframes.push_back({ time, camera.Position, camera.Yaw, camera.Pitch });
+    }
+
+    // generates a circle around center at the given radius and height, always looking at center
+    static CameraPath Orbit(glm::vec3 center, float radius, float height, float duration, int steps = 64)
+    {
+        CameraPath path;
+        for (int i = 0; i <= steps; ++i)
+        {
+            float t = (float)i / steps;
+            float angle = glm::radians(360.0f * t);
+            glm::vec3 position = center + glm::vec3(radius * cos(angle), height, radius * sin(angle));
+            glm::vec3 toCenter = glm::normalize(center - position);
+
+            CameraKeyframe key;
+            key.time = t * duration;
+            key.position = position;
+            key.yaw = glm::degrees(atan2(toCenter.z, toCenter.x));
+            key.pitch = glm::degrees(asin(toCenter.y));
+            // keep yaw continuous so interpolation never spins the long way around
+            if (!path.keyframes.empty())
+            {
+                float previousYaw = path.keyframes.back().yaw;
+                while (key.yaw - previousYaw > 180.0f) key.yaw -= 360.0f;
+                while (key.yaw - previousYaw < -180.0f) key.yaw += 360.0f;
+            }
+            path.keyframes.push_back(key);
+        }
+        return path;
+    }
+
+    // length of the path in seconds
+    float Duration() const
+    {
+        return keyframes.empty() ? 0.0f : keyframes.back().time;
+    }
+
+    // interpolated pose at the given time
+    CameraKeyframe Sample(float time) const
+    {
+        if (keyframes.size() == 1 || Duration() <= 0.0f)
+            return keyframes.front();
+
+        time = fmod(time, Duration());
+        size_t next = 1;
+        while (next < keyframes.size() - 1 && keyframes[next].time < time)
+            ++next;
+
+        const CameraKeyframe& a = keyframes[next - 1];
+        const CameraKeyframe& b = keyframes[next];
+        float span = b.time - a.time;
+        float t = span > 0.0f ? glm::clamp((time - a.time) / span, 0.0f, 1.0f) : 0.0f;
+
+        CameraKeyframe key;
+        key.time = time;
+        key.position = glm::mix(a.position, b.position, t);
+        key.yaw = glm::mix(a.yaw, b.yaw, t);
+        key.pitch = glm::mix(a.pitch, b.pitch, t);
+        return key;
+    }
+
+    // moves the camera to the pose at the given time
+    void Apply(Camera& camera, float time) const
+    {
+        CameraKeyframe key = Sample(time);
+        camera.SetPose(key.position, key.yaw, key.pitch);
+    }
+};
+#endif
@@ -0,0 +1,113 @@
+#include <iostream>         // cout, cerr
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp
+#include <chrono>           // steady_clock
+#include <random>           // mt19937
+#include <algorithm>        // min
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustum.h"        // Frustum extraction and culling
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Object counts measured, and how often each test runs (the fastest run is reported)
+    const size_t OBJECT_COUNTS[] = { 10000, 100000, 1000000 };
+    int gRepeats = 20;
+
+    // Objects are scattered in a cube of this half size around the camera, which sees roughly a tenth of it
+    const float WORLD_HALF_SIZE = 100.0f;
+
+    // Fastest of gRepeats runs of cull, in milliseconds
+    template <typename CullFunction>
+    double UTimeBest(CullFunction cull)
+    {
+        double best = 1e30;
+        for (int run = 0; run < gRepeats; ++run)
+        {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            cull();
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    // Objects the two results disagree on
+    size_t UCountMismatches(const vector<uint8_t>& a, const vector<uint8_t>& b)
+    {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+            mismatches += a[i] != b[i];
+        return mismatches;
+    }
+}
+
+
+// Culls random spheres and boxes with the scalar and the SIMD tests and reports both times,
+// the visible counts and how many objects the two disagree on (should be 0) as JSON
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+            gRepeats = max(1, atoi(argv[++i]));
+        else
+        {
+            cerr << "usage: culling_bench [--repeats N]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The viewer's camera: 45 degree field of view, looking down -z from the origin
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, WORLD_HALF_SIZE);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = UExtractFrustum(projection * view);
+
+    cout << "{\n";
+    cout << "  \"instruction_set\": \"" << UCullingInstructionSet() << "\",\n";
+    cout << "  \"repeats\": " << gRepeats << ",\n";
+    cout << "  \"results\": [\n";
+    const size_t countCount = sizeof(OBJECT_COUNTS) / sizeof(OBJECT_COUNTS[0]);
+    for (size_t c = 0; c < countCount; ++c)
+    {
+        const size_t count = OBJECT_COUNTS[c];
+        mt19937 random(1);
+        uniform_real_distribution<float> position(-WORLD_HALF_SIZE, WORLD_HALF_SIZE);
+        uniform_real_distribution<float> size(0.1f, 2.0f);
+
+        BoundingSpheres spheres;
+        BoundingBoxes boxes;
+        spheres.Resize(count);
+        boxes.Resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const glm::vec3 center(position(random), position(random), position(random));
+            const glm::vec3 extent(size(random), size(random), size(random));
+            spheres.Set(i, center, glm::length(extent));
+            boxes.Set(i, center, extent);
+        }
+
+        vector<uint8_t> scalarVisible(count), simdVisible(count);
+        size_t sphereVisible = 0, boxVisible = 0;
+        const double sphereScalar = UTimeBest([&] { UCullSpheresScalar(frustum, spheres, scalarVisible.data()); });
+        const double sphereSimd = UTimeBest([&] { sphereVisible = UCullSpheres(frustum, spheres, simdVisible.data()); });
+        const size_t sphereMismatches = UCountMismatches(scalarVisible, simdVisible);
+        const double boxScalar = UTimeBest([&] { UCullBoxesScalar(frustum, boxes, scalarVisible.data()); });
+        const double boxSimd = UTimeBest([&] { boxVisible = UCullBoxes(frustum, boxes, simdVisible.data()); });
+        const size_t boxMismatches = UCountMismatches(scalarVisible, simdVisible);
+
+        cout << "    { \"objects\": " << count << ",\n";
+        cout << "      \"spheres\": { \"visible\": " << sphereVisible << ", \"scalar_ms\": " << sphereScalar
+             << ", \"simd_ms\": " << sphereSimd << ", \"mismatches\": " << sphereMismatches << " },\n";
+        cout << "      \"boxes\": { \"visible\": " << boxVisible << ", \"scalar_ms\": " << boxScalar
+             << ", \"simd_ms\": " << boxSimd << ", \"mismatches\": " << boxMismatches << " } }"
+             << (c + 1 < countCount ? ",\n" : "\n");
+    }
+    cout << "  ]\n";
+    cout << "}" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+#include <cmath>            // fabs
+
+#include "frustum.h"
+#include "simd.h"           // SSE or AVX wrappers
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    const int FRUSTUM_PLANES = 6;
+
+    // Spheres first to count, testing one at a time: outside as soon as the center is farther than the radius behind a plane
+    size_t UCullSpheresFrom(const Frustum& frustum, const BoundingSpheres& spheres, size_t first, uint8_t* visible)
+    {
+        size_t visibleCount = 0;
+        for (size_t i = first; i < spheres.Size(); ++i)
+        {
+            bool inside = true;
+            for (int p = 0; p < FRUSTUM_PLANES && inside; ++p)
+            {
+                const glm::vec4& plane = frustum.planes[p];
+                inside = plane.x * spheres.x[i] + (plane.y * spheres.y[i] + (plane.z * spheres.z[i] + plane.w)) >= -spheres.radius[i];
+            }
+            visible[i] = inside ? 1 : 0;
+            visibleCount += visible[i];
+        }
+        return visibleCount;
+    }
+
+    // Boxes first to count: outside when even the corner farthest along the plane normal is behind it,
+    // i.e. the center is behind by more than the extent projected onto the normal
+    size_t UCullBoxesFrom(const Frustum& frustum, const BoundingBoxes& boxes, size_t first, uint8_t* visible)
+    {
+        size_t visibleCount = 0;
+        for (size_t i = first; i < boxes.Size(); ++i)
+        {
+            bool inside = true;
+            for (int p = 0; p < FRUSTUM_PLANES && inside; ++p)
+            {
+                const glm::vec4& plane = frustum.planes[p];
+                const float distance = plane.x * boxes.centerX[i] + (plane.y * boxes.centerY[i] + (plane.z * boxes.centerZ[i] + plane.w));
+                const float extent = fabs(plane.x) * boxes.extentX[i] + (fabs(plane.y) * boxes.extentY[i] + fabs(plane.z) * boxes.extentZ[i]);
+                inside = distance >= -extent;
+            }
+            visible[i] = inside ? 1 : 0;
+            visibleCount += visible[i];
+        }
+        return visibleCount;
+    }
+
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+    // Writes the lanes of a comparison mask as one byte per object and returns how many were set
+    inline size_t UStoreMask(int mask, uint8_t* visible)
+    {
+        size_t count = 0;
+        for (size_t lane = 0; lane < SIMD_WIDTH; ++lane)
+        {
+            visible[lane] = (uint8_t)((mask >> lane) & 1);
+            count += visible[lane];
+        }
+        return count;
+    }
+#endif
+}
+
+
+// Each plane is a sum or difference of the matrix's last row and one of the others (GL clip space: -w <= x, y, z <= w),
+// normalized so plane distances are in world units
+Frustum UExtractFrustum(const glm::mat4& viewProjection)
+{
+    // glm is column-major: row r is (m[0][r], m[1][r], m[2][r], m[3][r])
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r)
+        rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[3] + rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+
+    for (glm::vec4& plane : frustum.planes)
+    {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+    }
+    return frustum;
+}
+
+
+// The same test as the scalar version on SIMD_WIDTH spheres per step, without early out: all six planes
+// are cheaper than a branch per lane. The objects past the last full step go through the scalar loop.
+size_t UCullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, uint8_t* visible)
+{
+    size_t i = 0, visibleCount = 0;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+    SimdFloat planes[FRUSTUM_PLANES][4];
+    for (int p = 0; p < FRUSTUM_PLANES; ++p)
+        for (int c = 0; c < 4; ++c)
+            planes[p][c] = USimdSplat(frustum.planes[p][c]);
+
+    const size_t count = spheres.Size();
+    for (; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+    {
+        const SimdFloat x = USimdLoad(&spheres.x[i]);
+        const SimdFloat y = USimdLoad(&spheres.y[i]);
+        const SimdFloat z = USimdLoad(&spheres.z[i]);
+        const SimdFloat negativeRadius = USimdNegate(USimdLoad(&spheres.radius[i]));
+
+        SimdFloat inside = USimdTrue();
+        for (int p = 0; p < FRUSTUM_PLANES; ++p)
+        {
+            const SimdFloat distance = USimdMulAdd(planes[p][0], x, USimdMulAdd(planes[p][1], y, USimdMulAdd(planes[p][2], z, planes[p][3])));
+            inside = USimdAnd(inside, USimdGreaterEqual(distance, negativeRadius));
+        }
+        visibleCount += UStoreMask(USimdMask(inside), &visible[i]);
+    }
+#endif
+    return visibleCount + UCullSpheresFrom(frustum, spheres, i, visible);
+}
+
+
+// One sphere at a time, for reference and for comparing against the SIMD version
+size_t UCullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint8_t* visible)
+{
+    return UCullSpheresFrom(frustum, spheres, 0, visible);
+}
+
+
+// SIMD_WIDTH boxes per step; the plane normals' absolute values project the extents
+size_t UCullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible)
+{
+    size_t i = 0, visibleCount = 0;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+    SimdFloat planes[FRUSTUM_PLANES][4], absolutePlanes[FRUSTUM_PLANES][3];
+    for (int p = 0; p < FRUSTUM_PLANES; ++p)
+    {
+        for (int c = 0; c < 4; ++c)
+            planes[p][c] = USimdSplat(frustum.planes[p][c]);
+        for (int c = 0; c < 3; ++c)
+            absolutePlanes[p][c] = USimdSplat(fabs(frustum.planes[p][c]));
+    }
+
+    const size_t count = boxes.Size();
+    for (; i + SIMD_WIDTH <= count; i += SIMD_WIDTH)
+    {
+        const SimdFloat x = USimdLoad(&boxes.centerX[i]);
+        const SimdFloat y = USimdLoad(&boxes.centerY[i]);
+        const SimdFloat z = USimdLoad(&boxes.centerZ[i]);
+        const SimdFloat ex = USimdLoad(&boxes.extentX[i]);
+        const SimdFloat ey = USimdLoad(&boxes.extentY[i]);
+        const SimdFloat ez = USimdLoad(&boxes.extentZ[i]);
+
+        SimdFloat inside = USimdTrue();
+        for (int p = 0; p < FRUSTUM_PLANES; ++p)
+        {
+            const SimdFloat distance = USimdMulAdd(planes[p][0], x, USimdMulAdd(planes[p][1], y, USimdMulAdd(planes[p][2], z, planes[p][3])));
+            const SimdFloat extent = USimdMulAdd(absolutePlanes[p][0], ex, USimdMulAdd(absolutePlanes[p][1], ey, USimdMul(absolutePlanes[p][2], ez)));
+            inside = USimdAnd(inside, USimdGreaterEqual(distance, USimdNegate(extent)));
+        }
+        visibleCount += UStoreMask(USimdMask(inside), &visible[i]);
+    }
+#endif
+    return visibleCount + UCullBoxesFrom(frustum, boxes, i, visible);
+}
+
+
+// One box at a time
+size_t UCullBoxesScalar(const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible)
+{
+    return UCullBoxesFrom(frustum, boxes, 0, visible);
+}
+
+
+// Instruction set the SIMD versions were compiled for
+const char* UCullingInstructionSet()
+{
+    return USimdInstructionSet();
+}
@@ -0,0 +1,84 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Six planes bounding what a camera sees, as (normal, distance) with the normals pointing inwards:
+// a point p is inside a plane when dot(normal, p) + distance >= 0.
+// Order: left, right, bottom, top, near, far.
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
+// World-space bounding spheres kept in separate arrays (structure of arrays),
+// so the culling loops load the same component of 4 or 8 spheres at once
+struct BoundingSpheres
+{
+    std::vector<float> x, y, z, radius;
+
+    void Resize(size_t count)
+    {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+        radius.resize(count);
+    }
+
+    void Set(size_t index, const glm::vec3& center, float sphereRadius)
+    {
+        x[index] = center.x;
+        y[index] = center.y;
+        z[index] = center.z;
+        radius[index] = sphereRadius;
+    }
+
+    size_t Size() const { return x.size(); }
+};
+
+// World-space axis-aligned boxes as center and half extent, in the same layout
+struct BoundingBoxes
+{
+    std::vector<float> centerX, centerY, centerZ, extentX, extentY, extentZ;
+
+    void Resize(size_t count)
+    {
+        centerX.resize(count);
+        centerY.resize(count);
+        centerZ.resize(count);
+        extentX.resize(count);
+        extentY.resize(count);
+        extentZ.resize(count);
+    }
+
+    void Set(size_t index, const glm::vec3& center, const glm::vec3& extent)
+    {
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        extentX[index] = extent.x;
+        extentY[index] = extent.y;
+        extentZ[index] = extent.z;
+    }
+
+    size_t Size() const { return centerX.size(); }
+};
+
+/* Frustum culling function prototypes to:
+ * extract the planes of projection * view (Gribb and Hartmann),
+ * test every sphere or box against the planes, writing 1 (visible) or 0 (culled) per object and
+ * returning the visible count: 8 objects per step with AVX, 4 with SSE, or one at a time in the scalar versions,
+ * and name the instruction set the SIMD versions were compiled for
+ */
+Frustum UExtractFrustum(const glm::mat4& viewProjection);
+size_t UCullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, uint8_t* visible);
+size_t UCullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, uint8_t* visible);
+size_t UCullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible);
+size_t UCullBoxesScalar(const Frustum& frustum, const BoundingBoxes& boxes, uint8_t* visible);
+const char* UCullingInstructionSet();
+
+#endif
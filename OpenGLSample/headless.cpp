@@ -0,0 +1,134 @@
+#include <iostream>         // cout, cerr
+#include <cstdlib>          // setenv
+#include <chrono>           // steady_clock
+#include <GL/glew.h>        // GLEW library
+
+#ifdef __linux__
+#include <EGL/egl.h>        // Surfaceless EGL context for headless rendering
+#include <EGL/eglext.h>
+#endif
+
+#include "renderer.h"
+#include "headless.h"
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Offscreen render target used in place of a window's default framebuffer
+    GLuint gHeadlessFbo = 0;
+    GLuint gHeadlessRbos[2] = { 0, 0 };  // color and depth renderbuffers
+#ifdef __linux__
+    EGLDisplay gEglDisplay = EGL_NO_DISPLAY;
+    EGLContext gEglContext = EGL_NO_CONTEXT;
+#endif
+}
+
+
+// Creates a surfaceless EGL context on Mesa's software rasterizer and an offscreen framebuffer to render into
+bool UInitializeHeadless()
+{
+#ifdef __linux__
+    // Force Mesa's software driver (llvmpipe) unless the user picked a driver themselves
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+
+    // EGL: open the surfaceless platform, which needs neither a display server nor a GPU
+    // ------------------------------------------------------------------------------------
+    PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (eglGetPlatformDisplayEXT == nullptr)
+    {
+        std::cout << "Failed to find eglGetPlatformDisplayEXT" << std::endl;
+        return false;
+    }
+
+    gEglDisplay = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    EGLint eglMajor, eglMinor;
+    if (gEglDisplay == EGL_NO_DISPLAY || !eglInitialize(gEglDisplay, &eglMajor, &eglMinor))
+    {
+        std::cout << "Failed to initialize surfaceless EGL display" << std::endl;
+        return false;
+    }
+
+    // Same 4.4 core profile the windowed path asks GLFW for
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 4,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    eglBindAPI(EGL_OPENGL_API);
+    gEglContext = eglCreateContext(gEglDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+    if (gEglContext == EGL_NO_CONTEXT || !eglMakeCurrent(gEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, gEglContext))
+    {
+        std::cout << "Failed to create surfaceless EGL context" << std::endl;
+        eglTerminate(gEglDisplay);
+        return false;
+    }
+
+    // GLEW: initialize
+    // ----------------
+    // GLEW builds that target GLX report NO_GLX_DISPLAY under EGL even though the entry points were loaded
+    glewExperimental = GL_TRUE;
+    GLenum GlewInitResult = glewInit();
+
+    if (GLEW_OK != GlewInitResult && GLEW_ERROR_NO_GLX_DISPLAY != GlewInitResult)
+    {
+        std::cerr << glewGetErrorString(GlewInitResult) << std::endl;
+        return false;
+    }
+
+    // Offscreen framebuffer: the default framebuffer does not exist without a surface
+    // -------------------------------------------------------------------------------
+    glGenFramebuffers(1, &gHeadlessFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, gHeadlessFbo);
+
+    glGenRenderbuffers(2, gHeadlessRbos);
+    glBindRenderbuffer(GL_RENDERBUFFER, gHeadlessRbos[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, gHeadlessRbos[0]);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, gHeadlessRbos[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, gHeadlessRbos[1]);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Failed to create headless framebuffer" << std::endl;
+        return false;
+    }
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    // Displays GPU OpenGL version (on stderr so benchmark reports on stdout stay machine-readable)
+    cerr << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << endl;
+    cerr << "INFO: OpenGL Renderer: " << glGetString(GL_RENDERER) << endl;
+
+    return true;
+#else
+    std::cout << "Headless rendering is only supported on Linux (EGL)" << std::endl;
+    return false;
+#endif
+}
+
+
+// Releases the offscreen framebuffer and the EGL context
+void UDestroyHeadless()
+{
+    glDeleteFramebuffers(1, &gHeadlessFbo);
+    glDeleteRenderbuffers(2, gHeadlessRbos);
+
+#ifdef __linux__
+    eglMakeCurrent(gEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(gEglDisplay, gEglContext);
+    eglTerminate(gEglDisplay);
+#endif
+}
+
+
+// Seconds since the first call; GLFW's timer is unavailable when running headless
+float UGetTime()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
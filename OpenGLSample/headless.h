@@ -0,0 +1,12 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/* Headless function prototypes to:
+ * create a surfaceless GL context with an offscreen framebuffer (no display or GPU needed),
+ * release it, and read a monotonic clock that works without GLFW
+ */
+bool UInitializeHeadless();
+void UDestroyHeadless();
+float UGetTime();
+
+#endif
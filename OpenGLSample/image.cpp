@@ -0,0 +1,135 @@
+#include <cstring>          // memcpy
+#include <cmath>            // floor
+#include <algorithm>        // min, max
+#include <vector>
+
+#include "image.h"
+
+using namespace std; // Standard namespace
+
+
+// Images are loaded with Y axis going down, but OpenGL's Y axis goes up. Swaps row j with row height - 1 - j
+// through a small buffer, so every byte is read and written once by memcpy's vector loads and stores.
+void UFlipImageRows(unsigned char* pixels, int width, int height, int channels)
+{
+    const size_t rowBytes = (size_t)width * channels;
+    unsigned char chunk[IMAGE_FLIP_CHUNK];
+    for (int j = 0; j < height / 2; ++j)
+    {
+        unsigned char* top = pixels + (size_t)j * rowBytes;
+        unsigned char* bottom = pixels + (size_t)(height - 1 - j) * rowBytes;
+        for (size_t offset = 0; offset < rowBytes; offset += IMAGE_FLIP_CHUNK)
+        {
+            const size_t bytes = min(IMAGE_FLIP_CHUNK, rowBytes - offset);
+            memcpy(chunk, top + offset, bytes);
+            memcpy(top + offset, bottom + offset, bytes);
+            memcpy(bottom + offset, chunk, bytes);
+        }
+    }
+}
+
+
+// Samples the source at every destination pixel center with bilinear filtering, clamped to the edges.
+// With flipRows the source's last row is read as its first, which flips the image at no extra cost.
+void UResampleLinear(const uint8_t* source, int sourceWidth, int sourceHeight, bool flipRows, uint8_t* destination, int width, int height)
+{
+    // Halving samples exactly between four source pixels, where the filter is their rounded average. The integer
+    // form gives the same bytes as the float one below and the compiler vectorizes it.
+    if (sourceWidth == 2 * width && sourceHeight == 2 * height)
+    {
+        const size_t sourceRowBytes = (size_t)sourceWidth * 4;
+        for (int y = 0; y < height; ++y)
+        {
+            const int sourceY = flipRows ? sourceHeight - 2 - 2 * y : 2 * y;
+            const uint8_t* row0 = source + (size_t)sourceY * sourceRowBytes;
+            const uint8_t* row1 = row0 + sourceRowBytes;
+            uint8_t* pixel = destination + (size_t)y * width * 4;
+            for (int x = 0; x < width * 4; ++x)
+            {
+                const int i = (x >> 2) * 8 + (x & 3);
+                pixel[x] = (uint8_t)((row0[i] + row0[i + 4] + row1[i] + row1[i + 4] + 2) >> 2);
+            }
+        }
+        return;
+    }
+
+    const float scaleX = (float)sourceWidth / width;
+    const float scaleY = (float)sourceHeight / height;
+    for (int y = 0; y < height; ++y)
+    {
+        const float sampleY = (y + 0.5f) * scaleY - 0.5f;
+        const int y0 = (int)floor(sampleY);
+        const float fy = sampleY - y0;
+        int sourceY0 = min(max(y0, 0), sourceHeight - 1);
+        int sourceY1 = min(max(y0 + 1, 0), sourceHeight - 1);
+        if (flipRows)
+        {
+            sourceY0 = sourceHeight - 1 - sourceY0;
+            sourceY1 = sourceHeight - 1 - sourceY1;
+        }
+        const uint8_t* row0 = source + (size_t)sourceY0 * sourceWidth * 4;
+        const uint8_t* row1 = source + (size_t)sourceY1 * sourceWidth * 4;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const float sampleX = (x + 0.5f) * scaleX - 0.5f;
+            const int x0 = (int)floor(sampleX);
+            const float fx = sampleX - x0;
+            const int left = min(max(x0, 0), sourceWidth - 1) * 4;
+            const int right = min(max(x0 + 1, 0), sourceWidth - 1) * 4;
+
+            uint8_t* pixel = destination + ((size_t)y * width + x) * 4;
+            for (int c = 0; c < 4; ++c)
+            {
+                const float top = row0[left + c] + (row0[right + c] - row0[left + c]) * fx;
+                const float bottom = row1[left + c] + (row1[right + c] - row1[left + c]) * fx;
+                pixel[c] = (uint8_t)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+}
+
+
+// Halves the image with linear filtering (as glGenerateMipmap) while both sides stay at least size, then resamples
+// it to size x size with linear filtering (as glBlitFramebuffer), so large photos shrink without aliasing and small
+// ones are interpolated. flipRows applies to the first pass; layer receives size * size RGBA pixels.
+void UResampleToLayer(const uint8_t* source, int width, int height, bool flipRows, int size, uint8_t* layer)
+{
+    vector<uint8_t> level, halved;
+    const uint8_t* current = source;
+    while (width / 2 >= size && height / 2 >= size)
+    {
+        halved.resize((size_t)(width / 2) * (height / 2) * 4);
+        UResampleLinear(current, width, height, flipRows, halved.data(), width / 2, height / 2);
+        level.swap(halved);
+        current = level.data();
+        flipRows = false;
+        width /= 2;
+        height /= 2;
+    }
+    UResampleLinear(current, width, height, flipRows, layer, size, size);
+}
+
+
+// Bytes of a square RGBA image of the given size followed by all its mip levels
+size_t UMipChainBytes(int size)
+{
+    size_t bytes = 0;
+    for (; size >= 1; size /= 2)
+        bytes += (size_t)size * size * 4;
+    return bytes;
+}
+
+
+// Fills the UMipChainBytes(size) bytes at layer with the mip levels of its first size * size pixels, each level
+// right after the previous one and averaged 2x2 from it
+void UGenerateMipChain(uint8_t* layer, int size)
+{
+    uint8_t* source = layer;
+    for (; size > 1; size /= 2)
+    {
+        uint8_t* destination = source + (size_t)size * size * 4;
+        UResampleLinear(source, size, size, false, destination, size / 2, size / 2);
+        source = destination;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Bytes of two rows exchanged per step when flipping: small enough to stay in L1, large enough that
+// memcpy runs at its full SIMD width
+const size_t IMAGE_FLIP_CHUNK = 4096;
+
+/* Image function prototypes to:
+ * flip an image vertically in place, swapping whole rows a chunk at a time instead of one byte at a time,
+ * resample RGBA images with bilinear filtering, optionally reading the source's rows bottom to top,
+ * shrink an RGBA image to a square texture layer the way the GL renderer's blit did,
+ * and build a square RGBA layer's mip chain behind it, down to 1x1
+ */
+void UFlipImageRows(unsigned char* pixels, int width, int height, int channels);
+void UResampleLinear(const uint8_t* source, int sourceWidth, int sourceHeight, bool flipRows, uint8_t* destination, int width, int height);
+void UResampleToLayer(const uint8_t* source, int width, int height, bool flipRows, int size, uint8_t* layer);
+size_t UMipChainBytes(int size);
+void UGenerateMipChain(uint8_t* layer, int size);
+
+#endif
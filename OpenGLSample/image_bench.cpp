@@ -0,0 +1,211 @@
+#include <iostream>         // cout, cerr
+#include <fstream>          // ofstream
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp, memcmp
+#include <chrono>           // steady_clock
+#include <string>
+#include <vector>
+#include <algorithm>        // sort
+
+#include "stb_image.h"      // Image loading Utility functions
+#include "image.h"          // Row flipping
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Timed repetitions of every measurement; the median is reported
+    int gRepeats = 15;
+
+    // Where to write the report (empty: stdout)
+    string gOutputFile;
+
+    // Photo decoded with and without flipping, the largest texture of the desk scene by default
+    string gImageFile = RESOURCE_DIR "/textures/gb5.png";
+
+    // Size of the synthetic images flipped in memory
+    const int FLIP_SIZE = 4096;
+
+    // Median times of one channel count
+    struct FlipRun
+    {
+        int channels;
+        double perByteMs;
+        double rowMs;
+        bool identical;
+    };
+
+    volatile unsigned char gSink;
+}
+
+void UFlipPerByte(unsigned char* image, int width, int height, int channels);
+double UMedianMs(vector<double> samples);
+template <typename Function> double UTimeMs(const Function& function);
+
+
+// Times the vertical flip of 4K images, one byte at a time as the renderer used to and whole rows at a time
+// as it does now, and how much of decoding a real photo either flip costs. Reports JSON.
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+            gRepeats = max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+            gImageFile = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            gOutputFile = argv[++i];
+        else
+        {
+            cerr << "usage: image_bench [--repeats N] [--image file] [--output report.json]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // 4K flips in memory
+    // ------------------
+    vector<FlipRun> runs;
+    for (int channels = 3; channels <= 4; ++channels)
+    {
+        const size_t bytes = (size_t)FLIP_SIZE * FLIP_SIZE * channels;
+        vector<unsigned char> perByte(bytes), rows(bytes);
+        for (size_t i = 0; i < bytes; ++i)
+            perByte[i] = rows[i] = (unsigned char)(i * 2654435761u >> 24);
+
+        FlipRun run = {};
+        run.channels = channels;
+        vector<double> samples;
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            const double ms = UTimeMs([&] { UFlipPerByte(perByte.data(), FLIP_SIZE, FLIP_SIZE, channels); });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.perByteMs = UMedianMs(samples);
+
+        samples.clear();
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            const double ms = UTimeMs([&] { UFlipImageRows(rows.data(), FLIP_SIZE, FLIP_SIZE, channels); });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.rowMs = UMedianMs(samples);
+
+        // both were flipped the same number of times, so they must still match
+        run.identical = memcmp(perByte.data(), rows.data(), bytes) == 0;
+        gSink = rows[bytes / 2];
+        runs.push_back(run);
+    }
+
+    // Decoding a photo: in file order (the renderer's default, the blit into the array flips it),
+    // then flipped by stb_image itself and by UFlipImageRows
+    // ------------------
+    int width = 0, height = 0, channels = 0;
+    double decodeMs = 0.0, stbFlipMs = 0.0, rowFlipMs = 0.0;
+    const bool decoded = stbi_info(gImageFile.c_str(), &width, &height, &channels) != 0;
+    if (decoded)
+    {
+        vector<double> plain, stbFlip, rowFlip;
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            int w, h, c;
+            const double plainMs = UTimeMs([&] { stbi_image_free(stbi_load(gImageFile.c_str(), &w, &h, &c, 0)); });
+
+            stbi_set_flip_vertically_on_load_thread(1);
+            const double stbMs = UTimeMs([&] { stbi_image_free(stbi_load(gImageFile.c_str(), &w, &h, &c, 0)); });
+            stbi_set_flip_vertically_on_load_thread(0);
+
+            const double rowMs = UTimeMs([&]
+                {
+                    unsigned char* pixels = stbi_load(gImageFile.c_str(), &w, &h, &c, 0);
+                    UFlipImageRows(pixels, w, h, c);
+                    stbi_image_free(pixels);
+                });
+
+            if (repeat > 0)
+            {
+                plain.push_back(plainMs);
+                stbFlip.push_back(stbMs);
+                rowFlip.push_back(rowMs);
+            }
+        }
+        decodeMs = UMedianMs(plain);
+        stbFlipMs = UMedianMs(stbFlip);
+        rowFlipMs = UMedianMs(rowFlip);
+    }
+    else
+    {
+        cerr << "Failed to read image " << gImageFile << endl;
+    }
+
+    // Report
+    // ------
+    ofstream outputFile;
+    if (!gOutputFile.empty())
+        outputFile.open(gOutputFile);
+    ostream& out = gOutputFile.empty() ? cout : outputFile;
+
+    out << "{\n";
+    out << "  \"repeats\": " << gRepeats << ",\n";
+    out << "  \"flip_chunk_bytes\": " << IMAGE_FLIP_CHUNK << ",\n";
+    out << "  \"flip\": [\n";
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        const FlipRun& run = runs[r];
+        const double megabytes = (double)FLIP_SIZE * FLIP_SIZE * run.channels / (1 << 20);
+        out << "    { \"size\": \"" << FLIP_SIZE << "x" << FLIP_SIZE << "\", \"channels\": " << run.channels
+            << ", \"per_byte_ms\": " << run.perByteMs << ", \"rows_ms\": " << run.rowMs << ", \"speedup\": " << run.perByteMs / run.rowMs
+            << ", \"rows_mb_per_s\": " << megabytes * 1000.0 / run.rowMs << ", \"identical\": " << (run.identical ? "true" : "false") << " }"
+            << (r + 1 < runs.size() ? ",\n" : "\n");
+    }
+    out << "  ],\n";
+    out << "  \"decode\": { \"file\": \"" << gImageFile << "\"";
+    if (decoded)
+        out << ", \"size\": \"" << width << "x" << height << "\", \"channels\": " << channels << ", \"unflipped_ms\": " << decodeMs
+            << ", \"stb_flip_ms\": " << stbFlipMs << ", \"rows_flip_ms\": " << rowFlipMs;
+    out << " }\n";
+    out << "}" << endl;
+
+    return decoded && runs[0].identical && runs[1].identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// The flip the renderer used before UFlipImageRows, kept as the baseline: one byte swapped at a time
+void UFlipPerByte(unsigned char* image, int width, int height, int channels)
+{
+    for (int j = 0; j < height / 2; ++j)
+    {
+        int index1 = j * width * channels;
+        int index2 = (height - 1 - j) * width * channels;
+
+        for (int i = width * channels; i > 0; --i)
+        {
+            unsigned char tmp = image[index1];
+            image[index1] = image[index2];
+            image[index2] = tmp;
+            ++index1;
+            ++index2;
+        }
+    }
+}
+
+
+// Median of a series of times in milliseconds
+double UMedianMs(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+    return count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+}
+
+
+// Wall time of one call in milliseconds
+template <typename Function>
+double UTimeMs(const Function& function)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
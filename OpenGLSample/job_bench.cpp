@@ -0,0 +1,215 @@
+#include <iostream>         // cout, cerr
+#include <fstream>          // ofstream
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp
+#include <chrono>           // steady_clock
+#include <cmath>            // sqrt
+#include <string>
+#include <thread>           // hardware_concurrency
+#include <vector>
+#include <algorithm>        // sort
+
+#include "job_system.h"     // Work-stealing jobs
+#include "transform_store.h"    // Real per-frame work to split
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Timed repetitions of every measurement; the median is reported
+    int gRepeats = 15;
+
+    // Where to write the report (empty: stdout)
+    string gOutputFile;
+
+    // --threads: measure this thread count only (0: 1, 2, 4... up to every hardware thread)
+    unsigned gThreads = 0;
+
+    // Empty jobs spawned per batch, under JOB_QUEUE_CAPACITY so none of them runs inline
+    const size_t SPAWN_BATCH = 1000;
+
+    // Range split by the empty ParallelFor, and its grain
+    const size_t EMPTY_RANGE = 1 << 16;
+    const size_t EMPTY_GRAIN = 64;
+
+    // Compute-bound kernel: elements, chunk size and iterations per element
+    const size_t KERNEL_ELEMENTS = 1 << 20;
+    const size_t KERNEL_GRAIN = 4096;
+    const int KERNEL_ITERATIONS = 64;
+
+    // Transforms rebuilt per update, all of them moved
+    const uint32_t TRANSFORM_COUNT = 100000;
+
+    // Median time of one measurement at one thread count
+    struct ThreadRun
+    {
+        unsigned threads;
+        double spawnNs;         // per empty job: spawn, steal or pop, run, count down
+        double emptyRangeNs;    // per grain of an empty ParallelFor
+        double kernelMs;
+        double transformMs;
+    };
+
+    volatile float gSink;
+}
+
+double UMedianMs(vector<double> samples);
+template <typename Function> double UTimeMs(const Function& function);
+
+
+// Measures the job system's scheduling overhead (empty jobs and empty ParallelFor ranges) and how a compute-bound
+// loop and a TransformStore update scale from one thread to every hardware thread. Reports JSON.
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+            gRepeats = max(atoi(argv[++i]), 1);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            gThreads = (unsigned)max(atoi(argv[++i]), 0);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            gOutputFile = argv[++i];
+        else
+        {
+            cerr << "usage: job_bench [--repeats N] [--threads N] [--output report.json]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    if (gThreads > 0)
+        threadCounts.push_back(gThreads);
+    else
+    {
+        for (unsigned threads = 1; threads < hardwareThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    vector<float> values(KERNEL_ELEMENTS);
+    TransformStore transforms;
+    transforms.Reserve(TRANSFORM_COUNT);
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i)
+        transforms.Add(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)), glm::vec3(0.0f), glm::vec3(1.0f));
+
+    vector<ThreadRun> runs;
+    for (unsigned threads : threadCounts)
+    {
+        JobSystem jobs(threads);
+        ThreadRun run = {};
+        run.threads = jobs.ThreadCount();
+
+        // Empty jobs from the main thread, stolen by the workers
+        vector<double> samples;
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            const double ms = UTimeMs([&]
+                {
+                    JobCounter counter;
+                    for (size_t job = 0; job < SPAWN_BATCH; ++job)
+                        jobs.Spawn(counter, [] {});
+                    jobs.Wait(counter);
+                });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.spawnNs = UMedianMs(samples) * 1e6 / SPAWN_BATCH;
+
+        // Empty ranges, split recursively
+        samples.clear();
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            const double ms = UTimeMs([&] { jobs.ParallelFor(EMPTY_RANGE, EMPTY_GRAIN, [](size_t, size_t, unsigned) {}); });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.emptyRangeNs = UMedianMs(samples) * 1e6 / (EMPTY_RANGE / EMPTY_GRAIN);
+
+        // Compute-bound loop: no memory traffic to share, so it shows how far the scheduling lets it scale
+        samples.clear();
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            const double ms = UTimeMs([&]
+                {
+                    jobs.ParallelFor(KERNEL_ELEMENTS, KERNEL_GRAIN, [&](size_t begin, size_t end, unsigned)
+                        {
+                            for (size_t i = begin; i < end; ++i)
+                            {
+                                float x = (float)i;
+                                for (int iteration = 0; iteration < KERNEL_ITERATIONS; ++iteration)
+                                    x = sqrt(x * 0.5f + 1.0f);
+                                values[i] = x;
+                            }
+                        });
+                });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.kernelMs = UMedianMs(samples);
+        gSink = values[KERNEL_ELEMENTS / 2];
+
+        // Every transform moved, as in a frame where everything animates
+        samples.clear();
+        for (int repeat = 0; repeat <= gRepeats; ++repeat)
+        {
+            for (uint32_t i = 0; i < TRANSFORM_COUNT; ++i)
+                transforms.SetRotation(i, glm::vec3(0.0f, (float)repeat, 0.0f));
+            const double ms = UTimeMs([&] { transforms.Update(jobs); });
+            if (repeat > 0)
+                samples.push_back(ms);
+        }
+        run.transformMs = UMedianMs(samples);
+        gSink = transforms.Matrix(TRANSFORM_COUNT / 2)[3][0];
+
+        runs.push_back(run);
+    }
+
+    // Report
+    // ------
+    ofstream outputFile;
+    if (!gOutputFile.empty())
+        outputFile.open(gOutputFile);
+    ostream& out = gOutputFile.empty() ? cout : outputFile;
+
+    out << "{\n";
+    out << "  \"hardware_threads\": " << hardwareThreads << ",\n";
+    out << "  \"repeats\": " << gRepeats << ",\n";
+    out << "  \"spawn_batch\": " << SPAWN_BATCH << ",\n";
+    out << "  \"empty_range\": { \"count\": " << EMPTY_RANGE << ", \"grain\": " << EMPTY_GRAIN << " },\n";
+    out << "  \"kernel\": { \"elements\": " << KERNEL_ELEMENTS << ", \"grain\": " << KERNEL_GRAIN << ", \"iterations\": " << KERNEL_ITERATIONS << " },\n";
+    out << "  \"transforms\": " << TRANSFORM_COUNT << ",\n";
+    out << "  \"runs\": [\n";
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        const ThreadRun& run = runs[r];
+        out << "    { \"threads\": " << run.threads << ", \"spawn_ns_per_job\": " << run.spawnNs << ", \"parallel_for_ns_per_range\": " << run.emptyRangeNs
+            << ", \"kernel_ms\": " << run.kernelMs << ", \"kernel_speedup\": " << runs.front().kernelMs / run.kernelMs
+            << ", \"transform_update_ms\": " << run.transformMs << ", \"transform_speedup\": " << runs.front().transformMs / run.transformMs << " }"
+            << (r + 1 < runs.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}" << endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+// Median of a series of times in milliseconds
+double UMedianMs(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+    return count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+}
+
+
+// Wall time of one call in milliseconds
+template <typename Function>
+double UTimeMs(const Function& function)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
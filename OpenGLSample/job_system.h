@@ -0,0 +1,335 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Jobs each thread can have queued or running at once; a spawn beyond that runs the job on the spot
+const size_t JOB_QUEUE_CAPACITY = 1024;
+
+// Bytes of captured state a job's function may carry
+const size_t JOB_PAYLOAD_SIZE = 64;
+
+// Number of unfinished jobs spawned against it. A job that must run after others waits on their counter,
+// which runs queued jobs in the meantime instead of blocking the thread.
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{ 0 };
+};
+
+// Worker threads running small jobs. Every thread owns a Chase-Lev deque: it pushes and pops its own jobs at the
+// bottom without locks, while idle threads steal the oldest job from the top of a random victim's deque with a
+// single compare-and-swap. Jobs live in a ring inside their spawning thread's slot, so spawning allocates nothing.
+// The thread that creates the system is thread 0 and works whenever it waits; Spawn, Wait and ParallelFor
+// may be called from it or from inside jobs. Any other thread would share thread 0's deque and job ring, which only
+// their owner may touch, so debug builds assert that it does not.
+class JobSystem
+{
+public:
+    // threads counts the creating thread; 0 uses every hardware thread
+    explicit JobSystem(unsigned threads = 0)
+        : owner(std::this_thread::get_id())
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        slots.resize(threads);
+        for (unsigned thread = 0; thread < threads; ++thread)
+        {
+            slots[thread].reset(new ThreadSlot);
+            slots[thread]->random = 0x9E3779B9u * (thread + 1);
+        }
+        for (unsigned thread = 1; thread < threads; ++thread)
+            workers.emplace_back(&JobSystem::WorkerLoop, this, thread);
+    }
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true);
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned ThreadCount() const { return (unsigned)slots.size(); }
+
+    // index of the calling thread, in [0, ThreadCount()), for per-thread scratch memory. Only the creating thread and
+    // the workers have one; every entry point goes through here, so this is where outside callers are caught.
+    unsigned ThreadIndex() const
+    {
+        assert((currentSystem == this || std::this_thread::get_id() == owner) && "JobSystem used from a thread it does not own");
+        return currentSystem == this ? currentThread : 0;
+    }
+
+    // queues function() and counts it on counter until it has run. function is copied into the job,
+    // so it must be small and trivially copyable: a lambda capturing references, pointers and numbers.
+    template <typename Function>
+    void Spawn(JobCounter& counter, const Function& function)
+    {
+        static_assert(sizeof(Function) <= JOB_PAYLOAD_SIZE, "job captures too much state");
+        static_assert(std::is_trivially_copyable<Function>::value, "job functions must be trivially copyable");
+
+        ThreadSlot& slot = *slots[ThreadIndex()];
+        Job& job = slot.jobs[slot.nextJob % JOB_QUEUE_CAPACITY];
+        if (job.busy.load(std::memory_order_acquire) || !slot.CanPush())
+        {
+            // every job of this thread is still in flight: doing the work now is cheaper than waiting for room
+            function();
+            return;
+        }
+        ++slot.nextJob;
+
+        new (job.payload) Function(function);
+        job.run = &JobSystem::Invoke<Function>;
+        job.counter = &counter;
+        job.busy.store(true, std::memory_order_relaxed);
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        slot.Push(&job);
+
+        queued.fetch_add(1);
+        if (sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    // returns once every job counted on counter has run, running queued jobs meanwhile
+    void Wait(const JobCounter& counter)
+    {
+        const unsigned thread = ThreadIndex();
+        while (!counter.Done())
+        {
+            if (Job* job = FindJob(thread))
+                Execute(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // calls function(begin, end, thread) on disjoint ranges covering [0, count), none longer than grain, and returns
+    // when all are done. The range is halved recursively, so idle threads steal large halves rather than single chunks.
+    template <typename Function>
+    void ParallelFor(size_t count, size_t grain, const Function& function)
+    {
+        grain = std::max<size_t>(grain, 1);
+        if (count == 0)
+            return;
+        if (count <= grain || ThreadCount() == 1)
+        {
+            for (size_t begin = 0; begin < count; begin += grain)
+                function(begin, std::min(begin + grain, count), ThreadIndex());
+            return;
+        }
+
+        JobCounter counter;
+        RunRange(function, 0, count, grain, counter);
+        Wait(counter);
+    }
+
+private:
+    struct alignas(64) Job
+    {
+        void (*run)(Job&) = nullptr;
+        JobCounter* counter = nullptr;
+        std::atomic<bool> busy{ false };        // queued or running; the ring slot is not reused until it clears
+        alignas(16) unsigned char payload[JOB_PAYLOAD_SIZE];
+    };
+
+    // one per thread: its deque of queued jobs (bottom owned by the thread, top shared with thieves) and its job ring
+    struct alignas(64) ThreadSlot
+    {
+        std::atomic<int64_t> top{ 0 };
+        alignas(64) std::atomic<int64_t> bottom{ 0 };
+        std::atomic<Job*> queue[JOB_QUEUE_CAPACITY];
+        Job jobs[JOB_QUEUE_CAPACITY];
+        size_t nextJob = 0;
+        uint32_t random = 1;
+
+        bool CanPush() const
+        {
+            return bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_acquire) < (int64_t)JOB_QUEUE_CAPACITY;
+        }
+
+        // owner only
+        void Push(Job* job)
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            queue[b % JOB_QUEUE_CAPACITY].store(job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // owner only: newest job first, which is the one whose data is still in cache
+        Job* Pop()
+        {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = queue[b % JOB_QUEUE_CAPACITY].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // last job: race the thieves for it
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    job = nullptr;
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // any thread: oldest job first
+        Job* Steal()
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return nullptr;
+
+            Job* job = queue[t % JOB_QUEUE_CAPACITY].load(std::memory_order_relaxed);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+            return job;
+        }
+    };
+
+    template <typename Function>
+    static void Invoke(Job& job)
+    {
+        (*reinterpret_cast<Function*>(job.payload))();
+    }
+
+    template <typename Function>
+    void RunRange(const Function& function, size_t begin, size_t end, size_t grain, JobCounter& counter)
+    {
+        // hand the upper half to the deque until this thread's part fits in one grain
+        while (end - begin > grain)
+        {
+            const size_t middle = begin + (end - begin) / 2;
+            Spawn(counter, [this, &function, middle, end, grain, &counter] { RunRange(function, middle, end, grain, counter); });
+            end = middle;
+        }
+        function(begin, end, ThreadIndex());
+    }
+
+    // own deque first, then every other thread's starting at a random one
+    Job* FindJob(unsigned thread)
+    {
+        ThreadSlot& own = *slots[thread];
+        if (Job* job = own.Pop())
+        {
+            queued.fetch_sub(1);
+            return job;
+        }
+
+        const unsigned count = ThreadCount();
+        own.random ^= own.random << 13;
+        own.random ^= own.random >> 17;
+        own.random ^= own.random << 5;
+        const unsigned first = own.random % count;
+        for (unsigned offset = 0; offset < count; ++offset)
+        {
+            const unsigned victim = (first + offset) % count;
+            if (victim == thread)
+                continue;
+            if (Job* job = slots[victim]->Steal())
+            {
+                queued.fetch_sub(1);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void Execute(Job* job)
+    {
+        JobCounter* counter = job->counter;
+        job->run(*job);
+        job->busy.store(false, std::memory_order_release);
+        counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    void WorkerLoop(unsigned thread)
+    {
+        currentSystem = this;
+        currentThread = thread;
+
+        // spin briefly between jobs, since the next batch usually follows within microseconds, then sleep
+        const int IDLE_SPINS = 64;
+        int idle = 0;
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            if (Job* job = FindJob(thread))
+            {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            if (++idle < IDLE_SPINS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1);
+            wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+            sleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+
+    std::vector<std::unique_ptr<ThreadSlot>> slots;
+    std::vector<std::thread> workers;
+
+    // the creating thread, which works as thread 0
+    const std::thread::id owner;
+
+    // jobs pushed and not taken yet, and workers asleep waiting for one
+    std::atomic<int> queued{ 0 };
+    std::atomic<int> sleeping{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    // which system and slot the calling thread works for; the creating thread is thread 0
+    static thread_local const JobSystem* currentSystem;
+    static thread_local unsigned currentThread;
+};
+
+inline thread_local const JobSystem* JobSystem::currentSystem = nullptr;
+inline thread_local unsigned JobSystem::currentThread = 0;
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped read-only into memory. Pages are read from the file (or the OS cache) the first time they
+// are touched, so opening costs the same for any file size and nothing is copied until the data is used.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename)
+    {
+        Close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+            size = data ? (size_t)fileSize.QuadPart : 0;
+        }
+        CloseHandle(file);
+#else
+        const int file = open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapping != MAP_FAILED)
+            {
+                data = (const uint8_t*)mapping;
+                size = (size_t)status.st_size;
+            }
+        }
+        close(file);
+#endif
+        return data != nullptr;
+    }
+
+    void Close()
+    {
+        if (!data)
+            return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+#endif
@@ -7,6 +7,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "shader.h"
+#include "mesh_pool.h"
+#include "vertex_format.h"
 
 #include <string>
 #include <vector>
@@ -50,6 +52,66 @@ public:
 		setupMesh();
 	}
 
+	// constructor for a mesh suballocated from a shared pool: no buffers or vertex array of its own.
+	// packed meshes go into a pool made by SetupPackedPool and need Dequantization() applied to their model matrix.
+	Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, MeshPool& pool, bool packed = false)
+	{
+		this->vertices = vertices;
+		this->indices = indices;
+		this->textures = textures;
+		this->pool = &pool;
+
+		if (packed)
+		{
+			bounds = UComputeVertexBounds(&this->vertices[0].Position.x, this->vertices.size(), sizeof(Vertex) / sizeof(float));
+			vector<PackedTangentVertex> packedVertices(this->vertices.size());
+			for (size_t i = 0; i < this->vertices.size(); ++i)
+			{
+				const Vertex& vertex = this->vertices[i];
+				packedVertices[i] = UPackTangentVertex(vertex.Position, vertex.Normal, vertex.TexCoords, vertex.Tangent, vertex.Bitangent, bounds);
+			}
+			handle = pool.Allocate(&packedVertices[0], (GLuint)packedVertices.size(), &this->indices[0], (GLuint)this->indices.size());
+		}
+		else
+			handle = pool.Allocate(&this->vertices[0], (GLuint)this->vertices.size(), &this->indices[0], (GLuint)this->indices.size());
+		VAO = pool.VertexArray();
+	}
+
+	// creates a pool holding Vertex data, with the same attribute locations setupMesh uses
+	static void SetupPool(MeshPool& pool, GLuint vertexCapacity, GLuint indexCapacity)
+	{
+		pool.Create(sizeof(Vertex), vertexCapacity, indexCapacity);
+		pool.SetAttribute(0, 3, GL_FLOAT, GL_FALSE, 0);
+		pool.SetAttribute(1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Normal));
+		pool.SetAttribute(2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords));
+		pool.SetAttribute(3, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Tangent));
+		pool.SetAttribute(4, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Bitangent));
+	}
+
+	// creates a pool holding PackedTangentVertex data (16 bytes instead of 56): location 0 is the quantized position
+	// with the mirrored flag in w, 1 the tangent frame, 2 the half float uv. Vertex shaders decode them with
+	// PACKED_TANGENT_FRAME_GLSL: decodeTangentFrame(frame, position.w, normal, tangent, bitangent).
+	static void SetupPackedPool(MeshPool& pool, GLuint vertexCapacity, GLuint indexCapacity)
+	{
+		pool.Create(sizeof(PackedTangentVertex), vertexCapacity, indexCapacity);
+		pool.SetAttribute(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedTangentVertex, position));
+		pool.SetAttribute(1, 4, GL_UNSIGNED_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedTangentVertex, tangentFrame));
+		pool.SetAttribute(2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedTangentVertex, uv));
+	}
+
+	// maps a packed mesh's quantized positions to model space; identity for float meshes
+	glm::mat4 Dequantization() const
+	{
+		return bounds.Dequantization();
+	}
+
+	// gives a pooled mesh's ranges back to its pool
+	void Release()
+	{
+		if (pool != nullptr)
+			pool->Free(handle);
+	}
+
 	// render the mesh
 	void Draw(Shader &shader)
 	{
@@ -74,14 +136,17 @@ public:
 				number = std::to_string(heightNr++); // transfer unsigned int to stream
 
 			// now set the sampler to the correct texture unit
-			glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
+			glUniform1i(shader.getLocation(name + number), i);
 			// and finally bind the texture
 			glBindTexture(GL_TEXTURE_2D, textures[i].id);
 		}
 
-		// draw mesh
+		// draw mesh; pooled meshes share the pool's vertex array and are located by base vertex and first index
 		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+		if (pool != nullptr)
+			glDrawElementsBaseVertex(GL_TRIANGLES, handle.nIndices, GL_UNSIGNED_INT, handle.IndexOffset(), handle.baseVertex);
+		else
+			glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
 		glBindVertexArray(0);
 
 		// always good practice to set everything back to defaults once configured.
@@ -92,6 +157,13 @@ private:
 	// render data 
 	unsigned int VBO, EBO;
 
+	// pool the mesh was allocated from, if any, and where it lives in it
+	MeshPool* pool = nullptr;
+	MeshPool::Handle handle;
+
+	// quantization box of a packed mesh; the default one dequantizes to the identity
+	VertexBounds bounds;
+
 	// initializes all the buffer objects/arrays
 	void setupMesh()
 	{
@@ -0,0 +1,235 @@
+#include <algorithm>        // fill, min
+#include <cmath>            // pow, sqrt
+
+#include "mesh_optimizer.h"
+
+using namespace std; // Standard namespace
+
+/* Vertex cache optimization after Tom Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006).
+ *
+ * Every vertex gets a score from its position in a simulated LRU cache (recently used vertices score high,
+ * the three of the last triangle a bit less so the next triangle moves on) plus a bonus for having few
+ * triangles left, so isolated triangles are finished instead of left behind. A triangle's score is the sum
+ * of its vertices'. Each step emits the best triangle touching the cache, updates the cache and rescores
+ * only the vertices it touched, which keeps the whole pass linear in the number of triangles.
+ */
+
+// Unnamed namespace
+namespace
+{
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    // Score of a vertex at cachePosition (-1: not cached) with remainingTriangles still to emit
+    float UVertexScore(int cachePosition, unsigned remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+            {
+                const float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3);
+                score = pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        return score + VALENCE_BOOST_SCALE * pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+    }
+}
+
+
+// Reorders the triangles of an indexed triangle list; vertices stay where they are
+void UOptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Triangles using each vertex, as offsets into one shared array
+    vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for (uint32_t index : indices)
+        triangleOffsets[index + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v)
+        triangleOffsets[v + 1] += triangleOffsets[v];
+
+    vector<uint32_t> vertexTriangles(indices.size());
+    vector<uint32_t> remaining(vertexCount, 0);       // triangles not emitted yet, at the front of each vertex's list
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t v = indices[t * 3 + corner];
+            vertexTriangles[triangleOffsets[v] + remaining[v]++] = (uint32_t)t;
+        }
+    }
+
+    vector<int> cachePosition(vertexCount, -1);
+    vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScores[v] = UVertexScore(-1, remaining[v]);
+
+    vector<float> triangleScores(triangleCount);
+    vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+    // LRU cache of vertices, three spare slots for the ones a new triangle pushes in
+    uint32_t cache[VERTEX_CACHE_SIZE + 3];
+    unsigned cacheCount = 0;
+
+    vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    // Only needed when the cache holds no triangle with work left: the next unemitted triangle in input order
+    size_t scanPosition = 0;
+    int bestTriangle = 0;
+    float bestScore = triangleScores[0];
+    for (size_t t = 1; t < triangleCount; ++t)
+    {
+        if (triangleScores[t] > bestScore)
+        {
+            bestScore = triangleScores[t];
+            bestTriangle = (int)t;
+        }
+    }
+
+    while (bestTriangle >= 0)
+    {
+        const uint32_t* triangle = &indices[bestTriangle * 3];
+        emitted[bestTriangle] = true;
+        output.insert(output.end(), triangle, triangle + 3);
+
+        // Move the triangle's vertices to the front of the cache, keeping the others in order behind them
+        uint32_t newCache[VERTEX_CACHE_SIZE + 3];
+        unsigned newCount = 0;
+        for (int corner = 0; corner < 3; ++corner)
+            newCache[newCount++] = triangle[corner];
+        for (unsigned i = 0; i < cacheCount; ++i)
+        {
+            const uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache[newCount++] = v;
+        }
+
+        // Remove the triangle from its vertices' lists of remaining triangles
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t v = triangle[corner];
+            uint32_t* list = &vertexTriangles[triangleOffsets[v]];
+            for (uint32_t i = 0; i < remaining[v]; ++i)
+            {
+                if (list[i] == (uint32_t)bestTriangle)
+                {
+                    list[i] = list[remaining[v] - 1];
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        // Rescore the cached vertices (and those just evicted) and the triangles around them
+        for (unsigned i = 0; i < newCount; ++i)
+        {
+            const uint32_t v = newCache[i];
+            cachePosition[v] = i < VERTEX_CACHE_SIZE ? (int)i : -1;
+            const float score = UVertexScore(cachePosition[v], remaining[v]);
+            const float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t j = 0; j < remaining[v]; ++j)
+                triangleScores[vertexTriangles[triangleOffsets[v] + j]] += delta;
+        }
+
+        cacheCount = min(newCount, VERTEX_CACHE_SIZE);
+        copy(newCache, newCache + cacheCount, cache);
+
+        // Next: the best triangle around the cached vertices
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (unsigned i = 0; i < cacheCount; ++i)
+        {
+            const uint32_t v = cache[i];
+            for (uint32_t j = 0; j < remaining[v]; ++j)
+            {
+                const uint32_t t = vertexTriangles[triangleOffsets[v] + j];
+                if (triangleScores[t] > bestScore)
+                {
+                    bestScore = triangleScores[t];
+                    bestTriangle = (int)t;
+                }
+            }
+        }
+
+        // Nothing left around the cache: start again from the first triangle not emitted yet
+        if (bestTriangle < 0)
+        {
+            while (scanPosition < triangleCount && emitted[scanPosition])
+                ++scanPosition;
+            if (scanPosition < triangleCount)
+                bestTriangle = (int)scanPosition;
+        }
+    }
+
+    indices.swap(output);
+}
+
+
+// Renumbers vertices in the order the indices first use them and reorders the vertex data to match
+void UOptimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices, size_t floatsPerVertex)
+{
+    const size_t vertexCount = vertices.size() / floatsPerVertex;
+    const uint32_t UNUSED = 0xFFFFFFFFu;
+
+    vector<uint32_t> remap(vertexCount, UNUSED);
+    vector<float> reordered;
+    reordered.reserve(vertices.size());
+    uint32_t next = 0;
+    for (uint32_t& index : indices)
+    {
+        if (remap[index] == UNUSED)
+        {
+            remap[index] = next++;
+            reordered.insert(reordered.end(), vertices.begin() + index * floatsPerVertex, vertices.begin() + (index + 1) * floatsPerVertex);
+        }
+        index = remap[index];
+    }
+
+    // Vertices no triangle uses go last, so the vertex count does not change
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (remap[v] == UNUSED)
+            reordered.insert(reordered.end(), vertices.begin() + v * floatsPerVertex, vertices.begin() + (v + 1) * floatsPerVertex);
+
+    vertices.swap(reordered);
+}
+
+
+// Vertex shader invocations per triangle with a FIFO post-transform cache of cacheSize entries:
+// 3.0 is no reuse at all, about 0.5 is the limit for large regular grids
+float UComputeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned cacheSize)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || cacheSize == 0)
+        return 0.0f;
+
+    // Each vertex remembers the miss count when it entered the cache; it is still cached while fewer than cacheSize misses followed
+    vector<size_t> insertedAt(vertexCount, 0);
+    vector<bool> seen(vertexCount, false);
+    size_t misses = 0;
+    for (uint32_t index : indices)
+    {
+        if (!seen[index] || misses - insertedAt[index] >= cacheSize)
+        {
+            seen[index] = true;
+            insertedAt[index] = misses;
+            ++misses;
+        }
+    }
+
+    return (float)misses / triangleCount;
+}
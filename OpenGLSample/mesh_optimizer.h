@@ -0,0 +1,20 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cache size the optimizer assumes; works well on FIFO and LRU caches from about 16 entries up
+const unsigned VERTEX_CACHE_SIZE = 32;
+
+/* Mesh optimizer function prototypes to:
+ * reorder triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm),
+ * reorder vertices by first use so fetches walk the vertex buffer forwards,
+ * and measure the average cache miss ratio (vertex shader runs per triangle) with a FIFO cache model
+ */
+void UOptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+void UOptimizeVertexFetch(std::vector<float>& vertices, std::vector<uint32_t>& indices, size_t floatsPerVertex);
+float UComputeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, unsigned cacheSize);
+
+#endif
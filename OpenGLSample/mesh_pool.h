@@ -0,0 +1,265 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+// Include the GL loader (GLEW or glad) before this header
+
+#include <algorithm>
+#include <vector>
+
+// First-fit free-list allocator over a range of elements (vertices or indices).
+// Freed ranges are merged with their neighbours so the pool does not fragment into slivers.
+class RangeAllocator
+{
+public:
+    static const GLuint INVALID = 0xFFFFFFFFu;
+
+    // forgets every allocation: the whole capacity is one free range
+    void Reset(GLuint capacity)
+    {
+        this->capacity = capacity;
+        freeRanges.clear();
+        if (capacity > 0)
+            freeRanges.push_back(Range{ 0, capacity });
+    }
+
+    // adds more elements at the end, as after growing the buffer behind the allocator
+    void Grow(GLuint newCapacity)
+    {
+        if (newCapacity <= capacity)
+            return;
+        Release(capacity, newCapacity - capacity);
+        capacity = newCapacity;
+    }
+
+    // offset of count free elements, or INVALID if no free range is large enough
+    GLuint Allocate(GLuint count)
+    {
+        if (count == 0)
+            return 0;
+
+        for (size_t i = 0; i < freeRanges.size(); ++i)
+        {
+            Range& range = freeRanges[i];
+            if (range.count < count)
+                continue;
+
+            const GLuint offset = range.offset;
+            range.offset += count;
+            range.count -= count;
+            if (range.count == 0)
+                freeRanges.erase(freeRanges.begin() + i);
+            return offset;
+        }
+        return INVALID;
+    }
+
+    // returns count elements from offset to the free list
+    void Release(GLuint offset, GLuint count)
+    {
+        if (count == 0)
+            return;
+
+        // free ranges are kept sorted by offset, so neighbours are next to each other in the list
+        std::vector<Range>::iterator next = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset,
+            [](const Range& range, GLuint value) { return range.offset < value; });
+        next = freeRanges.insert(next, Range{ offset, count });
+
+        // merge with the following range
+        std::vector<Range>::iterator following = next + 1;
+        if (following != freeRanges.end() && next->offset + next->count == following->offset)
+        {
+            next->count += following->count;
+            freeRanges.erase(following);
+        }
+
+        // and with the previous one
+        if (next != freeRanges.begin())
+        {
+            std::vector<Range>::iterator previous = next - 1;
+            if (previous->offset + previous->count == next->offset)
+            {
+                previous->count += next->count;
+                freeRanges.erase(next);
+            }
+        }
+    }
+
+    GLuint Capacity() const { return capacity; }
+
+    // number of separate free ranges; 1 means the free space is contiguous
+    size_t FreeRangeCount() const { return freeRanges.size(); }
+
+    // total free elements
+    GLuint FreeCount() const
+    {
+        GLuint total = 0;
+        for (const Range& range : freeRanges)
+            total += range.count;
+        return total;
+    }
+
+private:
+    struct Range
+    {
+        GLuint offset;
+        GLuint count;
+    };
+
+    GLuint capacity = 0;
+    std::vector<Range> freeRanges;     // sorted by offset, never adjacent
+};
+
+
+// Suballocates every mesh from one vertex buffer and one index buffer behind one vertex array.
+// A mesh is a handle holding its base vertex and first index, drawn with the glDraw*BaseVertex calls,
+// so switching meshes needs no vertex array or buffer binds. Both buffers double when they run out.
+//
+// The vertex attributes are declared once with glVertexAttribFormat/glVertexAttribBinding on VERTEX_BINDING
+// (see SetAttribute), which lets the pool swap in a larger vertex buffer without touching them.
+class MeshPool
+{
+public:
+    // vertex buffer binding point the mesh attributes read from
+    static const GLuint VERTEX_BINDING = 0;
+
+    // where one mesh lives in the pool
+    struct Handle
+    {
+        GLint baseVertex = -1;
+        GLuint firstIndex = 0;
+        GLuint nVertices = 0;
+        GLuint nIndices = 0;
+
+        bool Valid() const { return baseVertex >= 0; }
+
+        // byte offset of the first index, as the glDrawElements* calls take it
+        const void* IndexOffset() const { return (const void*)((size_t)firstIndex * sizeof(GLuint)); }
+    };
+
+    // creates the vertex array and both buffers; vertexStride is the size of one vertex in bytes
+    void Create(GLsizei vertexStride, GLuint vertexCapacity, GLuint indexCapacity)
+    {
+        stride = vertexStride;
+        vertices.Reset(std::max<GLuint>(vertexCapacity, 1));
+        indices.Reset(std::max<GLuint>(indexCapacity, 1));
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ibo);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)vertices.Capacity() * stride, NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ibo);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)indices.Capacity() * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        glBindVertexArray(vao);
+        glBindVertexBuffer(VERTEX_BINDING, vbo, 0, stride);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBindVertexArray(0);
+    }
+
+    // releases the GL objects; every handle becomes invalid
+    void Destroy()
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ibo);
+        vao = vbo = ibo = 0;
+        vertices.Reset(0);
+        indices.Reset(0);
+    }
+
+    // declares float attribute location as components values at byte offset within a vertex
+    void SetAttribute(GLuint location, GLint components, GLenum type, GLboolean normalized, GLuint offset)
+    {
+        glBindVertexArray(vao);
+        glVertexAttribFormat(location, components, type, normalized, offset);
+        glVertexAttribBinding(location, VERTEX_BINDING);
+        glEnableVertexAttribArray(location);
+        glBindVertexArray(0);
+    }
+
+    // copies a mesh into the pool, growing the buffers if needed. Indices are relative to the mesh's first vertex.
+    Handle Allocate(const void* vertexData, GLuint nVertices, const GLuint* indexData, GLuint nIndices)
+    {
+        GLuint baseVertex = vertices.Allocate(nVertices);
+        if (baseVertex == RangeAllocator::INVALID)
+        {
+            GrowBuffer(vbo, vertices, stride, nVertices);
+            glBindVertexArray(vao);
+            glBindVertexBuffer(VERTEX_BINDING, vbo, 0, stride);
+            glBindVertexArray(0);
+            baseVertex = vertices.Allocate(nVertices);
+        }
+
+        GLuint firstIndex = indices.Allocate(nIndices);
+        if (firstIndex == RangeAllocator::INVALID)
+        {
+            GrowBuffer(ibo, indices, sizeof(GLuint), nIndices);
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+            glBindVertexArray(0);
+            firstIndex = indices.Allocate(nIndices);
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)baseVertex * stride, (GLsizeiptr)nVertices * stride, vertexData);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ibo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)firstIndex * sizeof(GLuint), (GLsizeiptr)nIndices * sizeof(GLuint), indexData);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        Handle handle;
+        handle.baseVertex = (GLint)baseVertex;
+        handle.firstIndex = firstIndex;
+        handle.nVertices = nVertices;
+        handle.nIndices = nIndices;
+        return handle;
+    }
+
+    // gives the mesh's ranges back to the pool; the data stays in the buffers until overwritten
+    void Free(Handle& handle)
+    {
+        if (!handle.Valid())
+            return;
+        vertices.Release((GLuint)handle.baseVertex, handle.nVertices);
+        indices.Release(handle.firstIndex, handle.nIndices);
+        handle = Handle();
+    }
+
+    GLuint VertexArray() const { return vao; }
+    GLuint VertexBuffer() const { return vbo; }
+    GLuint IndexBuffer() const { return ibo; }
+    const RangeAllocator& Vertices() const { return vertices; }
+    const RangeAllocator& Indices() const { return indices; }
+
+private:
+    // replaces buffer with one at least twice as large holding the same data, and extends the allocator
+    static void GrowBuffer(GLuint& buffer, RangeAllocator& allocator, GLsizeiptr elementSize, GLuint needed)
+    {
+        GLuint capacity = allocator.Capacity();
+        GLuint newCapacity = std::max<GLuint>(capacity * 2, capacity + needed);
+
+        GLuint grown = 0;
+        glGenBuffers(1, &grown);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCapacity * elementSize, NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)capacity * elementSize);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        glDeleteBuffers(1, &buffer);
+        buffer = grown;
+        allocator.Grow(newCapacity);
+    }
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ibo = 0;
+    GLsizei stride = 0;
+    RangeAllocator vertices;
+    RangeAllocator indices;
+};
+
+#endif
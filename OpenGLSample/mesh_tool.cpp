@@ -0,0 +1,109 @@
+#include <iostream>         // cout, cerr
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <random>           // mt19937
+#include <algorithm>        // shuffle
+#include <string>
+#include <vector>
+
+#include "primitives.h"     // Procedural meshes
+#include "mesh_optimizer.h" // Vertex cache optimization
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // --shape: report only this primitive (empty: all of them)
+    string gShape;
+
+    // Cache sizes the ACMR is reported for: small FIFO caches of older GPUs up to the optimizer's target
+    const unsigned REPORT_CACHE_SIZES[] = { 8, 16, 32 };
+}
+
+void UWriteMeshReport(ostream& out, const string& name, MeshData mesh, bool last);
+
+
+// Generates every detail level of the procedural meshes, runs them through the vertex cache optimizer
+// and reports the average cache miss ratio (vertex shader runs per triangle) before and after as JSON
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--shape") == 0 && i + 1 < argc)
+            gShape = argv[++i];
+        else
+        {
+            cerr << "usage: mesh_tool [--shape plane|box|cylinder|sphere|torus]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Levels to report, named shape_lodN
+    vector<string> names;
+    vector<MeshData> meshes;
+    for (uint32_t shape = 0; shape < PRIMITIVE_SHAPE_COUNT; ++shape)
+    {
+        if (!gShape.empty() && gShape != PRIMITIVE_SHAPE_NAMES[shape])
+            continue;
+
+        vector<MeshData> chain = UGenerateLodChain((Primitive_Shape)shape);
+        for (size_t level = 0; level < chain.size(); ++level)
+        {
+            names.push_back(string(PRIMITIVE_SHAPE_NAMES[shape]) + "_lod" + to_string(level));
+            meshes.push_back(chain[level]);
+        }
+    }
+    if (meshes.empty())
+    {
+        cerr << "Unknown shape " << gShape << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "{\n";
+    cout << "  \"meshes\": {\n";
+    for (size_t i = 0; i < meshes.size(); ++i)
+        UWriteMeshReport(cout, names[i], meshes[i], i + 1 == meshes.size());
+    cout << "  }\n";
+    cout << "}" << endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+// Writes vertex and triangle counts and the ACMR of the generated order and of the optimized one.
+// The same for the triangles in random order shows what the optimizer does with input that has no locality.
+void UWriteMeshReport(ostream& out, const string& name, MeshData mesh, bool last)
+{
+    const size_t vertexCount = mesh.VertexCount();
+    const vector<uint32_t> generated = mesh.indices;
+    UOptimizeVertexCache(mesh.indices, vertexCount);
+
+    vector<uint32_t> triangles(mesh.TriangleCount());
+    for (uint32_t t = 0; t < triangles.size(); ++t)
+        triangles[t] = t;
+    mt19937 random(1);
+    shuffle(triangles.begin(), triangles.end(), random);
+    vector<uint32_t> shuffled;
+    shuffled.reserve(generated.size());
+    for (uint32_t t : triangles)
+        shuffled.insert(shuffled.end(), generated.begin() + t * 3, generated.begin() + t * 3 + 3);
+    vector<uint32_t> shuffledOptimized = shuffled;
+    UOptimizeVertexCache(shuffledOptimized, vertexCount);
+
+    out << "    \"" << name << "\": {\n";
+    out << "      \"vertices\": " << vertexCount << ",\n";
+    out << "      \"triangles\": " << mesh.TriangleCount() << ",\n";
+    out << "      \"acmr\": {\n";
+    for (size_t i = 0; i < sizeof(REPORT_CACHE_SIZES) / sizeof(REPORT_CACHE_SIZES[0]); ++i)
+    {
+        const unsigned cacheSize = REPORT_CACHE_SIZES[i];
+        out << "        \"fifo" << cacheSize << "\": { \"before\": " << UComputeACMR(generated, vertexCount, cacheSize)
+            << ", \"after\": " << UComputeACMR(mesh.indices, vertexCount, cacheSize)
+            << ", \"shuffled_before\": " << UComputeACMR(shuffled, vertexCount, cacheSize)
+            << ", \"shuffled_after\": " << UComputeACMR(shuffledOptimized, vertexCount, cacheSize) << " }"
+            << (i + 1 < sizeof(REPORT_CACHE_SIZES) / sizeof(REPORT_CACHE_SIZES[0]) ? ",\n" : "\n");
+    }
+    out << "      }\n";
+    out << "    }" << (last ? "\n" : ",\n");
+}
@@ -0,0 +1,303 @@
+#include <algorithm>        // fill, min, max
+#include <cmath>            // ceil, floor
+#include <fstream>          // ofstream
+#include <limits>           // numeric_limits
+
+#include "occlusion.h"
+#include "simd.h"           // SSE or AVX wrappers
+
+using namespace std; // Standard namespace
+
+/* Software occlusion culling, after the usual CPU depth rasterizer approach (e.g. Intel's Masked Occlusion Culling,
+ * without the masks): a few large objects are drawn into a small depth buffer, then every other object's bounding
+ * box is projected and compared against it.
+ *
+ * Occluders cover a pixel when its center is inside the triangle, like the GPU. Because that can claim a pixel
+ * the occluder only partly covers, occludees test one extra pixel around their footprint: at an occluder's edge
+ * that reaches a pixel the occluder leaves uncovered, so nothing seen through the gap is culled.
+ */
+
+// Unnamed namespace
+namespace
+{
+    // Clip-space w below which a box corner counts as behind the camera
+    const float NEAR_W = 1e-5f;
+
+    // Screen-space vertex: pixel coordinates and window depth
+    struct ScreenVertex
+    {
+        float x, y, z;
+    };
+
+    inline ScreenVertex UToScreen(const OcclusionBuffer& buffer, const glm::vec4& clip)
+    {
+        const float inverseW = 1.0f / clip.w;
+        return { (clip.x * inverseW * 0.5f + 0.5f) * buffer.width,
+                 (clip.y * inverseW * 0.5f + 0.5f) * buffer.height,
+                 clip.z * inverseW * 0.5f + 0.5f };
+    }
+
+    // Edge function of the edge from a to b: A * x + B * y + C, positive on the left (inside a counter-clockwise triangle)
+    struct EdgeFunction
+    {
+        float a, b, c;
+
+        EdgeFunction(const ScreenVertex& from, const ScreenVertex& to)
+            : a(from.y - to.y), b(to.x - from.x), c(from.x * to.y - from.y * to.x)
+        {
+        }
+    };
+
+    // Draws a counter-clockwise screen-space triangle, keeping the nearer depth at every pixel whose center it covers.
+    // Rows are walked SIMD_WIDTH pixels at a time: the three edge functions and the depth plane step by their x slope.
+    void URasterizeTriangle(OcclusionBuffer& buffer, const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2)
+    {
+        const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (!(area > 0.0f))
+            return;     // back facing, degenerate or not a number
+
+        // Pixels whose centers fall in the triangle's bounds
+        const int minX = max(0, (int)ceil(min(v0.x, min(v1.x, v2.x)) - 0.5f));
+        const int maxX = min(buffer.width - 1, (int)floor(max(v0.x, max(v1.x, v2.x)) - 0.5f));
+        const int minY = max(0, (int)ceil(min(v0.y, min(v1.y, v2.y)) - 0.5f));
+        const int maxY = min(buffer.height - 1, (int)floor(max(v0.y, max(v1.y, v2.y)) - 0.5f));
+        if (minX > maxX || minY > maxY)
+            return;
+
+        // Each edge function is the opposite vertex's barycentric weight times the area, so they also interpolate depth
+        const EdgeFunction e0(v1, v2), e1(v2, v0), e2(v0, v1);
+        const float inverseArea = 1.0f / area;
+        const float zA = (e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) * inverseArea;
+        const float zB = (e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) * inverseArea;
+        const float zC = (e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) * inverseArea;
+
+        // Whole SIMD groups: lanes left of minX are outside the triangle's bounds, so the edge tests reject them
+        const int startX = minX - minX % (int)SIMD_WIDTH;
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const float centerY = y + 0.5f;
+            float* row = &buffer.depth[(size_t)y * buffer.width];
+            int x = startX;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+            const SimdFloat centerX = USimdAdd(USimdRamp(), USimdSplat(x + 0.5f));
+            SimdFloat w0 = USimdMulAdd(USimdSplat(e0.a), centerX, USimdSplat(e0.b * centerY + e0.c));
+            SimdFloat w1 = USimdMulAdd(USimdSplat(e1.a), centerX, USimdSplat(e1.b * centerY + e1.c));
+            SimdFloat w2 = USimdMulAdd(USimdSplat(e2.a), centerX, USimdSplat(e2.b * centerY + e2.c));
+            SimdFloat z = USimdMulAdd(USimdSplat(zA), centerX, USimdSplat(zB * centerY + zC));
+            const SimdFloat step0 = USimdSplat(e0.a * SIMD_WIDTH), step1 = USimdSplat(e1.a * SIMD_WIDTH), step2 = USimdSplat(e2.a * SIMD_WIDTH);
+            const SimdFloat stepZ = USimdSplat(zA * SIMD_WIDTH);
+            const SimdFloat zero = USimdSplat(0.0f);
+            for (; x <= maxX; x += (int)SIMD_WIDTH)
+            {
+                const SimdFloat inside = USimdAnd(USimdAnd(USimdGreaterEqual(w0, zero), USimdGreaterEqual(w1, zero)), USimdGreaterEqual(w2, zero));
+                if (USimdMask(inside))
+                {
+                    const SimdFloat depth = USimdLoad(row + x);
+                    USimdStore(row + x, USimdSelect(inside, USimdMin(depth, z), depth));
+                }
+                w0 = USimdAdd(w0, step0);
+                w1 = USimdAdd(w1, step1);
+                w2 = USimdAdd(w2, step2);
+                z = USimdAdd(z, stepZ);
+            }
+#else
+            for (; x <= maxX; ++x)
+            {
+                const float centerX = x + 0.5f;
+                if (e0.a * centerX + e0.b * centerY + e0.c >= 0.0f && e1.a * centerX + e1.b * centerY + e1.c >= 0.0f &&
+                    e2.a * centerX + e2.b * centerY + e2.c >= 0.0f)
+                    row[x] = min(row[x], zA * centerX + zB * centerY + zC);
+            }
+#endif
+        }
+    }
+
+    // Keeps the part of a clip-space polygon in front of the near plane (z >= -w); returns the new vertex count
+    int UClipNear(const glm::vec4* input, int count, glm::vec4* output)
+    {
+        int outputCount = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const glm::vec4& current = input[i];
+            const glm::vec4& next = input[(i + 1) % count];
+            const float currentDistance = current.z + current.w;
+            const float nextDistance = next.z + next.w;
+            if (currentDistance >= 0.0f)
+                output[outputCount++] = current;
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                output[outputCount++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+        }
+        return outputCount;
+    }
+}
+
+
+// Every pixel at the far plane, and the tile level to match
+void UClearOcclusionBuffer(OcclusionBuffer& buffer, int width, int height, const glm::mat4& viewProjection)
+{
+    buffer.width = width;
+    buffer.height = height;
+    buffer.tilesX = (width + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE;
+    buffer.tilesY = (height + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE;
+    buffer.viewProjection = viewProjection;
+    buffer.depth.assign((size_t)width * height, 1.0f);
+    buffer.tileMaxDepth.assign((size_t)buffer.tilesX * buffer.tilesY, 1.0f);
+}
+
+
+// Transforms the mesh to clip space, skips triangles entirely outside one side of the view volume,
+// clips the rest against the near plane and draws them as fans
+size_t URasterizeOccluder(OcclusionBuffer& buffer, const OccluderMesh& mesh, const glm::mat4& model)
+{
+    const glm::mat4 modelViewProjection = buffer.viewProjection * model;
+    vector<glm::vec4> clip(mesh.positions.size());
+    for (size_t v = 0; v < mesh.positions.size(); ++v)
+        clip[v] = modelViewProjection * glm::vec4(mesh.positions[v], 1.0f);
+
+    size_t drawn = 0;
+    for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+    {
+        const glm::vec4 triangle[3] = { clip[mesh.indices[t]], clip[mesh.indices[t + 1]], clip[mesh.indices[t + 2]] };
+
+        bool outside = false;
+        for (int axis = 0; axis < 3 && !outside; ++axis)
+        {
+            outside = (triangle[0][axis] > triangle[0].w && triangle[1][axis] > triangle[1].w && triangle[2][axis] > triangle[2].w) ||
+                      (triangle[0][axis] < -triangle[0].w && triangle[1][axis] < -triangle[1].w && triangle[2][axis] < -triangle[2].w);
+        }
+        if (outside)
+            continue;
+
+        glm::vec4 polygon[4];
+        const int count = UClipNear(triangle, 3, polygon);
+        if (count < 3)
+            continue;
+
+        ScreenVertex screen[4];
+        for (int i = 0; i < count; ++i)
+            screen[i] = UToScreen(buffer, polygon[i]);
+        for (int i = 1; i + 1 < count; ++i)
+            URasterizeTriangle(buffer, screen[0], screen[i], screen[i + 1]);
+        ++drawn;
+    }
+    return drawn;
+}
+
+
+// Farthest depth of every tile
+void UBuildHierarchicalZ(OcclusionBuffer& buffer)
+{
+    for (int tileY = 0; tileY < buffer.tilesY; ++tileY)
+    {
+        for (int tileX = 0; tileX < buffer.tilesX; ++tileX)
+        {
+            float farthest = 0.0f;
+            const int endY = min(buffer.height, (tileY + 1) * OCCLUSION_TILE_SIZE);
+            const int endX = min(buffer.width, (tileX + 1) * OCCLUSION_TILE_SIZE);
+            for (int y = tileY * OCCLUSION_TILE_SIZE; y < endY; ++y)
+                for (int x = tileX * OCCLUSION_TILE_SIZE; x < endX; ++x)
+                    farthest = max(farthest, buffer.depth[(size_t)y * buffer.width + x]);
+            buffer.tileMaxDepth[(size_t)tileY * buffer.tilesX + tileX] = farthest;
+        }
+    }
+}
+
+
+// Projects the box's corners to a screen rectangle (one pixel wider on every side) and its nearest depth.
+// Hidden only if every pixel in the rectangle holds something nearer: tiles whose farthest depth is nearer
+// settle their part at once, the others are checked pixel by pixel. Boxes reaching behind the camera are never hidden.
+bool UIsBoxOccluded(const OcclusionBuffer& buffer, const glm::vec3& center, const glm::vec3& extent)
+{
+    if (buffer.depth.empty())
+        return false;
+
+    float minX = numeric_limits<float>::max(), minY = minX, minZ = minX;
+    float maxX = -minX, maxY = -minX;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+        const glm::vec4 clip = buffer.viewProjection * glm::vec4(center + sign * extent, 1.0f);
+        if (clip.w <= NEAR_W)
+            return false;
+
+        const ScreenVertex screen = UToScreen(buffer, clip);
+        minX = min(minX, screen.x);
+        maxX = max(maxX, screen.x);
+        minY = min(minY, screen.y);
+        maxY = max(maxY, screen.y);
+        minZ = min(minZ, screen.z);
+    }
+    if (minZ <= 0.0f)
+        return false;
+
+    const int x0 = max(0, (int)floor(minX - 0.5f) - 1), x1 = min(buffer.width - 1, (int)ceil(maxX - 0.5f) + 1);
+    const int y0 = max(0, (int)floor(minY - 0.5f) - 1), y1 = min(buffer.height - 1, (int)ceil(maxY - 0.5f) + 1);
+    if (x0 > x1 || y0 > y1)
+        return false;
+
+    for (int tileY = y0 / OCCLUSION_TILE_SIZE; tileY <= y1 / OCCLUSION_TILE_SIZE; ++tileY)
+    {
+        for (int tileX = x0 / OCCLUSION_TILE_SIZE; tileX <= x1 / OCCLUSION_TILE_SIZE; ++tileX)
+        {
+            if (buffer.tileMaxDepth[(size_t)tileY * buffer.tilesX + tileX] < minZ)
+                continue;
+
+            const int startY = max(y0, tileY * OCCLUSION_TILE_SIZE), endY = min(y1, (tileY + 1) * OCCLUSION_TILE_SIZE - 1);
+            const int startX = max(x0, tileX * OCCLUSION_TILE_SIZE), endX = min(x1, (tileX + 1) * OCCLUSION_TILE_SIZE - 1);
+            for (int y = startY; y <= endY; ++y)
+                for (int x = startX; x <= endX; ++x)
+                    if (buffer.depth[(size_t)y * buffer.width + x] >= minZ)
+                        return false;
+        }
+    }
+    return true;
+}
+
+
+// Only boxes still marked visible are tested, so frustum-culled ones cost nothing
+size_t UCullOccluded(const OcclusionBuffer& buffer, const BoundingBoxes& boxes, uint8_t* visible)
+{
+    size_t occluded = 0;
+    for (size_t i = 0; i < boxes.Size(); ++i)
+    {
+        if (!visible[i])
+            continue;
+
+        const glm::vec3 center(boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i]);
+        const glm::vec3 extent(boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i]);
+        if (UIsBoxOccluded(buffer, center, extent))
+        {
+            visible[i] = 0;
+            ++occluded;
+        }
+    }
+    return occluded;
+}
+
+
+// Binary PGM, top row first. Window depth crowds towards 1, so the range is stretched:
+// the nearest occluder pixel is black and the far plane (nothing drawn) white.
+bool UWriteOcclusionImage(const OcclusionBuffer& buffer, const std::string& filename)
+{
+    ofstream file(filename, ios::binary);
+    if (!file)
+        return false;
+
+    float nearest = 1.0f;
+    for (float depth : buffer.depth)
+        nearest = min(nearest, max(depth, 0.0f));
+    const float scale = nearest < 1.0f ? 255.0f / (1.0f - nearest) : 0.0f;
+
+    file << "P5\n" << buffer.width << " " << buffer.height << "\n255\n";
+    vector<unsigned char> row(buffer.width);
+    for (int y = buffer.height - 1; y >= 0; --y)
+    {
+        for (int x = 0; x < buffer.width; ++x)
+        {
+            const float depth = min(max(buffer.depth[(size_t)y * buffer.width + x], nearest), 1.0f);
+            row[x] = (unsigned char)((depth - nearest) * scale + 0.5f);
+        }
+        file.write((const char*)row.data(), row.size());
+    }
+    return (bool)file;
+}
@@ -0,0 +1,58 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "frustum.h"        // World bounding boxes
+
+// Size of the occlusion depth buffer: small enough to rasterize on the CPU every frame,
+// with the window's 4:3 aspect. Both are multiples of the tile size and of the widest SIMD width.
+const int OCCLUSION_WIDTH = 256;
+const int OCCLUSION_HEIGHT = 192;
+
+// Pixels per side of the tiles the hierarchical Z level keeps the farthest depth of
+const int OCCLUSION_TILE_SIZE = 8;
+
+// Triangles drawn into the occlusion buffer: model-space positions only, counter-clockwise seen from outside
+struct OccluderMesh
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+
+    size_t TriangleCount() const { return indices.size() / 3; }
+};
+
+// Depth of the nearest occluder at every pixel, as window depth (0 near plane, 1 far plane) with row 0 at the bottom,
+// and the farthest of those depths in every tile: one comparison there settles a whole tile of an occludee's footprint
+struct OcclusionBuffer
+{
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    std::vector<float> depth;
+    std::vector<float> tileMaxDepth;
+};
+
+/* Occlusion culling function prototypes to:
+ * clear the buffer for a new view,
+ * rasterize an occluder's front faces (clipped against the near plane) and return how many triangles were drawn,
+ * build the tile level once every occluder is drawn,
+ * test whether a world-space box is hidden behind the occluders,
+ * clear the visible flag of every visible box that is hidden and return how many were,
+ * and write the depth buffer as a grayscale PGM image (near is dark)
+ */
+void UClearOcclusionBuffer(OcclusionBuffer& buffer, int width, int height, const glm::mat4& viewProjection);
+size_t URasterizeOccluder(OcclusionBuffer& buffer, const OccluderMesh& mesh, const glm::mat4& model);
+void UBuildHierarchicalZ(OcclusionBuffer& buffer);
+bool UIsBoxOccluded(const OcclusionBuffer& buffer, const glm::vec3& center, const glm::vec3& extent);
+size_t UCullOccluded(const OcclusionBuffer& buffer, const BoundingBoxes& boxes, uint8_t* visible);
+bool UWriteOcclusionImage(const OcclusionBuffer& buffer, const std::string& filename);
+
+#endif
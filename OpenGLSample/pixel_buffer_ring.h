@@ -0,0 +1,175 @@
+#ifndef PIXEL_BUFFER_RING_H
+#define PIXEL_BUFFER_RING_H
+
+// Include the GL loader (GLEW or glad) before this header
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// A pixel unpack buffer split into equal slots and mapped persistently, so other threads can write texture data
+// straight into memory the driver uploads from. A slot goes around the ring: a decoding thread acquires a free one
+// and fills it, the GL thread issues the glTexSubImage calls reading it and releases it behind a fence, and once
+// the GPU has passed the fence the slot is free again. Acquire blocks while every slot is in use, which keeps the
+// decoders from running further ahead of the uploads than the ring is deep.
+class PixelBufferRing
+{
+public:
+    PixelBufferRing() = default;
+
+    // releases threads still waiting for a slot; the GL objects go with Destroy, on the GL thread
+    ~PixelBufferRing() { Close(); }
+
+    PixelBufferRing(const PixelBufferRing&) = delete;
+    PixelBufferRing& operator=(const PixelBufferRing&) = delete;
+
+    // GL thread: allocates and maps slots slots of slotBytes each. Needs GL 4.4 or ARB_buffer_storage.
+    bool Create(size_t slotBytes, unsigned slots)
+    {
+        Destroy();
+        this->slotBytes = slotBytes;
+        const GLsizeiptr size = (GLsizeiptr)(slotBytes * slots);
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+        memory = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!memory)
+        {
+            Destroy();
+            return false;
+        }
+
+        fences.assign(slots, nullptr);
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = false;
+        freeSlots.clear();
+        for (unsigned slot = 0; slot < slots; ++slot)
+            freeSlots.push_back((int)slot);
+        return true;
+    }
+
+    // GL thread: waits for the uploads still reading the buffer, then unmaps and deletes it. Close the ring and
+    // stop the threads using it first.
+    void Destroy()
+    {
+        Close();
+        for (GLsync& fence : fences)
+        {
+            if (fence)
+            {
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+                glDeleteSync(fence);
+            }
+            fence = nullptr;
+        }
+        fences.clear();
+        inFlight.clear();
+        if (buffer)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+            if (memory)
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &buffer);
+        }
+        buffer = 0;
+        memory = nullptr;
+    }
+
+    GLuint Buffer() const { return buffer; }
+    unsigned SlotCount() const { return (unsigned)fences.size(); }
+    size_t SlotBytes() const { return slotBytes; }
+
+    // byte offset of a slot in the buffer, the "pointer" glTexSubImage takes while the buffer is bound
+    size_t Offset(int slot) const { return (size_t)slot * slotBytes; }
+
+    // any thread: where to write a slot acquired by this thread
+    unsigned char* Data(int slot) const { return memory + Offset(slot); }
+
+    // any thread: a free slot, waiting for one if needed; -1 once the ring is closed
+    int Acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotFreed.wait(lock, [this] { return closed || !freeSlots.empty(); });
+        if (closed)
+            return -1;
+        const int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    // any thread: gives back a slot the GPU never read, such as one whose image is dropped
+    void Discard(int slot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeSlots.push_back(slot);
+        }
+        slotFreed.notify_one();
+    }
+
+    // GL thread: call after the commands reading the slot; it is reused once the GPU has executed them
+    void Release(int slot)
+    {
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        inFlight.push_back(slot);
+    }
+
+    // GL thread: frees the slots whose uploads have finished, oldest first. With wait, blocks until all have.
+    void Recycle(bool wait)
+    {
+        while (!inFlight.empty())
+        {
+            const int slot = inFlight.front();
+            const GLenum status = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? FENCE_TIMEOUT_NS : 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                if (!wait)
+                    return;
+                continue;
+            }
+            glDeleteSync(fences[slot]);
+            fences[slot] = nullptr;
+            inFlight.pop_front();
+            Discard(slot);
+        }
+    }
+
+    // slots the GPU may still be reading
+    size_t InFlight() const { return inFlight.size(); }
+
+    // any thread: makes every waiting and future Acquire return -1
+    void Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        slotFreed.notify_all();
+    }
+
+private:
+    // longest a single blocking wait on a fence lasts
+    static const GLuint64 FENCE_TIMEOUT_NS = 1000000000ull;
+
+    GLuint buffer = 0;
+    unsigned char* memory = nullptr;
+    size_t slotBytes = 0;
+
+    // GL thread only: the fence behind each released slot, in release order
+    std::vector<GLsync> fences;
+    std::deque<int> inFlight;
+
+    // shared with the decoding threads
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    std::vector<int> freeSlots;
+    bool closed = true;
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include <algorithm>        // max
+#include <cmath>            // cos, sin
+
+#include "primitives.h"
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    const float PI = 3.14159265358979f;
+
+    // Sizes of the generated torus: ring and tube radius, so it spans the unit box like the sphere
+    const float TORUS_RING_RADIUS = 0.375f;
+    const float TORUS_TUBE_RADIUS = 0.125f;
+
+    // Detail levels of the curved shapes, finest first: sides (or meridians) and rings of each.
+    // Each level has about a quarter of the previous one's triangles; the finest cylinder keeps
+    // the original's 36 sides.
+    const unsigned CYLINDER_LOD_SEGMENTS[PRIMITIVE_MAX_LODS] = { 36, 16, 8 };
+    const unsigned SPHERE_LOD_SEGMENTS[PRIMITIVE_MAX_LODS][2] = { { 32, 16 }, { 16, 8 }, { 8, 6 } };
+    const unsigned TORUS_LOD_SEGMENTS[PRIMITIVE_MAX_LODS][2] = { { 32, 16 }, { 16, 8 }, { 8, 6 } };
+
+    struct Vector3
+    {
+        float x, y, z;
+    };
+
+    // Appends one vertex and returns its index
+    uint32_t UAddVertex(MeshData& mesh, float x, float y, float z, float nx, float ny, float nz, float u, float v)
+    {
+        const uint32_t index = (uint32_t)mesh.VertexCount();
+        const float vertex[PRIMITIVE_FLOATS_PER_VERTEX] = { x, y, z, nx, ny, nz, u, v };
+        mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + PRIMITIVE_FLOATS_PER_VERTEX);
+        return index;
+    }
+
+    void UAddTriangle(MeshData& mesh, uint32_t a, uint32_t b, uint32_t c)
+    {
+        mesh.indices.push_back(a);
+        mesh.indices.push_back(b);
+        mesh.indices.push_back(c);
+    }
+
+    // Appends a grid of (columns + 1) x (rows + 1) vertices, vertex (i, j) being firstVertex + j * (columns + 1) + i,
+    // as two counter-clockwise triangles per quad; skipFirstRow and skipLastRow drop the triangles that
+    // collapse where a row shrinks to a point (sphere poles)
+    void UAddGridTriangles(MeshData& mesh, uint32_t firstVertex, unsigned columns, unsigned rows, bool skipFirstRow = false, bool skipLastRow = false)
+    {
+        const uint32_t stride = columns + 1;
+        for (uint32_t j = 0; j < rows; ++j)
+        {
+            for (uint32_t i = 0; i < columns; ++i)
+            {
+                const uint32_t a = firstVertex + j * stride + i, b = a + 1, c = b + stride, d = a + stride;
+                if (!skipFirstRow || j != 0)
+                    UAddTriangle(mesh, a, b, c);
+                if (!skipLastRow || j != rows - 1)
+                    UAddTriangle(mesh, a, c, d);
+            }
+        }
+    }
+
+    // Appends a flat quad from origin spanning uAxis and vAxis as a tessellated grid, with uv 0..1 along the axes.
+    // uAxis x vAxis points along normal, so the triangles face it.
+    void UAddQuadGrid(MeshData& mesh, Vector3 origin, Vector3 uAxis, Vector3 vAxis, Vector3 normal, unsigned subdivisions)
+    {
+        const uint32_t firstVertex = (uint32_t)mesh.VertexCount();
+        for (unsigned j = 0; j <= subdivisions; ++j)
+        {
+            const float v = (float)j / subdivisions;
+            for (unsigned i = 0; i <= subdivisions; ++i)
+            {
+                const float u = (float)i / subdivisions;
+                UAddVertex(mesh,
+                    origin.x + u * uAxis.x + v * vAxis.x, origin.y + u * uAxis.y + v * vAxis.y, origin.z + u * uAxis.z + v * vAxis.z,
+                    normal.x, normal.y, normal.z, u, v);
+            }
+        }
+        UAddGridTriangles(mesh, firstVertex, subdivisions, subdivisions);
+    }
+}
+
+
+// Same mapping as the original hand-typed plane: u runs along +x, v along -z
+MeshData UGeneratePlane(unsigned subdivisions)
+{
+    subdivisions = max(subdivisions, 1u);
+
+    MeshData mesh;
+    mesh.vertices.reserve((subdivisions + 1) * (subdivisions + 1) * PRIMITIVE_FLOATS_PER_VERTEX);
+    mesh.indices.reserve(subdivisions * subdivisions * 6);
+    UAddQuadGrid(mesh, { -1.0f, 0.0f, 1.0f }, { 2.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -2.0f }, { 0.0f, 1.0f, 0.0f }, subdivisions);
+    return mesh;
+}
+
+
+// Six faces with their own vertices so each keeps a flat normal, in the original cube's order
+// (back, bottom, left, right, top, front) and with its texture orientation on every face
+MeshData UGenerateBox(unsigned subdivisions)
+{
+    subdivisions = max(subdivisions, 1u);
+
+    // Normal, u axis and v axis of each face
+    const Vector3 faces[6][3] = {
+        { {  0.0f,  0.0f, -1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+        { {  0.0f, -1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f } },
+        { { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f } },
+        { {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f } },
+        { {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } },
+        { {  0.0f,  0.0f,  1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+    };
+
+    MeshData mesh;
+    mesh.vertices.reserve(6 * (subdivisions + 1) * (subdivisions + 1) * PRIMITIVE_FLOATS_PER_VERTEX);
+    mesh.indices.reserve(6 * subdivisions * subdivisions * 6);
+    for (const Vector3* face : faces)
+    {
+        const Vector3& n = face[0];
+        const Vector3& u = face[1];
+        const Vector3& v = face[2];
+        const Vector3 origin = { 0.5f * (n.x - u.x - v.x), 0.5f * (n.y - u.y - v.y), 0.5f * (n.z - u.z - v.z) };
+        UAddQuadGrid(mesh, origin, u, v, n, subdivisions);
+    }
+    return mesh;
+}
+
+
+// Side first (a quad strip with a duplicated seam column so u runs 0..1), then the bottom and top caps as fans
+// around a center vertex. Same mapping as the original hand-typed cylinder: angle t goes from +x towards -z,
+// the side's u is t / 2pi and v is y, the caps map x, z onto the unit square.
+MeshData UGenerateCylinder(unsigned segments)
+{
+    segments = max(segments, 3u);
+
+    MeshData mesh;
+    mesh.vertices.reserve(((segments + 1) * 2 + (segments + 1) * 2) * PRIMITIVE_FLOATS_PER_VERTEX);
+    mesh.indices.reserve(segments * 12);
+
+    // Side
+    for (unsigned i = 0; i <= segments; ++i)
+    {
+        const float t = 2.0f * PI * i / segments;
+        const float x = cos(t), z = -sin(t);
+        const float u = (float)i / segments;
+        UAddVertex(mesh, x, 0.0f, z, x, 0.0f, z, u, 0.0f);
+        UAddVertex(mesh, x, 1.0f, z, x, 0.0f, z, u, 1.0f);
+    }
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        const uint32_t bottom = i * 2, top = bottom + 1, nextBottom = bottom + 2, nextTop = bottom + 3;
+        UAddTriangle(mesh, bottom, nextBottom, nextTop);
+        UAddTriangle(mesh, bottom, nextTop, top);
+    }
+
+    // Caps: the bottom one faces -y, so its triangles wind the other way round
+    for (int cap = 0; cap < 2; ++cap)
+    {
+        const float y = (float)cap, ny = cap == 0 ? -1.0f : 1.0f;
+        const uint32_t center = UAddVertex(mesh, 0.0f, y, 0.0f, 0.0f, ny, 0.0f, 0.5f, 0.5f);
+        for (unsigned i = 0; i < segments; ++i)
+        {
+            const float t = 2.0f * PI * i / segments;
+            const float x = cos(t), z = -sin(t);
+            UAddVertex(mesh, x, y, z, 0.0f, ny, 0.0f, 0.5f + 0.5f * z, 0.5f + 0.5f * x);
+        }
+        for (uint32_t i = 0; i < segments; ++i)
+        {
+            const uint32_t current = center + 1 + i, next = center + 1 + (i + 1) % segments;
+            if (cap == 0)
+                UAddTriangle(mesh, center, next, current);
+            else
+                UAddTriangle(mesh, center, current, next);
+        }
+    }
+
+    return mesh;
+}
+
+
+// Latitude-longitude sphere: rings + 1 rows of segments + 1 vertices from the south pole up, with a seam
+// column so u runs 0..1 around (angle from +x towards -z, like the cylinder) and v from 0 at the bottom to 1.
+// The pole rows repeat one point; the triangles touching them that collapse are left out.
+MeshData UGenerateSphere(unsigned segments, unsigned rings)
+{
+    segments = max(segments, 3u);
+    rings = max(rings, 2u);
+
+    MeshData mesh;
+    mesh.vertices.reserve((segments + 1) * (rings + 1) * PRIMITIVE_FLOATS_PER_VERTEX);
+    mesh.indices.reserve(segments * (rings - 1) * 6);
+    for (unsigned j = 0; j <= rings; ++j)
+    {
+        const float latitude = PI * j / rings;
+        const float y = -cos(latitude), radius = sin(latitude);
+        for (unsigned i = 0; i <= segments; ++i)
+        {
+            const float t = 2.0f * PI * i / segments;
+            const float x = radius * cos(t), z = -radius * sin(t);
+            UAddVertex(mesh, 0.5f * x, 0.5f * y, 0.5f * z, x, y, z, (float)i / segments, (float)j / rings);
+        }
+    }
+    UAddGridTriangles(mesh, 0, segments, rings, true, true);
+    return mesh;
+}
+
+
+// Ring of tube cross-sections: segments + 1 columns around the y axis (angle from +x towards -z), rings + 1
+// vertices around the tube starting on the outer equator and going up. u runs around the ring, v around the tube.
+MeshData UGenerateTorus(unsigned segments, unsigned rings)
+{
+    segments = max(segments, 3u);
+    rings = max(rings, 3u);
+
+    MeshData mesh;
+    mesh.vertices.reserve((segments + 1) * (rings + 1) * PRIMITIVE_FLOATS_PER_VERTEX);
+    mesh.indices.reserve(segments * rings * 6);
+    for (unsigned j = 0; j <= rings; ++j)
+    {
+        const float p = 2.0f * PI * j / rings;
+        for (unsigned i = 0; i <= segments; ++i)
+        {
+            const float t = 2.0f * PI * i / segments;
+            const float dx = cos(t), dz = -sin(t);
+            const float nx = cos(p) * dx, ny = sin(p), nz = cos(p) * dz;
+            UAddVertex(mesh,
+                TORUS_RING_RADIUS * dx + TORUS_TUBE_RADIUS * nx, TORUS_TUBE_RADIUS * ny, TORUS_RING_RADIUS * dz + TORUS_TUBE_RADIUS * nz,
+                nx, ny, nz, (float)i / segments, (float)j / rings);
+        }
+    }
+
+    // Rows of the grid run around the ring, so the quads' first edge follows the angle t
+    UAddGridTriangles(mesh, 0, segments, rings);
+    return mesh;
+}
+
+
+// Curved shapes get PRIMITIVE_MAX_LODS levels; a plane or box has no coarser form, so its chain is one level
+std::vector<MeshData> UGenerateLodChain(Primitive_Shape shape)
+{
+    vector<MeshData> chain;
+    switch (shape)
+    {
+    case PRIMITIVE_PLANE:
+        chain.push_back(UGeneratePlane(1));
+        break;
+    case PRIMITIVE_BOX:
+        chain.push_back(UGenerateBox(1));
+        break;
+    case PRIMITIVE_CYLINDER:
+        for (unsigned level = 0; level < PRIMITIVE_MAX_LODS; ++level)
+            chain.push_back(UGenerateCylinder(CYLINDER_LOD_SEGMENTS[level]));
+        break;
+    case PRIMITIVE_SPHERE:
+        for (unsigned level = 0; level < PRIMITIVE_MAX_LODS; ++level)
+            chain.push_back(UGenerateSphere(SPHERE_LOD_SEGMENTS[level][0], SPHERE_LOD_SEGMENTS[level][1]));
+        break;
+    case PRIMITIVE_TORUS:
+        for (unsigned level = 0; level < PRIMITIVE_MAX_LODS; ++level)
+            chain.push_back(UGenerateTorus(TORUS_LOD_SEGMENTS[level][0], TORUS_LOD_SEGMENTS[level][1]));
+        break;
+    default:
+        break;
+    }
+    return chain;
+}
@@ -0,0 +1,54 @@
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Floats per vertex of generated meshes: position xyz, normal xyz, texture coordinate uv
+const unsigned PRIMITIVE_FLOATS_PER_VERTEX = 8;
+
+// Shapes the generator builds, in the same order as the scene's Scene_Mesh
+enum Primitive_Shape : uint32_t {
+    PRIMITIVE_PLANE,
+    PRIMITIVE_BOX,
+    PRIMITIVE_CYLINDER,
+    PRIMITIVE_SPHERE,
+    PRIMITIVE_TORUS,
+    PRIMITIVE_SHAPE_COUNT
+};
+const char* const PRIMITIVE_SHAPE_NAMES[PRIMITIVE_SHAPE_COUNT] = { "plane", "box", "cylinder", "sphere", "torus" };
+
+// Most detail levels a shape's chain has; flat shapes have only one
+const unsigned PRIMITIVE_MAX_LODS = 3;
+
+// Screen size below which each coarser detail level takes over: the fraction of the viewport height
+// covered by the instance's bounding sphere
+const float PRIMITIVE_LOD_SCREEN_SIZES[PRIMITIVE_MAX_LODS - 1] = { 0.25f, 0.1f };
+
+// Indexed triangle list in the interleaved layout the renderer's meshes use
+struct MeshData
+{
+    std::vector<float> vertices;        // PRIMITIVE_FLOATS_PER_VERTEX floats per vertex
+    std::vector<uint32_t> indices;      // three per triangle, counter-clockwise seen from outside
+
+    size_t VertexCount() const { return vertices.size() / PRIMITIVE_FLOATS_PER_VERTEX; }
+    size_t TriangleCount() const { return indices.size() / 3; }
+};
+
+/* Primitive generator function prototypes to:
+ * build a plane from -1 to 1 in x and z facing +y, as a grid of subdivisions x subdivisions quads,
+ * build a unit box centered on the origin, each face a grid of subdivisions x subdivisions quads,
+ * build a closed cylinder of radius 1 from y = 0 to y = 1 around the y axis, with segments sides,
+ * build a sphere of diameter 1 centered on the origin, with segments meridians and rings parallels,
+ * build a torus around the y axis that fits the unit box, with segments around the ring and rings around the tube,
+ * and build the detail levels of a shape, finest first
+ */
+MeshData UGeneratePlane(unsigned subdivisions);
+MeshData UGenerateBox(unsigned subdivisions);
+MeshData UGenerateCylinder(unsigned segments);
+MeshData UGenerateSphere(unsigned segments, unsigned rings);
+MeshData UGenerateTorus(unsigned segments, unsigned rings);
+std::vector<MeshData> UGenerateLodChain(Primitive_Shape shape);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// A frame's draws as packed 64-bit sort keys plus a payload (the index of whatever is drawn).
+// Sorting the keys groups draws by program, then texture, then vertex array, and front to back within those,
+// so the submission loop only has to change state when a field of the key changes.
+//
+// Key layout, most significant bits first:
+//   63-56 program | 55-48 texture | 47-40 vertex array | 39-32 unused | 31-0 depth
+class RenderQueue
+{
+public:
+    struct Item
+    {
+        uint64_t key;
+        uint32_t payload;
+    };
+
+    static uint64_t MakeKey(uint32_t program, uint32_t texture, uint32_t vertexArray, float depth)
+    {
+        // Non-negative IEEE floats compare like their bit patterns, so the depth sorts as an integer
+        uint32_t depthBits = 0;
+        if (depth > 0.0f)
+            memcpy(&depthBits, &depth, sizeof(depthBits));
+
+        return ((uint64_t)(program & 0xFF) << 56) | ((uint64_t)(texture & 0xFF) << 48)
+            | ((uint64_t)(vertexArray & 0xFF) << 40) | depthBits;
+    }
+
+    static uint32_t Program(uint64_t key) { return (uint32_t)(key >> 56) & 0xFF; }
+    static uint32_t Texture(uint64_t key) { return (uint32_t)(key >> 48) & 0xFF; }
+    static uint32_t VertexArray(uint64_t key) { return (uint32_t)(key >> 40) & 0xFF; }
+
+    void Clear() { items.clear(); }
+    void Reserve(size_t count) { items.reserve(count); scratch.reserve(count); }
+
+    void Push(uint64_t key, uint32_t payload)
+    {
+        Item item = { key, payload };
+        items.push_back(item);
+    }
+
+    // LSD radix sort, one byte per pass. Passes where every key has the same byte are skipped,
+    // which is most of them: the state fields have few distinct values.
+    void Sort()
+    {
+        const size_t count = items.size();
+        if (count < 2)
+            return;
+
+        scratch.resize(count);
+        Item* source = items.data();
+        Item* destination = scratch.data();
+
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            size_t offsets[256] = {};
+            for (size_t i = 0; i < count; ++i)
+                ++offsets[(source[i].key >> shift) & 0xFF];
+
+            if (offsets[(source[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t total = 0;
+            for (size_t bucket = 0; bucket < 256; ++bucket)
+            {
+                size_t bucketCount = offsets[bucket];
+                offsets[bucket] = total;
+                total += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+
+            Item* swap = source;
+            source = destination;
+            destination = swap;
+        }
+
+        // An odd number of passes leaves the result in the scratch buffer
+        if (source != items.data())
+            items.swap(scratch);
+    }
+
+    const std::vector<Item>& Items() const { return items; }
+    size_t Size() const { return items.size(); }
+
+private:
+    std::vector<Item> items;
+    std::vector<Item> scratch;
+};
+
+#endif
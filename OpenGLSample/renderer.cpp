@@ -0,0 +1,2301 @@
+﻿#include <iostream>         // cout, cerr
+#include <cstdlib>          // EXIT_FAILURE
+#include <GL/glew.h>        // GLEW library
+#include <vector>
+#include <algorithm>        // min, max
+#include <cstddef>          // offsetof
+#include <cmath>            // floor, log2
+#include <cstring>          // strcmp, memcpy
+#include <limits>           // numeric_limits
+#include <functional>       // greater
+#include <utility>          // pair
+#include <memory>           // unique_ptr
+#include <chrono>           // steady_clock
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "stb_image.h"      // Image loading Utility functions
+#include "image.h"          // Row flipping
+
+#include "renderer.h"
+#include "uniform_table.h"  // Cached uniform locations
+#include "transform_store.h"    // Cached model matrices
+#include "render_queue.h"   // State-sorted draw submission
+#include "vertex_format.h"  // Packed vertices
+#include "primitives.h"     // Procedural meshes
+#include "mesh_optimizer.h" // Vertex cache optimization
+#include "frustum.h"        // View frustum culling
+#include "bvh.h"            // Bounding volume hierarchy over the instances
+#include "occlusion.h"      // Software depth rasterizer for occlusion culling
+#include "job_system.h"     // Worker threads for loading and transform updates
+#include "texture_loader.h" // Background texture decoding
+#include "pixel_buffer_ring.h"  // Persistently mapped upload buffers
+#include "texture_container.h"  // Baked textures
+#include "texture_compression.h"    // BC1 and BC3 encoding
+
+// S3TC formats, in case the GL headers leave out the extension's enums
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+using namespace std; // Standard namespace
+
+/*Shader program Macro*/
+#ifndef GLSL
+#define GLSL(Version, Source) "#version " #Version " core \n" #Source
+#endif
+
+// camera
+Camera gCamera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+// GL work submitted by the last URender call
+URenderStats gRenderStats;
+
+// Unnamed namespace
+namespace
+{
+    // The detail levels of every Scene_Mesh primitive, finest first, shared by every instance that uses it.
+    // All of them live in one pool: one vertex buffer, one index buffer and one vertex array.
+    GLMesh gMeshes[SCENE_MESH_COUNT][PRIMITIVE_MAX_LODS];
+    unsigned gMeshLodCounts[SCENE_MESH_COUNT];
+    MeshPool gMeshPool;
+
+    // Bounding sphere of each primitive in model space (center in xyz, radius in w), for picking detail levels,
+    // and its bounding box as center and half extent, for culling and picking instances
+    glm::vec4 gMeshSpheres[SCENE_MESH_COUNT];
+    glm::vec3 gMeshBoxCenters[SCENE_MESH_COUNT];
+    glm::vec3 gMeshBoxExtents[SCENE_MESH_COUNT];
+
+    // Vertex array number of the mesh pool in the render queue's sort keys; it is the only one
+    const uint32_t MESH_POOL_VERTEX_ARRAY = 0;
+
+    // Layout of the vertices in the pool, fixed when the scene is created, and the size of one vertex in bytes
+    UVertexFormat gVertexFormat = VERTEX_FORMAT_PACKED;
+    GLsizei gVertexSize = 0;
+
+    // Room for the built-in primitives and their detail levels before the pool has to grow
+    const GLuint MESH_POOL_VERTICES = 4096;
+    const GLuint MESH_POOL_INDICES = 16384;
+
+    // Multiplies the screen sizes at which coarser detail levels take over (PRIMITIVE_LOD_SCREEN_SIZES);
+    // 0 keeps every instance at its finest level
+    float gLodScale = 1.0f;
+
+    // Detail level every instance was drawn with last (or INSTANCE_CULLED when it was off screen),
+    // and whether the batches have to be rebuilt because one changed
+    const uint8_t INSTANCE_CULLED = 0xFF;
+    vector<uint8_t> gInstanceLods;
+    bool gDrawListDirty = true;
+
+    // World-space bounding sphere and box of every instance, refreshed when its transform changes, and whether
+    // it intersected the view frustum this frame. Culling can be turned off to measure what it saves.
+    BoundingSpheres gInstanceSpheres;
+    BoundingBoxes gInstanceBoxes;
+    vector<uint8_t> gInstanceVisible;
+    bool gCullingEnabled = true;
+
+    // Hierarchy over the instance boxes, built on the first frame and refitted to the instances that move.
+    // Culling, picking and nearby-instance queries traverse it instead of testing every instance.
+    Bvh gInstanceBvh;
+
+    // Occlusion culling: every frame the instances covering the most screen are drawn into a small CPU depth buffer,
+    // and the instances left after frustum culling are tested against it. Occluders use the finest level of their
+    // mesh, which is what the GPU draws up close, so they never cover more than the real object. The torus is
+    // never an occluder: its hole and thin tube hide little behind a large bounding sphere.
+    const bool MESH_OCCLUDES[SCENE_MESH_COUNT] = { true, true, true, true, false };
+    const size_t MAX_OCCLUDERS = 16;
+    const float OCCLUDER_MIN_SIZE = 0.05f;     // bounding sphere radius over distance
+    OccluderMesh gOccluderMeshes[SCENE_MESH_COUNT];
+    OcclusionBuffer gOcclusionBuffer;
+    bool gOcclusionEnabled = true;
+
+    // Scene loaded from the scene file, and its texture table packed into the layers of one array texture
+    SceneDescription gScene;
+    GLuint gTextureArray = 0;
+
+    // Width and height every texture is resampled to so they fit in the array's layers
+    const GLsizei TEXTURE_LAYER_SIZE = 1024;
+
+    // Model matrix of every instance, rebuilt only when the instance moves
+    TransformStore gTransforms;
+
+    // Shader programs, also numbered this way in the render queue's sort keys.
+    // The instanced variants fetch transform, UV scale and texture layer from a storage buffer through a
+    // per-instance id attribute; instanced draws and multi-draw indirect commands both use them.
+    enum Scene_Program {
+        PROGRAM_PHONG,
+        PROGRAM_LAMP,
+        PROGRAM_INSTANCED_PHONG,
+        PROGRAM_INSTANCED_LAMP,
+        PROGRAM_COUNT
+    };
+    GLuint gPrograms[PROGRAM_COUNT];
+
+    // How URender submits the scene; UCreateScene picks multi-draw indirect when the driver supports it
+    URenderPath gRenderPath = RENDER_PATH_INSTANCED;
+    bool gIndirectSupported = false;
+
+    // Textures as numbered in the sort keys: lamps sample nothing, everything else the array
+    enum Scene_Texture {
+        TEXTURE_NONE,
+        TEXTURE_ARRAY,
+    };
+
+    // This frame's draws, sorted by state before submission
+    RenderQueue gRenderQueue;
+
+    // Plain uniforms the render loop still sets, as indices into the location array below
+    enum Scene_Uniform {
+        UNIFORM_OBJECT_COLOR,
+        UNIFORM_TEXTURE,
+        UNIFORM_COUNT
+    };
+    const char* const UNIFORM_NAMES[UNIFORM_COUNT] = {
+        "objectColor", "uTexture"
+    };
+
+    // Reflection table of every program and the locations resolved from it once after linking
+    UniformTable gProgramUniforms[PROGRAM_COUNT];
+    GLint gUniformLocations[PROGRAM_COUNT][UNIFORM_COUNT];
+
+    // std140 mirror of the FrameData uniform block: camera and light, uploaded once per frame
+    struct FrameUniforms
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 lightColor;
+        glm::vec4 lightPos;
+        glm::vec4 viewPosition;
+    };
+
+    // std140 mirror of the ObjectData uniform block: one slot per drawn object
+    struct ObjectUniforms
+    {
+        glm::mat4 model;
+        glm::vec4 uvScale;      // uv scale in xy, texture layer in z, 1 in w for mirrored wrapping
+    };
+
+    // Uniform block binding points shared by the GLSL sources and the buffers
+    const GLuint FRAME_UNIFORM_BINDING = 0;
+    const GLuint OBJECT_UNIFORM_BINDING = 1;
+
+    GLuint gFrameUbo = 0;
+    GLuint gObjectUbo = 0;
+    GLsizeiptr gObjectSlotSize = 0;     // sizeof(ObjectUniforms) rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+    // CPU copy of the object buffer: one aligned slot per scene instance, uploaded in a single call per frame
+    vector<unsigned char> gObjectStaging;
+
+    // Per-instance data of the instanced programs (std430), one entry per scene instance in scene order
+    struct InstanceData
+    {
+        glm::mat4 model;
+        glm::vec4 data;         // same layout as ObjectUniforms::uvScale
+    };
+
+    // Attribute location of the instance id and binding point of the instance storage buffer, shared with the GLSL sources
+    const GLuint INSTANCE_ID_LOCATION = 3;
+    const GLuint INSTANCE_STORAGE_BINDING = 2;
+
+    // A run of instances with the same program, mesh and detail level, drawn with one instanced call whatever their textures
+    struct DrawBatch
+    {
+        uint32_t mesh;          // Scene_Mesh
+        uint32_t lod;           // detail level, 0 is the finest
+        bool lamp;              // drawn with the lamp program
+        uint32_t first;         // first entry in the instance id buffer (base instance)
+        uint32_t count;
+    };
+
+    // Batches a program, mesh and detail level can fall into: the size of the counting sort building them
+    const uint32_t DRAW_BATCH_KEYS = 2 * SCENE_MESH_COUNT * PRIMITIVE_MAX_LODS;
+
+    // Instance data, updated in place when an instance moves, and the ids of the instances laid out
+    // batch by batch, rebuilt when an instance changes detail level. The ids are a per-instance vertex attribute.
+    GLuint gInstanceBuffer = 0;
+    vector<InstanceData> gInstanceStaging;
+    GLuint gInstanceIdBuffer = 0;
+    vector<uint32_t> gInstanceIds;
+    vector<DrawBatch> gBatches;
+
+
+    // Layout of one command in the GL_DRAW_INDIRECT_BUFFER, as glMultiDrawElementsIndirect reads it
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    // One command per batch, and the run of commands each program submits with one call
+    struct IndirectRange
+    {
+        bool lamp;
+        GLuint first;
+        GLsizei count;
+        unsigned vertexBytes;   // vertex data the commands reference, for the render stats
+        unsigned triangles;
+    };
+    GLuint gIndirectBuffer = 0;
+    vector<IndirectRange> gIndirectRanges;
+
+    // Cube color
+    glm::vec3 gObjectColor(1.f, 1.0f, 1.0f);
+
+    // Worker threads that generate the meshes and rebuild moved transforms, created with the first scene (or the
+    // first UGetJobSystem) and kept for the next ones. The software renderer can share them rather than start its own.
+    unique_ptr<JobSystem> gJobs;
+
+    // The scene's textures are decoded in the background while frames are drawn. Until its image is uploaded,
+    // a layer is cleared to the placeholder color. URender uploads finished images for at most the budget
+    // each frame, and always at least one so loading finishes even when a single upload takes longer.
+    unique_ptr<TextureLoader> gTextureLoader;
+    bool gAsyncTextures = true;
+    double gTextureUploadBudgetMs = 2.0;
+    const GLfloat TEXTURE_PLACEHOLDER_COLOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+
+    // Images stay in file order after decoding; the copy into the array (resampling rows bottom to top, or a blit
+    // with its destination rows reversed) flips them for free. Set to flip the decoded pixels on the loader threads instead.
+    bool gFlipTexturesOnDecode = false;
+
+    // With buffer storage (GL 4.4), the loader threads resample each image to the layer size, build its mip chain and
+    // write them straight into a slot of a persistently mapped pixel unpack buffer. The GL thread then only issues
+    // glTexSubImage3D calls reading the slot, which the driver copies while the GPU keeps drawing, instead of
+    // creating, mipmapping and blitting a full-size texture. Eight slots, each one layer with its mips (5.3 MB),
+    // keep the decoders ahead of the uploads without mapping much memory. Declared after the loader, so at exit it is
+    // destroyed first and releases loader threads still waiting for a slot.
+    const unsigned PIXEL_BUFFER_SLOTS = 8;
+    bool gPixelBufferUploads = true;
+    unique_ptr<PixelBufferRing> gPixelBuffers;
+
+    // texture_baker stores each texture of the shipped scenes already resampled to the layer size, with its mip chain,
+    // in a container under BAKED_TEXTURE_DIR. The loader threads copy a current bake out of the mapped file instead of
+    // decoding and resampling the image; textures without one, or whose source changed since, are decoded as before.
+    bool gBakedTextures = true;
+
+    // Set once a layer has been blitted without its mips, which are then generated after the last image is in
+    bool gGenerateMipmaps = false;
+
+    // Format of the array's layers. The block formats take a quarter (BC3) or an eighth (BC1) of RGBA8's memory and
+    // sampling bandwidth; their layers come from bakes in that format, or are compressed on the loader threads from
+    // the RGBA8 bakes or the decoded images. They need S3TC; without it the array stays RGBA8.
+    Texture_Format gTextureFormat = TEXTURE_FORMAT_RGBA8;
+    Texture_Format gArrayFormat = TEXTURE_FORMAT_RGBA8;
+    chrono::steady_clock::time_point gSceneCreateStart;
+    TextureLoadStats gTextureLoadStats;
+}
+
+
+/* Internal function prototypes to:
+ * create the uniform buffers, upload the per-frame and per-object blocks,
+ * create the instance buffers, upload the instance data, pick every instance's detail level
+ * and build the batches and indirect commands from them,
+ * and draw a mesh once or instanced
+ */
+bool UCreateTextureArray();
+bool UUploadReadyTextures(double budgetMs);
+bool UWaitForTextures();
+void UStopTextureLoading();
+bool UDecodeIntoPixelBuffer(const string& texturePath, bool flipRows, bool baked, Texture_Format format, PixelBufferRing& ring, DecodedImage& image);
+bool ULoadTextureImage(const string& texturePath, bool flipRows, bool baked, Texture_Format format, DecodedImage& image);
+bool ULoadMipChain(const string& texturePath, bool baked, Texture_Format format, unsigned char* levels, DecodedImage& image);
+void UUploadMipChain(GLuint buffer, const void* levels, GLsizei size, GLint layer);
+void UClearCompressedLayers(GLsizei layers, GLsizei mipLevels);
+GLenum UTextureInternalFormat(Texture_Format format);
+void UCopyToLayer(const DecodedImage& image, GLint layer);
+void UCreateUniformBuffers();
+void UUploadFrameUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition);
+void UUploadObjectUniforms();
+void UCreateInstanceBuffer();
+glm::vec4 UTextureParameters(const SceneInstance& instance);
+void UUploadInstanceData();
+void UUpdateInstanceBounds();
+void UCullInstances(const glm::mat4& viewProjection);
+void UCullOccludedInstances(const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+void UAssignLevelsOfDetail(const glm::mat4& projection, const glm::vec3& cameraPosition);
+void UBuildDrawList();
+bool UHasExtension(const char* name);
+void UCreateIndirectCommands();
+void UUpdateIndirectCommands();
+void UQueueIndirect();
+void UQueueInstanced();
+void UQueueIndividually(const glm::mat4& view);
+void USubmitRenderQueue();
+glm::vec4 UComputeBoundingSphere(const std::vector<float>& vertices);
+void UComputeBoundingBox(const std::vector<float>& vertices, glm::vec3& center, glm::vec3& extent);
+void UAllocateMesh(GLMesh& mesh, const GLfloat* verts, GLuint nVertices, const GLuint* indices, GLuint nIndices, const VertexBounds& bounds);
+vector<MeshData> UGeneratePrimitiveLevels(Scene_Mesh mesh);
+bool UDecodeImage(const char* filename, bool flipRows, DecodedImage& image);
+bool UCreateTexture(const DecodedImage& image, GLuint& textureId);
+std::string UWithPrelude(const char* source, const char* prelude);
+void UDrawMesh(const GLMesh& mesh);
+void UDrawMeshInstanced(const GLMesh& mesh, GLuint first, GLsizei count);
+
+
+/* Vertex Shader Source Code*/
+const GLchar* vertexShaderSource = GLSL(440,
+    layout(location = 0) in vec3 position;
+    layout(location = 1) in vec3 normal; // VAP position 1 for normals
+    layout(location = 2) in vec2 textureCoordinate;
+
+    out vec3 vertexNormal; // For outgoing normals to fragment shader
+    out vec3 vertexFragmentPos; // For outgoing color / pixels to fragment shader
+    out vec2 vertexTextureCoordinate;
+
+    // Camera and light data shared by every object, uploaded once per frame (std140)
+    layout(std140, binding = 0) uniform FrameData
+    {
+        mat4 view;
+        mat4 projection;
+        vec4 lightColor;
+        vec4 lightPos;
+        vec4 viewPosition;
+    };
+
+    // Per-object transform and UV scale, one slot of the object buffer per draw (std140)
+    layout(std140, binding = 1) uniform ObjectData
+    {
+        mat4 model;
+        vec4 uvScale;
+    };
+
+    void main()
+    {
+        gl_Position = projection * view * model * vec4(position, 1.0f); // transforms vertices to clip coordinates
+        vertexFragmentPos = vec3(model * vec4(position, 1.0f)); // Gets fragment / pixel position in world space only (exclude view and projection)
+        vertexNormal = mat3(transpose(inverse(model))) * decodeNormal(normal); // get normal vectors in world space only and exclude normal translation properties
+        vertexTextureCoordinate = textureCoordinate;
+    }
+);
+
+
+/* Instanced Vertex Shader Source Code: the same transform, with the per-object data fetched from the instance storage buffer*/
+const GLchar* instancedVertexShaderSource = GLSL(440,
+    layout(location = 0) in vec3 position;
+    layout(location = 1) in vec3 normal; // VAP position 1 for normals
+    layout(location = 2) in vec2 textureCoordinate;
+    layout(location = 3) in uint instanceId; // Per-instance index into the instance buffer, advanced from the draw's base instance
+
+    out vec3 vertexNormal;
+    out vec3 vertexFragmentPos;
+    out vec2 vertexTextureCoordinate;
+    out vec2 vertexUVScale;
+    flat out vec2 vertexTextureLayer; // Layer and mirrored flag, constant across the triangle
+
+    layout(std140, binding = 0) uniform FrameData
+    {
+        mat4 view;
+        mat4 projection;
+        vec4 lightColor;
+        vec4 lightPos;
+        vec4 viewPosition;
+    };
+
+    // Model matrix, then uv scale (xy), texture layer (z) and mirrored flag (w), one entry per scene instance
+    struct InstanceData
+    {
+        mat4 model;
+        vec4 data;
+    };
+
+    layout(std430, binding = 2) readonly buffer InstanceBuffer
+    {
+        InstanceData instances[];
+    };
+
+    void main()
+    {
+        InstanceData instance = instances[instanceId];
+
+        gl_Position = projection * view * instance.model * vec4(position, 1.0f);
+        vertexFragmentPos = vec3(instance.model * vec4(position, 1.0f));
+        vertexNormal = mat3(transpose(inverse(instance.model))) * decodeNormal(normal);
+        vertexTextureCoordinate = textureCoordinate;
+        vertexUVScale = instance.data.xy;
+        vertexTextureLayer = instance.data.zw;
+    }
+);
+
+
+/* Fragment Shader Source Code*/
+const GLchar* fragmentShaderSource = GLSL(440,
+    in vec3 vertexNormal; // For incoming normals
+    in vec3 vertexFragmentPos; // For incoming fragment position
+    in vec2 vertexTextureCoordinate;
+
+    out vec4 fragmentColor; // For outgoing cube color to the GPU
+
+    // Light color, light position, and camera/view position (same blocks as the vertex shader)
+    layout(std140, binding = 0) uniform FrameData
+    {
+        mat4 view;
+        mat4 projection;
+        vec4 lightColor;
+        vec4 lightPos;
+        vec4 viewPosition;
+    };
+
+    layout(std140, binding = 1) uniform ObjectData
+    {
+        mat4 model;
+        vec4 uvScale;
+    };
+
+    // Uniform / Global variables for object color and texture
+    uniform vec3 objectColor;
+    uniform sampler2DArray uTexture; // Every scene texture, one per layer
+
+    // GL_MIRRORED_REPEAT done in the shader, since all layers share the array's wrap mode
+    vec2 mirroredRepeat(vec2 uv)
+    {
+        return 1.0 - abs(mod(uv, 2.0) - 1.0);
+    }
+
+    void main()
+    {
+        /*Phong lighting model calculations to generate ambient, diffuse, and specular components*/
+
+        //Calculate Ambient lighting*/
+        float ambientStrength = 0.22f; // Set ambient or global lighting strength
+        vec3 ambient = ambientStrength * lightColor.rgb; // Generate ambient light color
+
+        //Calculate Diffuse lighting*/
+        vec3 norm = normalize(vertexNormal); // Normalize vectors to 1 unit
+        vec3 lightDirection = normalize(lightPos.xyz - vertexFragmentPos); // Calculate distance (light direction) between light source and fragments/pixels on cube
+        float impact = max(dot(norm, lightDirection), 0.0);// Calculate diffuse impact by generating dot product of normal and light
+        vec3 diffuse = impact * lightColor.rgb; // Generate diffuse light color
+
+        //Calculate Specular lighting*/
+        float specularIntensity = 0.9f; // Set specular light strength
+        float highlightSize = 16.0f; // Set specular highlight size
+        vec3 viewDir = normalize(viewPosition.xyz - vertexFragmentPos); // Calculate view direction
+        vec3 reflectDir = reflect(-lightDirection, norm);// Calculate reflection vector
+        //Calculate specular component
+        float specularComponent = pow(max(dot(viewDir, reflectDir), 0.0), highlightSize);
+        vec3 specular = specularIntensity * specularComponent * lightColor.rgb;
+
+        // Texture holds the color to be used for all three components
+        // Mirrored layers fold the coordinates; the gradients of the unfolded ones keep the mip selection continuous
+        vec2 uv = vertexTextureCoordinate * uvScale.xy;
+        vec2 wrappedUV = uvScale.w > 0.5 ? mirroredRepeat(uv) : uv;
+        vec4 textureColor = textureGrad(uTexture, vec3(wrappedUV, uvScale.z), dFdx(uv), dFdy(uv));
+
+        // Calculate phong result
+        vec3 phong = (ambient + diffuse + specular) * textureColor.xyz;
+
+        fragmentColor = vec4(phong, 1.0); // Send lighting results to GPU
+    }
+);
+
+
+/* Instanced Fragment Shader Source Code: the same Phong model, with the uv scale passed on by the vertex shader*/
+const GLchar* instancedFragmentShaderSource = GLSL(440,
+    in vec3 vertexNormal; // For incoming normals
+    in vec3 vertexFragmentPos; // For incoming fragment position
+    in vec2 vertexTextureCoordinate;
+    in vec2 vertexUVScale; // Per-instance uv scale
+    flat in vec2 vertexTextureLayer; // Per-instance texture layer and mirrored flag
+
+    out vec4 fragmentColor; // For outgoing cube color to the GPU
+
+    // Light color, light position, and camera/view position (same block as the vertex shader)
+    layout(std140, binding = 0) uniform FrameData
+    {
+        mat4 view;
+        mat4 projection;
+        vec4 lightColor;
+        vec4 lightPos;
+        vec4 viewPosition;
+    };
+
+    // Uniform / Global variables for object color and texture
+    uniform vec3 objectColor;
+    uniform sampler2DArray uTexture; // Every scene texture, one per layer
+
+    // GL_MIRRORED_REPEAT done in the shader, since all layers share the array's wrap mode
+    vec2 mirroredRepeat(vec2 uv)
+    {
+        return 1.0 - abs(mod(uv, 2.0) - 1.0);
+    }
+
+    void main()
+    {
+        /*Phong lighting model calculations to generate ambient, diffuse, and specular components*/
+
+        //Calculate Ambient lighting*/
+        float ambientStrength = 0.22f; // Set ambient or global lighting strength
+        vec3 ambient = ambientStrength * lightColor.rgb; // Generate ambient light color
+
+        //Calculate Diffuse lighting*/
+        vec3 norm = normalize(vertexNormal); // Normalize vectors to 1 unit
+        vec3 lightDirection = normalize(lightPos.xyz - vertexFragmentPos); // Calculate distance (light direction) between light source and fragments/pixels on cube
+        float impact = max(dot(norm, lightDirection), 0.0);// Calculate diffuse impact by generating dot product of normal and light
+        vec3 diffuse = impact * lightColor.rgb; // Generate diffuse light color
+
+        //Calculate Specular lighting*/
+        float specularIntensity = 0.9f; // Set specular light strength
+        float highlightSize = 16.0f; // Set specular highlight size
+        vec3 viewDir = normalize(viewPosition.xyz - vertexFragmentPos); // Calculate view direction
+        vec3 reflectDir = reflect(-lightDirection, norm);// Calculate reflection vector
+        //Calculate specular component
+        float specularComponent = pow(max(dot(viewDir, reflectDir), 0.0), highlightSize);
+        vec3 specular = specularIntensity * specularComponent * lightColor.rgb;
+
+        // Texture holds the color to be used for all three components
+        // Mirrored layers fold the coordinates; the gradients of the unfolded ones keep the mip selection continuous
+        vec2 uv = vertexTextureCoordinate * vertexUVScale;
+        vec2 wrappedUV = vertexTextureLayer.y > 0.5 ? mirroredRepeat(uv) : uv;
+        vec4 textureColor = textureGrad(uTexture, vec3(wrappedUV, vertexTextureLayer.x), dFdx(uv), dFdy(uv));
+
+        // Calculate phong result
+        vec3 phong = (ambient + diffuse + specular) * textureColor.xyz;
+
+        fragmentColor = vec4(phong, 1.0); // Send lighting results to GPU
+    }
+);
+
+
+/* Lamp Shader Source Code*/
+const GLchar* lampVertexShaderSource = GLSL(440,
+
+    layout(location = 0) in vec3 position; // VAP position 0 for vertex position data
+
+//Uniform blocks shared with the cube shader for the transform matrices
+layout(std140, binding = 0) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 lightColor;
+    vec4 lightPos;
+    vec4 viewPosition;
+};
+
+layout(std140, binding = 1) uniform ObjectData
+{
+    mat4 model;
+    vec4 uvScale;
+};
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(position, 1.0f); // Transforms vertices into clip coordinates
+}
+);
+
+
+/* Instanced Lamp Shader Source Code*/
+const GLchar* instancedLampVertexShaderSource = GLSL(440,
+
+    layout(location = 0) in vec3 position; // VAP position 0 for vertex position data
+    layout(location = 3) in uint instanceId; // Per-instance index into the instance buffer
+
+layout(std140, binding = 0) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 lightColor;
+    vec4 lightPos;
+    vec4 viewPosition;
+};
+
+struct InstanceData
+{
+    mat4 model;
+    vec4 data;
+};
+
+layout(std430, binding = 2) readonly buffer InstanceBuffer
+{
+    InstanceData instances[];
+};
+
+void main()
+{
+    gl_Position = projection * view * instances[instanceId].model * vec4(position, 1.0f); // Transforms vertices into clip coordinates
+}
+);
+
+
+/* Normal decoding inserted into every vertex shader: float normals are used as they are*/
+const GLchar* floatNormalShaderSource =
+    "vec3 decodeNormal(vec3 normal)\n"
+    "{\n"
+    "    return normal;\n"
+    "}\n";
+
+
+/* Fragment Shader Source Code*/
+const GLchar* lampFragmentShaderSource = GLSL(440,
+
+    out vec4 fragmentColor; // For outgoing lamp color (smaller cube) to the GPU
+
+void main()
+{
+    fragmentColor = vec4(1.0f); // Set color to white (1.0f,1.0f,1.0f) with alpha 1.0
+}
+);
+
+// Loads the scene file, then creates the meshes, shader programs and textures it uses
+bool UCreateScene(const string& sceneFile)
+{
+    gSceneCreateStart = chrono::steady_clock::now();
+
+    // Load the object placements and texture table
+    if (!ULoadScene(sceneFile, gScene))
+        return false;
+
+    // One transform per instance, all dirty until the first frame builds their matrices
+    gTransforms.Clear();
+    gTransforms.Reserve(gScene.instances.size());
+    for (const SceneInstance& instance : gScene.instances)
+        gTransforms.Add(instance.position, instance.rotation, instance.scale);
+
+    UGetJobSystem();
+
+    // Create the mesh
+    UCreateAllMeshes();         // Calls the function to create the Vertex Buffer Object
+
+    // Create the shader program
+    const GLchar* const programSources[PROGRAM_COUNT][2] = {
+        { vertexShaderSource, fragmentShaderSource },
+        { lampVertexShaderSource, lampFragmentShaderSource },
+        { instancedVertexShaderSource, instancedFragmentShaderSource },
+        { instancedLampVertexShaderSource, lampFragmentShaderSource },
+    };
+
+    // Indirect commands are drawn with the instanced programs: their base instance offsets the instance id attribute
+    gIndirectSupported = UHasExtension("GL_ARB_multi_draw_indirect");
+
+    for (int program = 0; program < PROGRAM_COUNT; ++program)
+    {
+        // The vertex shaders get the decodeNormal function matching the vertex format
+        const string vertexSource = UWithPrelude(programSources[program][0],
+            gVertexFormat == VERTEX_FORMAT_PACKED ? PACKED_NORMAL_GLSL : floatNormalShaderSource);
+        if (!UCreateShaderProgram(vertexSource.c_str(), programSources[program][1], gPrograms[program]))
+            return false;
+
+        // Look up every uniform location once instead of by name on every draw
+        gProgramUniforms[program].Build(gPrograms[program]);
+        gProgramUniforms[program].Resolve(UNIFORM_NAMES, UNIFORM_COUNT, gUniformLocations[program]);
+    }
+
+    // Buffers behind the FrameData and ObjectData uniform blocks
+    UCreateUniformBuffers();
+
+    // Instance data and instance id buffers; the batches are built on the first frame, once the detail levels are known
+    UCreateInstanceBuffer();
+
+    // Command buffer for multi-draw indirect submission
+    if (gIndirectSupported)
+    {
+        UCreateIndirectCommands();
+        gRenderPath = RENDER_PATH_INDIRECT;
+    }
+    else
+    {
+        cout << "INFO: Multi-draw indirect is not supported, drawing with instancing" << endl;
+        gRenderPath = RENDER_PATH_INSTANCED;
+    }
+
+    // Load the textures listed by the scene into one array texture
+    if (!UCreateTextureArray())
+        return false;
+
+    // tell opengl for each sampler to which texture unit it belongs to (only has to be done once),
+    // and set the object color, which never changes either. Programs without these uniforms skip them.
+    for (int program = 0; program < PROGRAM_COUNT; ++program)
+    {
+        glUseProgram(gPrograms[program]);
+        // We set the texture as texture unit 0
+        if (gUniformLocations[program][UNIFORM_TEXTURE] >= 0)
+            glUniform1i(gUniformLocations[program][UNIFORM_TEXTURE], 0);
+        if (gUniformLocations[program][UNIFORM_OBJECT_COLOR] >= 0)
+            glUniform3f(gUniformLocations[program][UNIFORM_OBJECT_COLOR], gObjectColor.r, gObjectColor.g, gObjectColor.b);
+    }
+    glUseProgram(0);
+
+    // Sets the background color of the window to black (it will be implicitely used by glClear)
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    return true;
+}
+
+
+// Releases everything UCreateScene created
+void UDestroyScene()
+{
+    // Release mesh data
+    for (uint32_t mesh = 0; mesh < SCENE_MESH_COUNT; ++mesh)
+    {
+        for (uint32_t level = 0; level < gMeshLodCounts[mesh]; ++level)
+            UDestroyMesh(gMeshes[mesh][level]);
+        gMeshLodCounts[mesh] = 0;
+    }
+    gMeshPool.Destroy();
+
+    // Release texture, dropping the images still being decoded
+    UStopTextureLoading();
+    UDestroyTexture(gTextureArray);
+    gTextureArray = 0;
+
+    // Release shader program
+    for (GLuint& program : gPrograms)
+    {
+        if (program != 0)
+            UDestroyShaderProgram(program);
+        program = 0;
+    }
+
+    // Release uniform buffers
+    glDeleteBuffers(1, &gFrameUbo);
+    glDeleteBuffers(1, &gObjectUbo);
+    gFrameUbo = 0;
+    gObjectUbo = 0;
+    gObjectStaging.clear();
+
+    // Release the instance buffers
+    glDeleteBuffers(1, &gInstanceBuffer);
+    glDeleteBuffers(1, &gInstanceIdBuffer);
+    gInstanceBuffer = 0;
+    gInstanceIdBuffer = 0;
+    gInstanceStaging.clear();
+    gInstanceIds.clear();
+    gInstanceLods.clear();
+    gInstanceSpheres.Resize(0);
+    gInstanceBoxes.Resize(0);
+    gInstanceVisible.clear();
+    gInstanceBvh = Bvh();
+    gBatches.clear();
+    gTransforms.Clear();
+    gRenderQueue.Clear();
+
+    // Release the indirect commands
+    glDeleteBuffers(1, &gIndirectBuffer);
+    gIndirectBuffer = 0;
+    gIndirectRanges.clear();
+}
+
+
+// The scene loaded by UCreateScene
+const SceneDescription& UGetScene()
+{
+    return gScene;
+}
+
+
+// Transforms of the scene's instances, in scene order; moving one re-uploads only its matrix
+TransformStore& UGetTransforms()
+{
+    return gTransforms;
+}
+
+
+// The renderer's worker threads, one per hardware thread; started here if no scene has been created yet
+JobSystem& UGetJobSystem()
+{
+    if (!gJobs)
+        gJobs.reset(new JobSystem());
+    return *gJobs;
+}
+
+
+// Switches how the scene is submitted; fails if the driver lacks what the path needs
+bool USetRenderPath(URenderPath path)
+{
+    if (path == RENDER_PATH_INDIRECT && !gIndirectSupported)
+        return false;
+
+    // The per-object path keeps its own copy of the matrices: refresh the one taking over
+    if (path != gRenderPath)
+        gTransforms.Invalidate();
+    gRenderPath = path;
+    return true;
+}
+
+
+// Path URender currently uses
+URenderPath UGetRenderPath()
+{
+    return gRenderPath;
+}
+
+
+// Picks the vertex layout of the meshes; takes effect at the next UCreateScene
+void USetVertexFormat(UVertexFormat format)
+{
+    gVertexFormat = format;
+}
+
+
+// Layout of the current scene's meshes
+UVertexFormat UGetVertexFormat()
+{
+    return gVertexFormat;
+}
+
+
+// Size of one vertex of the current scene's meshes in bytes
+unsigned UGetVertexSize()
+{
+    return (unsigned)gVertexSize;
+}
+
+
+// Scales the screen sizes at which instances switch to coarser detail levels: 2 switches at twice the size,
+// 0 keeps every instance at its finest level
+void USetLodScale(float scale)
+{
+    gLodScale = max(scale, 0.0f);
+}
+
+
+// Current detail level scale
+float UGetLodScale()
+{
+    return gLodScale;
+}
+
+
+// Turns view frustum culling on or off; off draws every instance, occlusion culling included
+void USetCulling(bool enabled)
+{
+    gCullingEnabled = enabled;
+}
+
+
+// Whether instances outside the view frustum are skipped
+bool UGetCulling()
+{
+    return gCullingEnabled;
+}
+
+
+// Turns occlusion culling on or off; frustum culling stays as set by USetCulling
+void USetOcclusionCulling(bool enabled)
+{
+    gOcclusionEnabled = enabled;
+}
+
+
+// Whether instances hidden behind the largest objects on screen are skipped
+bool UGetOcclusionCulling()
+{
+    return gOcclusionEnabled && gCullingEnabled;
+}
+
+
+// CPU depth buffer the last frame's occluders were drawn into
+const OcclusionBuffer& UGetOcclusionBuffer()
+{
+    return gOcclusionBuffer;
+}
+
+
+// Chooses whether the next UCreateScene returns before its textures are loaded (the default) or waits for all of them
+void USetAsyncTextureLoading(bool enabled)
+{
+    gAsyncTextures = enabled;
+}
+
+
+bool UGetAsyncTextureLoading()
+{
+    return gAsyncTextures;
+}
+
+
+// Chooses whether the next UCreateScene flips its images on the CPU after decoding them or while copying them into the array
+void USetFlipTexturesOnDecode(bool enabled)
+{
+    gFlipTexturesOnDecode = enabled;
+}
+
+
+bool UGetFlipTexturesOnDecode()
+{
+    return gFlipTexturesOnDecode;
+}
+
+
+// Chooses whether the next UCreateScene streams its textures through persistently mapped pixel buffers (the default,
+// where supported) or uploads each one as a temporary texture blitted into the array
+void USetPixelBufferUploads(bool enabled)
+{
+    gPixelBufferUploads = enabled;
+}
+
+
+// Whether the current scene's textures go through pixel buffers
+bool UGetPixelBufferUploads()
+{
+    return gPixelBuffers != nullptr;
+}
+
+
+// Chooses whether the next UCreateScene reads the textures texture_baker prepared (the default, where current)
+// or decodes every image file
+void USetBakedTextures(bool enabled)
+{
+    gBakedTextures = enabled;
+}
+
+
+bool UGetBakedTextures()
+{
+    return gBakedTextures;
+}
+
+
+// Chooses the format of the next UCreateScene's texture array: RGBA8 (the default), or BC1 or BC3 where supported
+void USetTextureFormat(Texture_Format format)
+{
+    gTextureFormat = format;
+}
+
+
+// Format of the current scene's texture array
+Texture_Format UGetTextureFormat()
+{
+    return gArrayFormat;
+}
+
+
+// Time URender may spend uploading decoded textures each frame; one is uploaded per frame whatever the budget
+void USetTextureUploadBudget(double milliseconds)
+{
+    gTextureUploadBudgetMs = max(milliseconds, 0.0);
+}
+
+
+// True while some of the scene's textures still show the placeholder
+bool UTexturesLoading()
+{
+    return gTextureLoader && !gTextureLoader->Done();
+}
+
+
+// Waits for the remaining decodes and uploads them all, e.g. before taking a screenshot
+void UFinishTextureLoading()
+{
+    UWaitForTextures();
+}
+
+
+// Decode times and readiness of the scene's textures
+const TextureLoadStats& UGetTextureLoadStats()
+{
+    return gTextureLoadStats;
+}
+
+
+// Finds the nearest instance whose bounding box the ray from origin along direction enters, through the
+// instance hierarchy. Uses the bounds of the last rendered frame; false when nothing is hit.
+bool UPickInstance(const glm::vec3& origin, const glm::vec3& direction, uint32_t& instance)
+{
+    float distance;
+    instance = URaycastBvh(gInstanceBvh, gInstanceBoxes, origin, direction, distance);
+    return instance != BVH_NO_OBJECT;
+}
+
+
+// Appends the instances whose bounding box is within radius of center, e.g. the ones a light reaches
+void UQueryInstancesInSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& instances)
+{
+    UQueryBvhSphere(gInstanceBvh, gInstanceBoxes, center, radius, instances);
+}
+
+
+// Functioned called to render a frame
+void URender(bool& isPerspectiveView)
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    const glm::vec3 cameraPosition = gCamera.Position;;
+
+    // Start counting this frame's GL work
+    gRenderStats = URenderStats();
+
+    // Move the textures decoded since the last frame into their layers
+    if (gTextureLoader && !gTextureLoader->Done())
+        UUploadReadyTextures(gTextureUploadBudgetMs);
+
+    // Enable z-depth
+    glEnable(GL_DEPTH_TEST);
+
+    // Clear the frame and z buffers
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // This section renders the camera object.
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // Transforms the camera: move the camera back (z axis) and upwards (y axis)
+    view = gCamera.GetViewMatrix();
+    // Creates a perspective projection. Allows the user to switch between perspective and ortho views
+    if (isPerspectiveView) {
+        projection = glm::perspective(glm::radians(gCamera.Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+    }
+    else {
+        projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f);
+    }
+
+    // Camera and light data are the same for every object: upload them once per frame
+    UUploadFrameUniforms(view, projection, cameraPosition);
+
+    // Matrices of the instances that moved since the last frame, in one upload
+    if (gRenderPath == RENDER_PATH_INDIVIDUAL)
+        UUploadObjectUniforms();
+    else
+        UUploadInstanceData();
+
+    // Skip the instances outside the view frustum or hidden behind large objects, then pick the detail level
+    // of the others from their size on screen
+    UUpdateInstanceBounds();
+    UCullInstances(projection * view);
+    UCullOccludedInstances(projection * view, cameraPosition);
+    UAssignLevelsOfDetail(projection, cameraPosition);
+
+    // Build this frame's draws, sort them by state and submit them
+    gRenderQueue.Clear();
+    if (gRenderPath == RENDER_PATH_INDIRECT)
+        UQueueIndirect();
+    else if (gRenderPath == RENDER_PATH_INSTANCED)
+        UQueueInstanced();
+    else
+        UQueueIndividually(view);
+
+    gRenderQueue.Sort();
+    USubmitRenderQueue();
+
+    // Deactivate the Vertex Array Object and shader program
+    glBindVertexArray(0);
+    gRenderStats.vertexArrayBinds++;
+    glUseProgram(0);
+    gRenderStats.programBinds++;
+
+}
+
+
+// Queues one multi-draw per program: the whole textured scene is one call, the lamps another,
+// however many objects there are. The commands are rebuilt with the batches when a detail level changes.
+void UQueueIndirect()
+{
+    if (gDrawListDirty)
+        UBuildDrawList();
+
+    for (uint32_t i = 0; i < gIndirectRanges.size(); ++i)
+    {
+        const IndirectRange& range = gIndirectRanges[i];
+        const uint32_t program = range.lamp ? PROGRAM_INSTANCED_LAMP : PROGRAM_INSTANCED_PHONG;
+        const uint32_t texture = range.lamp ? TEXTURE_NONE : TEXTURE_ARRAY;
+        gRenderQueue.Push(RenderQueue::MakeKey(program, texture, MESH_POOL_VERTEX_ARRAY, 0.0f), i);
+    }
+}
+
+
+// Queues one instanced draw per batch: N instances of a mesh cost one draw, whatever their textures.
+// Batches cover the whole scene, so they have no meaningful depth, and all meshes share the pool's vertex array.
+void UQueueInstanced()
+{
+    if (gDrawListDirty)
+        UBuildDrawList();
+
+    for (uint32_t i = 0; i < gBatches.size(); ++i)
+    {
+        const DrawBatch& batch = gBatches[i];
+        const uint32_t program = batch.lamp ? PROGRAM_INSTANCED_LAMP : PROGRAM_INSTANCED_PHONG;
+        const uint32_t texture = batch.lamp ? TEXTURE_NONE : TEXTURE_ARRAY;
+        gRenderQueue.Push(RenderQueue::MakeKey(program, texture, MESH_POOL_VERTEX_ARRAY, 0.0f), i);
+    }
+}
+
+
+// Queues one draw per visible instance, reading its data from the ObjectData block, sorted front to back within each state.
+// Textured instances use the Phong program, untextured ones are lamps.
+void UQueueIndividually(const glm::mat4& view)
+{
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        if (gInstanceLods[i] == INSTANCE_CULLED)
+            continue;
+
+        const SceneInstance& instance = gScene.instances[i];
+        const bool lamp = instance.texture == SCENE_NO_TEXTURE;
+        const uint32_t program = lamp ? PROGRAM_LAMP : PROGRAM_PHONG;
+        const uint32_t texture = lamp ? TEXTURE_NONE : TEXTURE_ARRAY;
+
+        // Distance along the view direction of the instance's origin
+        const glm::vec4 viewPosition = view * glm::vec4(gTransforms.Position(i), 1.0f);
+        gRenderQueue.Push(RenderQueue::MakeKey(program, texture, MESH_POOL_VERTEX_ARRAY, -viewPosition.z), i);
+    }
+}
+
+
+// Draws the sorted queue, binding a program, texture or vertex array only when it differs from the current one
+void USubmitRenderQueue()
+{
+    if (gRenderPath == RENDER_PATH_INDIRECT)
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, gIndirectBuffer);
+        gRenderStats.bufferBinds++;
+    }
+
+    // Nothing is bound at the start of a frame: URender unbinds everything at the end of the previous one
+    uint32_t currentProgram = PROGRAM_COUNT;
+    uint32_t currentTexture = TEXTURE_NONE;
+    uint32_t currentVertexArray = MESH_POOL_VERTEX_ARRAY + 1;
+
+    for (const RenderQueue::Item& item : gRenderQueue.Items())
+    {
+        const uint32_t program = RenderQueue::Program(item.key);
+        const uint32_t texture = RenderQueue::Texture(item.key);
+        const uint32_t vertexArray = RenderQueue::VertexArray(item.key);
+
+        if (program != currentProgram)
+        {
+            glUseProgram(gPrograms[program]);
+            gRenderStats.programBinds++;
+            currentProgram = program;
+        }
+        else
+            gRenderStats.avoidedBinds++;
+
+        // Every object samples its layer of the same array texture on unit 0; lamps leave it bound
+        if (texture != TEXTURE_NONE)
+        {
+            if (texture != currentTexture)
+            {
+                glBindTexture(GL_TEXTURE_2D_ARRAY, gTextureArray);
+                gRenderStats.textureBinds++;
+                currentTexture = texture;
+            }
+            else
+                gRenderStats.avoidedBinds++;
+        }
+
+        if (vertexArray != currentVertexArray)
+        {
+            glBindVertexArray(gMeshPool.VertexArray());
+            gRenderStats.vertexArrayBinds++;
+            currentVertexArray = vertexArray;
+        }
+        else
+            gRenderStats.avoidedBinds++;
+
+        if (gRenderPath == RENDER_PATH_INDIRECT)
+        {
+            const IndirectRange& range = gIndirectRanges[item.payload];
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(range.first * sizeof(DrawElementsIndirectCommand)), range.count, 0);
+            gRenderStats.drawCalls++;
+            gRenderStats.vertexBytes += range.vertexBytes;
+            gRenderStats.triangles += range.triangles;
+        }
+        else if (gRenderPath == RENDER_PATH_INSTANCED)
+        {
+            const DrawBatch& batch = gBatches[item.payload];
+            UDrawMeshInstanced(gMeshes[batch.mesh][batch.lod], batch.first, batch.count);
+        }
+        else
+        {
+            // Point the ObjectData block at this instance's slot
+            glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_UNIFORM_BINDING, gObjectUbo, item.payload * gObjectSlotSize, sizeof(ObjectUniforms));
+            gRenderStats.bufferBinds++;
+            UDrawMesh(gMeshes[gScene.instances[item.payload].mesh][gInstanceLods[item.payload]]);
+        }
+    }
+}
+
+
+// Draws a mesh from the bound mesh pool vertex array
+void UDrawMesh(const GLMesh& mesh)
+{
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.nIndices, GL_UNSIGNED_INT, mesh.IndexOffset(), mesh.baseVertex);
+    gRenderStats.drawCalls++;
+    gRenderStats.vertexBytes += mesh.nIndices * gVertexSize;
+    gRenderStats.triangles += mesh.nIndices / 3;
+}
+
+
+// Draws count instances of a mesh from the bound mesh pool vertex array, reading instance ids from entry first onwards
+void UDrawMeshInstanced(const GLMesh& mesh, GLuint first, GLsizei count)
+{
+    glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, mesh.nIndices, GL_UNSIGNED_INT, mesh.IndexOffset(), count, mesh.baseVertex, first);
+    gRenderStats.drawCalls++;
+    gRenderStats.vertexBytes += mesh.nIndices * count * gVertexSize;
+    gRenderStats.triangles += mesh.nIndices / 3 * count;
+}
+
+
+// Creates the GL_TEXTURE_2D_ARRAY holding one layer per texture of the scene, cleared to the placeholder color,
+// and starts decoding the files in the background. Without asynchronous loading it waits for the decodes and
+// uploads them all before returning, failing if any file could not be loaded.
+bool UCreateTextureArray()
+{
+    const GLsizei layers = max<GLsizei>((GLsizei)gScene.textures.size(), 1);
+    const GLsizei mipLevels = 1 + (GLsizei)floor(log2((double)TEXTURE_LAYER_SIZE));
+
+    gArrayFormat = gTextureFormat;
+    if (gArrayFormat != TEXTURE_FORMAT_RGBA8 && !UHasExtension("GL_EXT_texture_compression_s3tc"))
+    {
+        cout << "S3TC texture compression is not supported, loading the textures as RGBA8" << endl;
+        gArrayFormat = TEXTURE_FORMAT_RGBA8;
+    }
+
+    glGenTextures(1, &gTextureArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, gTextureArray);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, mipLevels, UTextureInternalFormat(gArrayFormat), TEXTURE_LAYER_SIZE, TEXTURE_LAYER_SIZE, layers);
+
+    // set the texture wrapping parameters (mirrored layers are handled in the shader)
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    // set texture filtering parameters: level 0 only while the layers arrive, since a blitted layer's mips are stale
+    // until they are generated; UUploadReadyTextures turns on trilinear filtering once every chain is complete
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Placeholder: clear every level of every layer through a temporary framebuffer, so a texture that fails to load
+    // keeps a complete chain. The mips of the others come with each image, or are generated once every image has arrived.
+    if (gArrayFormat == TEXTURE_FORMAT_RGBA8)
+    {
+        GLint previousDrawFramebuffer = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+        for (GLint level = 0; level < mipLevels; ++level)
+        {
+            for (GLint layer = 0; layer < layers; ++layer)
+            {
+                glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, gTextureArray, level, layer);
+                glClearBufferfv(GL_COLOR, 0, TEXTURE_PLACEHOLDER_COLOR);
+            }
+        }
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFramebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+    else
+        UClearCompressedLayers(layers, mipLevels);
+
+    // The loader gets the paths below RESOURCE_DIR, which also name the bakes
+    vector<string> files;
+    for (const SceneTexture& texture : gScene.textures)
+        files.push_back(texture.path);
+
+    UStopTextureLoading();
+    if (gPixelBufferUploads && UHasExtension("GL_ARB_buffer_storage"))
+    {
+        gPixelBuffers.reset(new PixelBufferRing);
+        if (!gPixelBuffers->Create(UTextureChainBytes(gArrayFormat, TEXTURE_LAYER_SIZE), PIXEL_BUFFER_SLOTS))
+            gPixelBuffers.reset();
+    }
+
+    const bool flipRows = gFlipTexturesOnDecode;
+    const bool baked = gBakedTextures;
+    const Texture_Format format = gArrayFormat;
+    PixelBufferRing* ring = gPixelBuffers.get();
+    if (ring)
+        gTextureLoader.reset(new TextureLoader(
+            [flipRows, baked, format, ring](const string& file, DecodedImage& image) { return UDecodeIntoPixelBuffer(file, flipRows, baked, format, *ring, image); },
+            [ring](DecodedImage& image) { ring->Discard(image.bufferSlot); }));
+    else
+        gTextureLoader.reset(new TextureLoader(
+            [flipRows, baked, format](const string& file, DecodedImage& image) { return ULoadTextureImage(file, flipRows, baked, format, image); },
+            [](DecodedImage& image) { if (image.mipChain) delete[] image.pixels; else stbi_image_free(image.pixels); }));
+    gGenerateMipmaps = false;
+    gTextureLoadStats = TextureLoadStats();
+    gTextureLoadStats.textures = (unsigned)files.size();
+    gTextureLoadStats.textureBytes = UTextureChainBytes(gArrayFormat, TEXTURE_LAYER_SIZE) * layers;
+    gTextureLoadStats.decodeThreads = (unsigned)min<size_t>(max(1u, thread::hardware_concurrency()), files.size());
+    gTextureLoadStats.pixelBufferSlots = ring ? ring->SlotCount() : 0;
+    gTextureLoader->Start(files);
+
+    if (gAsyncTextures)
+        return true;
+
+    return UWaitForTextures();
+}
+
+
+// Uploads the decoded images waiting in the loader, for up to budgetMs but at least one. After the last one it builds
+// the array's mip chain if some images were blitted without theirs, and switches the array to trilinear filtering. Returns false if one of them could not be decoded;
+// its layer keeps the placeholder.
+bool UUploadReadyTextures(double budgetMs)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool success = true;
+
+    // Slots whose uploads the GPU has finished go back to the decoders
+    if (gPixelBuffers)
+        gPixelBuffers->Recycle(false);
+
+    while (LoadedImage* loaded = gTextureLoader->Take())
+    {
+        const chrono::steady_clock::time_point uploadStart = chrono::steady_clock::now();
+        if (loaded->image.baked)
+            gTextureLoadStats.baked++;
+        if (loaded->image.bufferSlot >= 0)
+        {
+            const size_t offset = gPixelBuffers->Offset(loaded->image.bufferSlot);
+            UUploadMipChain(gPixelBuffers->Buffer(), (const void*)offset, loaded->image.width, (GLint)loaded->index);
+            gPixelBuffers->Release(loaded->image.bufferSlot);
+            loaded->image = DecodedImage();     // the fence returns the slot, not Free
+        }
+        else if (loaded->image.mipChain)
+            UUploadMipChain(0, loaded->image.pixels, loaded->image.width, (GLint)loaded->index);
+        else if (loaded->image.pixels)
+        {
+            UCopyToLayer(loaded->image, (GLint)loaded->index);
+            gGenerateMipmaps = true;
+        }
+        else
+        {
+            cout << "Failed to load texture " << RESOURCE_DIR "/" << gScene.textures[loaded->index].path << endl;
+            success = false;
+        }
+        const double uploadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - uploadStart).count();
+        gTextureLoadStats.slowestUploadMs = max(gTextureLoadStats.slowestUploadMs, uploadMs);
+        gTextureLoadStats.totalUploadMs += uploadMs;
+        gTextureLoadStats.slowestDecodeMs = max(gTextureLoadStats.slowestDecodeMs, loaded->decodeMs);
+        gTextureLoadStats.totalDecodeMs += loaded->decodeMs;
+        gTextureLoadStats.uploaded++;
+        gRenderStats.textureUploads++;
+        gTextureLoader->Free(loaded);
+
+        if (chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() >= budgetMs)
+            break;
+    }
+
+    if (gTextureLoader->Done())
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, gTextureArray);
+        if (gGenerateMipmaps)
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        gTextureLoadStats.readyMs = chrono::duration<double, milli>(chrono::steady_clock::now() - gSceneCreateStart).count();
+    }
+    return success;
+}
+
+
+// Uploads every remaining texture as it is decoded. Between batches, the slots of the uploads issued so far are waited
+// for and recycled, since decodes blocked on a full ring only go on once they are free. Returns false if a texture
+// could not be decoded.
+bool UWaitForTextures()
+{
+    bool success = true;
+    while (UTexturesLoading())
+    {
+        success = UUploadReadyTextures(numeric_limits<double>::infinity()) && success;
+        if (!UTexturesLoading())
+            break;
+        if (gPixelBuffers)
+            gPixelBuffers->Recycle(true);
+        gTextureLoader->Wait();
+    }
+    return success;
+}
+
+
+// Drops the images still being decoded and releases the pixel buffers. Closing the ring first wakes the decodes
+// waiting for a slot, so the loader's threads can be joined.
+void UStopTextureLoading()
+{
+    if (gPixelBuffers)
+        gPixelBuffers->Close();
+    gTextureLoader.reset();
+    if (gPixelBuffers)
+        gPixelBuffers->Destroy();
+    gPixelBuffers.reset();
+}
+
+
+// Writes a texture (a path below RESOURCE_DIR), resampled to the layer size and followed by its mip chain in format,
+// into a slot of the ring, waiting for a free slot if needed; safe to call from any thread. With baked, a current bake
+// of the texture is copied into the slot as it is; otherwise the image file is decoded (and compressed for the block
+// formats). The image's pixels are the slot's.
+bool UDecodeIntoPixelBuffer(const string& texturePath, bool flipRows, bool baked, Texture_Format format, PixelBufferRing& ring, DecodedImage& image)
+{
+    int slot = -1;
+    if (baked || format != TEXTURE_FORMAT_RGBA8)
+    {
+        slot = ring.Acquire();
+        if (slot < 0)
+            return false;
+        if (ULoadMipChain(texturePath, baked, format, ring.Data(slot), image))
+        {
+            image.bufferSlot = slot;
+            return true;
+        }
+        if (format != TEXTURE_FORMAT_RGBA8)
+        {
+            ring.Discard(slot);
+            return false;
+        }
+    }
+
+    int width, height, channels;
+    unsigned char* pixels = stbi_load((string(RESOURCE_DIR "/") + texturePath).c_str(), &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        if (slot >= 0)
+            ring.Discard(slot);
+        return false;
+    }
+
+    if (slot < 0)
+        slot = ring.Acquire();
+    if (slot < 0)
+    {
+        // the scene is going away
+        stbi_image_free(pixels);
+        return false;
+    }
+
+    // Rows still in file order are flipped by the resampling, for free
+    if (flipRows)
+        UFlipImageRows(pixels, width, height, 4);
+    unsigned char* layer = ring.Data(slot);
+    UResampleToLayer(pixels, width, height, !flipRows, TEXTURE_LAYER_SIZE, layer);
+    UGenerateMipChain(layer, TEXTURE_LAYER_SIZE);
+    stbi_image_free(pixels);
+
+    image.pixels = layer;
+    image.width = TEXTURE_LAYER_SIZE;
+    image.height = TEXTURE_LAYER_SIZE;
+    image.channels = 4;
+    image.topRowFirst = false;
+    image.bufferSlot = slot;
+    image.mipChain = true;
+    return true;
+}
+
+
+// Loads a texture (a path below RESOURCE_DIR) on a loader thread. With baked, a current bake of it is copied out of
+// its container, layer and mip chain, into memory allocated with new[], as are the block formats' layers, which are
+// compressed here when there is no bake in their format; otherwise the image file is decoded for the blit.
+bool ULoadTextureImage(const string& texturePath, bool flipRows, bool baked, Texture_Format format, DecodedImage& image)
+{
+    if (baked || format != TEXTURE_FORMAT_RGBA8)
+    {
+        unique_ptr<unsigned char[]> levels(new unsigned char[UTextureChainBytes(format, TEXTURE_LAYER_SIZE)]);
+        if (ULoadMipChain(texturePath, baked, format, levels.get(), image))
+        {
+            levels.release();
+            return true;
+        }
+        if (format != TEXTURE_FORMAT_RGBA8)
+            return false;
+    }
+    return UDecodeImage((string(RESOURCE_DIR "/") + texturePath).c_str(), flipRows, image);
+}
+
+
+// Fills levels, UTextureChainBytes(format) bytes, with a texture's layer and mip chain and points the image at them.
+// RGBA8 chains only come from a current bake; the block formats' come from one or are compressed here, from the RGBA8
+// bake or the decoded image. False if there is none of these.
+bool ULoadMipChain(const string& texturePath, bool baked, Texture_Format format, unsigned char* levels, DecodedImage& image)
+{
+    bool fromBake = false;
+    const bool loaded = format == TEXTURE_FORMAT_RGBA8
+        ? (fromBake = baked && UReadBakedTexture(texturePath, TEXTURE_LAYER_SIZE, format, levels))
+        : ULoadTextureLevels(texturePath, TEXTURE_LAYER_SIZE, format, baked, levels, fromBake);
+    if (!loaded)
+        return false;
+
+    image.pixels = levels;
+    image.width = TEXTURE_LAYER_SIZE;
+    image.height = TEXTURE_LAYER_SIZE;
+    image.channels = 4;
+    image.mipChain = true;
+    image.baked = fromBake;
+    return true;
+}
+
+
+// Copies a layer of size x size followed by its mip chain, in the array's format, into the array, from offset levels
+// of a pixel unpack buffer, or from client memory at levels with buffer 0. From a buffer, the calls only queue copies
+// from memory the driver can read at any time, so they return without waiting for them.
+void UUploadMipChain(GLuint buffer, const void* levels, GLsizei size, GLint layer)
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, gTextureArray);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    const unsigned char* level = (const unsigned char*)levels;
+    for (GLint index = 0; size >= 1; size /= 2, ++index)
+    {
+        const size_t bytes = UTextureLevelBytes(gArrayFormat, size);
+        if (gArrayFormat == TEXTURE_FORMAT_RGBA8)
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, index, 0, 0, layer, size, size, 1, GL_RGBA, GL_UNSIGNED_BYTE, level);
+        else
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, index, 0, 0, layer, size, size, 1, UTextureInternalFormat(gArrayFormat), (GLsizei)bytes, level);
+        level += bytes;
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+
+// Fills every level of every layer of a compressed array with the placeholder color. Compressed textures cannot be
+// framebuffer attachments, so the color is encoded once as a block and uploaded repeated over a whole layer.
+void UClearCompressedLayers(GLsizei layers, GLsizei mipLevels)
+{
+    uint8_t pixels[16 * 4];
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 4; ++c)
+            pixels[i * 4 + c] = (uint8_t)(TEXTURE_PLACEHOLDER_COLOR[c] * 255.0f + 0.5f);
+
+    const size_t blockBytes = UTextureLevelBytes(gArrayFormat, 4);
+    vector<uint8_t> level(UTextureLevelBytes(gArrayFormat, TEXTURE_LAYER_SIZE));
+    UCompressImage(pixels, 4, gArrayFormat, level.data());
+    for (size_t offset = blockBytes; offset < level.size(); offset += blockBytes)
+        memcpy(&level[offset], level.data(), blockBytes);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, gTextureArray);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (GLint mip = 0; mip < mipLevels; ++mip)
+    {
+        // every level is a whole number of blocks, even those under 4x4
+        const GLsizei size = max(TEXTURE_LAYER_SIZE >> mip, 1);
+        const GLsizei bytes = (GLsizei)UTextureLevelBytes(gArrayFormat, size);
+        for (GLint layer = 0; layer < layers; ++layer)
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, mip, 0, 0, layer, size, size, 1,
+                UTextureInternalFormat(gArrayFormat), bytes, level.data());
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+
+// GL internal format of a layer format; the block formats are the S3TC ones, which every desktop driver has
+GLenum UTextureInternalFormat(Texture_Format format)
+{
+    switch (format)
+    {
+    case TEXTURE_FORMAT_BC1:
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TEXTURE_FORMAT_BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TEXTURE_FORMAT_RGBA8:
+    default:
+        return GL_RGBA8;
+    }
+}
+
+
+// Resamples a decoded image into a layer of the array. The image goes through a temporary mipmapped 2D texture
+// and is blitted with linear filtering from the mip level closest to the layer size, so large photos shrink
+// without aliasing and small ones are interpolated. Images still in file order are flipped by the same blit.
+void UCopyToLayer(const DecodedImage& decoded, GLint layer)
+{
+    GLuint image = 0;
+    if (!UCreateTexture(decoded, image))
+        return;
+
+    // The blit goes through two temporary framebuffers; keep whatever the caller had bound
+    GLint previousReadFramebuffer = 0, previousDrawFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+
+    GLuint framebuffers[2];
+    glGenFramebuffers(2, framebuffers);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+
+    // Pick the smallest mip level that is still at least as large as the layer
+    GLint width = decoded.width, height = decoded.height, level = 0;
+    while (width / 2 >= TEXTURE_LAYER_SIZE && height / 2 >= TEXTURE_LAYER_SIZE)
+    {
+        width /= 2;
+        height /= 2;
+        ++level;
+    }
+
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, image, level);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, gTextureArray, 0, layer);
+    const GLint bottom = decoded.topRowFirst ? TEXTURE_LAYER_SIZE : 0;
+    glBlitFramebuffer(0, 0, width, height, 0, bottom, TEXTURE_LAYER_SIZE, TEXTURE_LAYER_SIZE - bottom, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFramebuffer);
+    glDeleteFramebuffers(2, framebuffers);
+    UDestroyTexture(image);
+}
+
+
+// Packs an instance's uv scale, texture layer and wrap mode the way both shaders read them
+glm::vec4 UTextureParameters(const SceneInstance& instance)
+{
+    if (instance.texture == SCENE_NO_TEXTURE)
+        return glm::vec4(instance.uvScale, 0.0f, 0.0f);
+
+    const bool mirrored = gScene.textures[instance.texture].mirrored;
+    return glm::vec4(instance.uvScale, (float)instance.texture, mirrored ? 1.0f : 0.0f);
+}
+
+
+// Creates the frame uniform buffer and the object uniform buffer with one aligned slot per object
+void UCreateUniformBuffers()
+{
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    gObjectSlotSize = ((sizeof(ObjectUniforms) + alignment - 1) / alignment) * alignment;
+
+    glGenBuffers(1, &gFrameUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, gFrameUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+
+    // One slot per instance; keep at least one so an empty scene still gets a valid buffer
+    gObjectStaging.assign(gObjectSlotSize * max<size_t>(gScene.instances.size(), 1), 0);
+
+    // UV scales never change: write them once, the matrices follow on the first frame
+    for (size_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        ObjectUniforms* object = (ObjectUniforms*)&gObjectStaging[i * gObjectSlotSize];
+        object->model = glm::mat4(1.0f);
+        object->uvScale = UTextureParameters(gScene.instances[i]);
+    }
+
+    glGenBuffers(1, &gObjectUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, gObjectUbo);
+    glBufferData(GL_UNIFORM_BUFFER, gObjectStaging.size(), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // The frame block stays bound for the lifetime of the scene
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, gFrameUbo);
+}
+
+
+// Uploads the camera and light data read by every object of the frame
+void UUploadFrameUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition)
+{
+    FrameUniforms frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.lightColor = glm::vec4(gScene.lightColor, 1.0f);
+    frame.lightPos = glm::vec4(gScene.lightPosition, 1.0f);
+    frame.viewPosition = glm::vec4(cameraPosition, 1.0f);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, gFrameUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame);
+    gRenderStats.bufferUploads++;
+}
+
+
+// Rebuilds the matrices of the dirty transforms, copies them into their slots and uploads
+// the range of slots that changed. A static scene skips both the math and the upload.
+void UUploadObjectUniforms()
+{
+    gRenderStats.transformUpdates = (unsigned)gTransforms.Update(*gJobs);
+    if (gRenderStats.transformUpdates == 0)
+        return;
+
+    size_t first = gTransforms.Size(), last = 0;
+    for (uint32_t index : gTransforms.Updated())
+    {
+        ObjectUniforms* object = (ObjectUniforms*)&gObjectStaging[index * gObjectSlotSize];
+        object->model = gTransforms.Matrix(index) * gMeshes[gScene.instances[index].mesh][0].dequantization;
+        first = min<size_t>(first, index);
+        last = max<size_t>(last, index);
+    }
+
+    const GLintptr offset = first * gObjectSlotSize;
+    const GLsizeiptr size = (last - first) * gObjectSlotSize + sizeof(ObjectUniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, gObjectUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, &gObjectStaging[offset]);
+    gRenderStats.bufferUploads++;
+}
+
+
+// Creates the instance data buffer, in scene order, and the instance id buffer the batches index,
+// and adds the id attribute to the mesh pool's vertex array
+void UCreateInstanceBuffer()
+{
+    const size_t count = max<size_t>(gScene.instances.size(), 1);
+    gInstanceStaging.assign(count, InstanceData());
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        gInstanceStaging[i].model = glm::mat4(1.0f);
+        gInstanceStaging[i].data = UTextureParameters(gScene.instances[i]);
+    }
+    gInstanceIds.assign(count, 0);
+    gInstanceLods.assign(gScene.instances.size(), 0);
+    gInstanceSpheres.Resize(gScene.instances.size());
+    gInstanceBoxes.Resize(gScene.instances.size());
+    gInstanceVisible.assign(gScene.instances.size(), 1);
+    gInstanceBvh = Bvh();
+    gBatches.clear();
+    gDrawListDirty = true;
+
+    glGenBuffers(1, &gInstanceBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gInstanceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, gInstanceStaging.size() * sizeof(InstanceData), gInstanceStaging.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // The instanced programs index the data as a storage buffer, bound for the lifetime of the scene
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_STORAGE_BINDING, gInstanceBuffer);
+
+    glGenBuffers(1, &gInstanceIdBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, gInstanceIdBuffer);
+    glBufferData(GL_ARRAY_BUFFER, gInstanceIds.size() * sizeof(uint32_t), gInstanceIds.data(), GL_DYNAMIC_DRAW);
+
+    // One id per instance: a draw's base instance picks where its batch starts
+    glBindVertexArray(gMeshPool.VertexArray());
+    glVertexAttribIPointer(INSTANCE_ID_LOCATION, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+    glEnableVertexAttribArray(INSTANCE_ID_LOCATION);
+    glVertexAttribDivisor(INSTANCE_ID_LOCATION, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+// Moves the bounding volumes of the instances whose transform the last update rebuilt: the mesh's sphere
+// center goes through the model matrix and its radius grows with the largest scale; the box around the
+// transformed mesh box takes the absolute values of the matrix's rotation and scale times the half extent.
+// Then builds the hierarchy on the first frame, or refits the nodes above the moved instances.
+void UUpdateInstanceBounds()
+{
+    const vector<uint32_t>& updated = gTransforms.Updated();
+    for (uint32_t index : updated)
+    {
+        const uint32_t mesh = gScene.instances[index].mesh;
+        const glm::mat4& model = gTransforms.Matrix(index);
+        const glm::vec4& sphere = gMeshSpheres[mesh];
+        const glm::vec3 scale = glm::abs(gTransforms.Scale(index));
+        const glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f));
+        gInstanceSpheres.Set(index, center, sphere.w * max(scale.x, max(scale.y, scale.z)));
+
+        const glm::mat3 absolute(glm::abs(glm::vec3(model[0])), glm::abs(glm::vec3(model[1])), glm::abs(glm::vec3(model[2])));
+        gInstanceBoxes.Set(index, glm::vec3(model * glm::vec4(gMeshBoxCenters[mesh], 1.0f)), absolute * gMeshBoxExtents[mesh]);
+    }
+
+    if (gInstanceBvh.Empty())
+        UBuildBvh(gInstanceBvh, gInstanceBoxes);
+    else if (!updated.empty())
+        URefitBvh(gInstanceBvh, gInstanceBoxes, updated);
+}
+
+
+// Walks the instance hierarchy with the planes of the view frustum: whole groups of instances off screen
+// are rejected with one test, and groups entirely on screen are accepted without testing their instances
+void UCullInstances(const glm::mat4& viewProjection)
+{
+    size_t visibleCount = gInstanceVisible.size();
+    if (gCullingEnabled)
+        visibleCount = UCullBvh(gInstanceBvh, UExtractFrustum(viewProjection), gInstanceBoxes, gInstanceVisible.data());
+    else
+        fill(gInstanceVisible.begin(), gInstanceVisible.end(), (uint8_t)1);
+
+    gRenderStats.visibleInstances = (unsigned)visibleCount;
+    gRenderStats.culledInstances = (unsigned)(gInstanceVisible.size() - visibleCount);
+}
+
+
+// Draws the MAX_OCCLUDERS visible instances with the largest bounding spheres for their distance into the
+// occlusion buffer, builds its tile level and clears the visible flag of every instance whose box is behind them
+void UCullOccludedInstances(const glm::mat4& viewProjection, const glm::vec3& cameraPosition)
+{
+    if (!gOcclusionEnabled || !gCullingEnabled)
+        return;
+
+    vector<pair<float, uint32_t>> candidates;
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        if (!gInstanceVisible[i] || !MESH_OCCLUDES[gScene.instances[i].mesh])
+            continue;
+
+        const float radius = gInstanceSpheres.radius[i];
+        const float distance = glm::length(glm::vec3(gInstanceSpheres.x[i], gInstanceSpheres.y[i], gInstanceSpheres.z[i]) - cameraPosition);
+        const float size = distance > radius ? radius / distance : numeric_limits<float>::max();
+        if (size >= OCCLUDER_MIN_SIZE)
+            candidates.push_back(make_pair(size, i));
+    }
+    if (candidates.empty())
+        return;
+
+    const size_t occluderCount = min(candidates.size(), MAX_OCCLUDERS);
+    partial_sort(candidates.begin(), candidates.begin() + occluderCount, candidates.end(), greater<pair<float, uint32_t>>());
+
+    UClearOcclusionBuffer(gOcclusionBuffer, OCCLUSION_WIDTH, OCCLUSION_HEIGHT, viewProjection);
+    for (size_t c = 0; c < occluderCount; ++c)
+    {
+        const uint32_t instance = candidates[c].second;
+        gRenderStats.occluderTriangles += (unsigned)URasterizeOccluder(gOcclusionBuffer, gOccluderMeshes[gScene.instances[instance].mesh], gTransforms.Matrix(instance));
+    }
+    UBuildHierarchicalZ(gOcclusionBuffer);
+
+    const size_t occluded = UCullOccluded(gOcclusionBuffer, gInstanceBoxes, gInstanceVisible.data());
+    gRenderStats.occluders = (unsigned)occluderCount;
+    gRenderStats.occludedInstances = (unsigned)occluded;
+    gRenderStats.visibleInstances -= (unsigned)occluded;
+}
+
+
+// Picks every visible instance's detail level from the fraction of the viewport height its bounding sphere covers:
+// the radius over the distance to the camera, times the projection's focal length (orthographic views drop the distance).
+// Culled instances get INSTANCE_CULLED. Marks the batches for rebuilding when a level changed.
+void UAssignLevelsOfDetail(const glm::mat4& projection, const glm::vec3& cameraPosition)
+{
+    const bool perspective = projection[3][3] == 0.0f;
+    const float focalLength = projection[1][1];
+
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        uint32_t level = INSTANCE_CULLED;
+        if (gInstanceVisible[i])
+        {
+            const float radius = gInstanceSpheres.radius[i];
+            const glm::vec3 center(gInstanceSpheres.x[i], gInstanceSpheres.y[i], gInstanceSpheres.z[i]);
+
+            // Inside the bounding sphere counts as covering the whole screen
+            float size = radius * focalLength;
+            if (perspective)
+            {
+                const float distance = glm::length(center - cameraPosition);
+                size = distance > radius ? size / distance : numeric_limits<float>::max();
+            }
+
+            const uint32_t levels = gMeshLodCounts[gScene.instances[i].mesh];
+            level = 0;
+            while (level + 1 < levels && size < PRIMITIVE_LOD_SCREEN_SIZES[level] * gLodScale)
+                ++level;
+            gRenderStats.lodInstances[level]++;
+        }
+
+        if (gInstanceLods[i] != level)
+        {
+            gInstanceLods[i] = (uint8_t)level;
+            gDrawListDirty = true;
+        }
+    }
+}
+
+
+// Groups the visible instances into batches of the same program, mesh and detail level with a counting sort and lays
+// the instance ids out batch by batch: textured instances first, then lamps; within those by mesh, then level.
+// Ties keep scene order. Uploads the ids in one call and rebuilds the indirect commands from the batches.
+void UBuildDrawList()
+{
+    uint32_t offsets[DRAW_BATCH_KEYS + 1] = {};
+    vector<uint32_t> keys(gScene.instances.size());
+    uint32_t visibleCount = 0;
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        if (gInstanceLods[i] == INSTANCE_CULLED)
+            continue;
+
+        ++visibleCount;
+        const SceneInstance& instance = gScene.instances[i];
+        const bool lamp = instance.texture == SCENE_NO_TEXTURE;
+        keys[i] = ((lamp ? SCENE_MESH_COUNT : 0) + instance.mesh) * PRIMITIVE_MAX_LODS + gInstanceLods[i];
+        offsets[keys[i] + 1]++;
+    }
+
+    gBatches.clear();
+    for (uint32_t key = 0; key < DRAW_BATCH_KEYS; ++key)
+    {
+        const uint32_t count = offsets[key + 1];
+        offsets[key + 1] = offsets[key] + count;
+        if (count == 0)
+            continue;
+
+        const uint32_t program = key / PRIMITIVE_MAX_LODS;
+        DrawBatch batch = { program % SCENE_MESH_COUNT, key % PRIMITIVE_MAX_LODS, program >= SCENE_MESH_COUNT, offsets[key], count };
+        gBatches.push_back(batch);
+    }
+
+    for (uint32_t i = 0; i < keys.size(); ++i)
+        if (gInstanceLods[i] != INSTANCE_CULLED)
+            gInstanceIds[offsets[keys[i]]++] = i;
+
+    if (visibleCount > 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, gInstanceIdBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, visibleCount * sizeof(uint32_t), gInstanceIds.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        gRenderStats.bufferUploads++;
+    }
+
+    if (gIndirectSupported)
+        UUpdateIndirectCommands();
+    gDrawListDirty = false;
+}
+
+
+// Creates the command buffer with room for one command per possible batch
+void UCreateIndirectCommands()
+{
+    glGenBuffers(1, &gIndirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, gIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, DRAW_BATCH_KEYS * sizeof(DrawElementsIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    gIndirectRanges.clear();
+}
+
+
+// Builds one indirect command per batch, pointing at its mesh level in the pool and at its instance ids,
+// groups the commands into one run per program and uploads them
+void UUpdateIndirectCommands()
+{
+    DrawElementsIndirectCommand commands[DRAW_BATCH_KEYS];
+    GLuint commandCount = 0;
+    gIndirectRanges.clear();
+
+    // Batches are already ordered textured first, lamps last, so each program's commands are contiguous
+    for (const DrawBatch& batch : gBatches)
+    {
+        const GLMesh& mesh = gMeshes[batch.mesh][batch.lod];
+        DrawElementsIndirectCommand command = { mesh.nIndices, batch.count, mesh.firstIndex, mesh.baseVertex, batch.first };
+
+        if (gIndirectRanges.empty() || gIndirectRanges.back().lamp != batch.lamp)
+        {
+            IndirectRange range = { batch.lamp, commandCount, 0, 0, 0 };
+            gIndirectRanges.push_back(range);
+        }
+        gIndirectRanges.back().count++;
+        gIndirectRanges.back().vertexBytes += mesh.nIndices * batch.count * gVertexSize;
+        gIndirectRanges.back().triangles += mesh.nIndices / 3 * batch.count;
+        commands[commandCount++] = command;
+    }
+
+    if (commandCount == 0)
+        return;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, gIndirectBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandCount * sizeof(DrawElementsIndirectCommand), commands);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    gRenderStats.bufferUploads++;
+}
+
+
+// Inserts prelude after the #version line (and extension line) of a shader source
+std::string UWithPrelude(const char* source, const char* prelude)
+{
+    string text = source;
+    size_t position = text.find('\n') + 1;
+    if (text.compare(position, 10, "#extension") == 0)
+        position = text.find('\n', position) + 1;
+    return text.substr(0, position) + prelude + text.substr(position);
+}
+
+
+// Whether the current context exposes an extension
+bool UHasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension != NULL && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+
+// Copies the matrices rebuilt by the transform store into the instance data and uploads the range that changed
+void UUploadInstanceData()
+{
+    gRenderStats.transformUpdates = (unsigned)gTransforms.Update(*gJobs);
+    if (gRenderStats.transformUpdates == 0)
+        return;
+
+    size_t first = gInstanceStaging.size(), last = 0;
+    for (uint32_t index : gTransforms.Updated())
+    {
+        gInstanceStaging[index].model = gTransforms.Matrix(index) * gMeshes[gScene.instances[index].mesh][0].dequantization;
+        first = min<size_t>(first, index);
+        last = max<size_t>(last, index);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gInstanceBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * sizeof(InstanceData), (last - first + 1) * sizeof(InstanceData), &gInstanceStaging[first]);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    gRenderStats.bufferUploads++;
+}
+
+
+// Creates every primitive's detail levels once; instances share them
+void UCreateAllMeshes() {
+    // One vertex array for all meshes, with the attributes declared once
+    if (gVertexFormat == VERTEX_FORMAT_PACKED)
+    {
+        // 16 bytes: unorm16 position within the mesh bounds, octahedral snorm16 normal, half float uv
+        gVertexSize = sizeof(PackedVertex);
+        gMeshPool.Create(gVertexSize, MESH_POOL_VERTICES, MESH_POOL_INDICES);
+        gMeshPool.SetAttribute(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedVertex, position));
+        gMeshPool.SetAttribute(1, 2, GL_SHORT, GL_TRUE, offsetof(PackedVertex, normal));
+        gMeshPool.SetAttribute(2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, uv));
+    }
+    else
+    {
+        // 32 bytes: interleaved position, normal, texture coordinate floats
+        const GLuint floatsPerVertex = 3;
+        const GLuint floatsPerNormal = 3;
+        const GLuint floatsPerUV = 2;
+        gVertexSize = sizeof(float) * (floatsPerVertex + floatsPerNormal + floatsPerUV);
+        gMeshPool.Create(gVertexSize, MESH_POOL_VERTICES, MESH_POOL_INDICES);
+        gMeshPool.SetAttribute(0, floatsPerVertex, GL_FLOAT, GL_FALSE, 0);
+        gMeshPool.SetAttribute(1, floatsPerNormal, GL_FLOAT, GL_FALSE, sizeof(float) * floatsPerVertex);
+        gMeshPool.SetAttribute(2, floatsPerUV, GL_FLOAT, GL_FALSE, sizeof(float) * (floatsPerVertex + floatsPerNormal));
+    }
+
+    // The generator's shapes are numbered like the scene's meshes
+    static_assert((uint32_t)SCENE_MESH_COUNT == (uint32_t)PRIMITIVE_SHAPE_COUNT, "Scene_Mesh and Primitive_Shape must match");
+    // Generating and optimizing the shapes is CPU work, one job each; the uploads stay on the GL thread
+    vector<MeshData> chains[SCENE_MESH_COUNT];
+    gJobs->ParallelFor(SCENE_MESH_COUNT, 1, [&chains](size_t begin, size_t end, unsigned)
+        {
+            for (size_t mesh = begin; mesh < end; ++mesh)
+                chains[mesh] = UGeneratePrimitiveLevels((Scene_Mesh)mesh);
+        });
+    for (uint32_t mesh = 0; mesh < SCENE_MESH_COUNT; ++mesh)
+        UCreatePrimitiveMeshes((Scene_Mesh)mesh, chains[mesh]);
+}
+
+
+// Copies a mesh given as interleaved position, normal, uv floats into the pool, in the current vertex format.
+// Packed meshes are quantized within bounds and keep the matrix expanding their positions; the renderer folds it into the model matrix.
+void UAllocateMesh(GLMesh& mesh, const GLfloat* verts, GLuint nVertices, const GLuint* indices, GLuint nIndices, const VertexBounds& bounds)
+{
+    MeshPool::Handle& handle = mesh;
+    if (gVertexFormat == VERTEX_FORMAT_PACKED)
+    {
+        const vector<PackedVertex> packed = UPackVertices(verts, nVertices, bounds);
+        handle = gMeshPool.Allocate(packed.data(), nVertices, indices, nIndices);
+        mesh.dequantization = bounds.Dequantization();
+    }
+    else
+    {
+        handle = gMeshPool.Allocate(verts, nVertices, indices, nIndices);
+        mesh.dequantization = glm::mat4(1.0f);
+    }
+}
+
+
+// Generates a primitive's detail levels and reorders each for the vertex cache and vertex fetch; touches no GL state
+vector<MeshData> UGeneratePrimitiveLevels(Scene_Mesh mesh)
+{
+    vector<MeshData> chain = UGenerateLodChain((Primitive_Shape)mesh);
+    for (MeshData& level : chain)
+    {
+        UOptimizeVertexCache(level.indices, level.VertexCount());
+        UOptimizeVertexFetch(level.vertices, level.indices, PRIMITIVE_FLOATS_PER_VERTEX);
+    }
+    return chain;
+}
+
+
+// Uploads the detail levels UGeneratePrimitiveLevels built and keeps the primitive's bounds and occluder
+void UCreatePrimitiveMeshes(Scene_Mesh mesh, const vector<MeshData>& chain)
+{
+    vector<float> vertices;
+    for (const MeshData& level : chain)
+        vertices.insert(vertices.end(), level.vertices.begin(), level.vertices.end());
+    const VertexBounds bounds = UComputeVertexBounds(vertices.data(), vertices.size() / PRIMITIVE_FLOATS_PER_VERTEX, PRIMITIVE_FLOATS_PER_VERTEX);
+    gMeshSpheres[mesh] = UComputeBoundingSphere(vertices);
+    UComputeBoundingBox(vertices, gMeshBoxCenters[mesh], gMeshBoxExtents[mesh]);
+
+    gMeshLodCounts[mesh] = (unsigned)chain.size();
+    for (uint32_t level = 0; level < chain.size(); ++level)
+    {
+        const MeshData& data = chain[level];
+        UAllocateMesh(gMeshes[mesh][level], data.vertices.data(), (GLuint)data.VertexCount(), data.indices.data(), (GLuint)data.indices.size(), bounds);
+    }
+
+    // Positions of the finest level for the occlusion rasterizer
+    OccluderMesh& occluder = gOccluderMeshes[mesh];
+    const MeshData& finest = chain.front();
+    occluder.positions.resize(finest.VertexCount());
+    for (size_t v = 0; v < occluder.positions.size(); ++v)
+        occluder.positions[v] = glm::vec3(finest.vertices[v * PRIMITIVE_FLOATS_PER_VERTEX], finest.vertices[v * PRIMITIVE_FLOATS_PER_VERTEX + 1], finest.vertices[v * PRIMITIVE_FLOATS_PER_VERTEX + 2]);
+    occluder.indices = finest.indices;
+}
+
+
+// Sphere around interleaved position, normal, uv vertices: centered on their bounding box, reaching the farthest one
+glm::vec4 UComputeBoundingSphere(const std::vector<float>& vertices)
+{
+    if (vertices.empty())
+        return glm::vec4(0.0f);
+
+    glm::vec3 center, extent;
+    UComputeBoundingBox(vertices, center, extent);
+    float radius = 0.0f;
+    for (size_t v = 0; v < vertices.size(); v += PRIMITIVE_FLOATS_PER_VERTEX)
+        radius = max(radius, glm::length(glm::vec3(vertices[v], vertices[v + 1], vertices[v + 2]) - center));
+    return glm::vec4(center, radius);
+}
+
+// Box around interleaved position, normal, uv vertices, as center and half extent
+void UComputeBoundingBox(const std::vector<float>& vertices, glm::vec3& center, glm::vec3& extent)
+{
+    if (vertices.empty())
+    {
+        center = extent = glm::vec3(0.0f);
+        return;
+    }
+
+    glm::vec3 low(vertices[0], vertices[1], vertices[2]), high = low;
+    for (size_t v = 0; v < vertices.size(); v += PRIMITIVE_FLOATS_PER_VERTEX)
+    {
+        const glm::vec3 position(vertices[v], vertices[v + 1], vertices[v + 2]);
+        low = glm::min(low, position);
+        high = glm::max(high, position);
+    }
+
+    center = 0.5f * (low + high);
+    extent = 0.5f * (high - low);
+}
+
+
+// Destroys a given mesh
+void UDestroyMesh(GLMesh& mesh)
+{
+    gMeshPool.Free(mesh);
+}
+
+
+/*Generate and load the texture*/
+bool UCreateTexture(const char* filename, GLuint& textureId)
+{
+    DecodedImage image;
+    if (!UDecodeImage(filename, true, image))
+        return false;
+
+    const bool success = UCreateTexture(image, textureId);
+    stbi_image_free(image.pixels);
+    return success;
+}
+
+
+// Loads an image file, flipped so its first row is the bottom one if flipRows, otherwise left in file order
+// for the caller to flip on the GPU; safe to call from any thread
+bool UDecodeImage(const char* filename, bool flipRows, DecodedImage& image)
+{
+    image.pixels = stbi_load(filename, &image.width, &image.height, &image.channels, 0);
+    if (!image.pixels)
+        return false;
+
+    if (flipRows)
+        UFlipImageRows(image.pixels, image.width, image.height, image.channels);
+    image.topRowFirst = !flipRows;
+    return true;
+}
+
+
+// Uploads a decoded image as a mipmapped 2D texture, upside down if its top row is first; the image stays owned by the caller
+bool UCreateTexture(const DecodedImage& image, GLuint& textureId)
+{
+    if (image.channels != 3 && image.channels != 4)
+    {
+        cout << "Not implemented to handle image with " << image.channels << " channels" << endl;
+        return false;
+    }
+
+    glGenTextures(1, &textureId);               // Stores how many textures we want to generate
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    // set the texture wrapping parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    // set texture filtering parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (image.channels == 3)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, image.pixels);
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+    return true;
+}
+
+// Destroy Texture Program
+void UDestroyTexture(GLuint textureId)
+{
+    glDeleteTextures(1, &textureId);
+}
+
+
+// Implements the UCreateShaders function
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint& programId)
+{
+    // Compilation and linkage error reporting
+    int success = 0;
+    char infoLog[512];
+
+    // Create a Shader program object.
+    programId = glCreateProgram();
+
+    // Create the vertex and fragment shader objects
+    GLuint vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
+    GLuint fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+
+    // Retrive the shader source
+    glShaderSource(vertexShaderId, 1, &vtxShaderSource, NULL);
+    glShaderSource(fragmentShaderId, 1, &fragShaderSource, NULL);
+
+    // Compile the vertex shader, and print compilation errors (if any)
+    glCompileShader(vertexShaderId); // compile the vertex shader
+    // check for shader compile errors
+    glGetShaderiv(vertexShaderId, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(vertexShaderId, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+
+        return false;
+    }
+
+    glCompileShader(fragmentShaderId); // compile the fragment shader
+    // check for shader compile errors
+    glGetShaderiv(fragmentShaderId, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(fragmentShaderId, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+
+        return false;
+    }
+
+    // Attached compiled shaders to the shader program
+    glAttachShader(programId, vertexShaderId);
+    glAttachShader(programId, fragmentShaderId);
+
+    glLinkProgram(programId);   // links the shader program
+    // check for linking errors
+    glGetProgramiv(programId, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glGetProgramInfoLog(programId, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+
+        return false;
+    }
+
+    glUseProgram(programId);    // Uses the shader program
+
+    return true;
+}
+
+// Destroy Shader program
+void UDestroyShaderProgram(GLuint programId)
+{
+    glDeleteProgram(programId);
+}
@@ -0,0 +1,153 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <GL/glew.h>        // GLEW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+#include "camera.h" // Camera class
+#include "mesh_pool.h"  // Shared vertex and index buffers
+#include "occlusion.h"  // CPU depth buffer for occlusion culling
+#include "primitives.h" // Procedural meshes and their detail levels
+#include "scene.h"  // Scene file loading
+#include "texture_compression.h"    // Texture array formats
+#include "transform_store.h"    // Cached model matrices
+
+// Variables for window width and height
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+
+// Stores where a given mesh lives in the shared mesh pool (base vertex, first index and counts)
+// and how to expand its quantized positions
+struct GLMesh : MeshPool::Handle
+{
+    glm::mat4 dequantization = glm::mat4(1.0f);    // maps the stored positions to model space
+};
+
+// Layout of the vertices in the mesh pool
+enum UVertexFormat
+{
+    VERTEX_FORMAT_FLOAT,        // 32 bytes: float position, normal and uv
+    VERTEX_FORMAT_PACKED        // 16 bytes: unorm16 position, octahedral normal, half float uv (vertex_format.h)
+};
+
+// How URender submits the scene
+enum URenderPath
+{
+    RENDER_PATH_INDIVIDUAL,     // one draw per object, object data in a uniform block
+    RENDER_PATH_INSTANCED,      // one instanced draw per mesh and detail level, object data in a storage buffer
+    RENDER_PATH_INDIRECT        // one multi-draw indirect per program, reading the same storage buffer
+};
+
+// Counts the GL work submitted by one URender call, so benchmarks can compare renderer changes
+struct URenderStats
+{
+    unsigned drawCalls = 0;
+    unsigned programBinds = 0;
+    unsigned vertexArrayBinds = 0;
+    unsigned textureUnitChanges = 0;
+    unsigned textureBinds = 0;
+    unsigned textureParameterChanges = 0;
+    unsigned bufferBinds = 0;       // uniform buffer ranges bound
+    unsigned uniformUploads = 0;    // glUniform* calls
+    unsigned bufferUploads = 0;     // glBufferSubData calls
+    unsigned transformUpdates = 0;  // model matrices rebuilt because their transform changed
+    unsigned avoidedBinds = 0;      // program, texture and vertex array binds skipped because the state was already current
+    unsigned vertexBytes = 0;       // vertex data referenced by the draws: indices x instances x vertex size
+    unsigned triangles = 0;         // triangles submitted, instances included
+    unsigned lodInstances[PRIMITIVE_MAX_LODS] = {};     // instances drawn at each detail level, finest first
+    unsigned visibleInstances = 0;  // instances whose bounding box intersects the view frustum and is not occluded
+    unsigned culledInstances = 0;   // instances skipped because they are off screen
+    unsigned occludedInstances = 0; // instances skipped because they are hidden behind the occluders
+    unsigned occluders = 0;         // instances drawn into the occlusion buffer
+    unsigned occluderTriangles = 0; // triangles drawn into the occlusion buffer
+    unsigned textureUploads = 0;    // decoded textures copied into their layer this frame
+
+    // Total number of GL state changes (everything except the draws and data uploads)
+    unsigned StateChanges() const
+    {
+        return programBinds + vertexArrayBinds + textureUnitChanges + textureBinds + textureParameterChanges + bufferBinds;
+    }
+};
+
+// How the scene's textures were loaded
+struct TextureLoadStats
+{
+    unsigned decodeThreads = 0;     // loader threads decoding (or reading) the images
+    unsigned pixelBufferSlots = 0;  // slots of the pixel buffer ring, 0 when the images are blitted
+    unsigned textures = 0;          // layers of the texture array
+    unsigned uploaded = 0;          // images taken from the loader so far, failed ones included
+    unsigned baked = 0;             // read from texture_baker's containers rather than their image files
+    size_t textureBytes = 0;        // memory the texture array takes, mips included
+    double slowestDecodeMs = 0.0;   // longest decode (or read) of one image
+    double totalDecodeMs = 0.0;
+    double slowestUploadMs = 0.0;   // longest time the GL thread spent uploading one image
+    double totalUploadMs = 0.0;
+    double readyMs = 0.0;           // from the start of UCreateScene until the last texture was in place, 0 while loading
+};
+
+// Camera shared by the viewer's input callbacks and the renderer
+extern Camera gCamera;
+
+// GL work submitted by the last URender call
+extern URenderStats gRenderStats;
+
+/* Renderer function prototypes to:
+ * create and release the meshes, textures and shaders of the scene,
+ * turn frustum and occlusion culling on or off,
+ * load textures in the background within a per-frame upload budget, or wait for them,
+ * flip decoded images on the CPU, or leave them for the copy into the texture array to flip,
+ * stream textures through persistently mapped pixel buffers, or blit each one into the array,
+ * read the baked textures with their prebuilt mips, or decode every image file,
+ * store the texture array as RGBA8 or block compressed,
+ * find the instances a ray hits or that lie near a point,
+ * get the worker threads, to share them with other CPU work,
+ * and render a frame into the currently bound framebuffer
+ */
+bool UCreateScene(const std::string& sceneFile = DEFAULT_SCENE_FILE);
+void UDestroyScene();
+const SceneDescription& UGetScene();
+TransformStore& UGetTransforms();
+JobSystem& UGetJobSystem();
+bool USetRenderPath(URenderPath path);
+URenderPath UGetRenderPath();
+void USetVertexFormat(UVertexFormat format);
+UVertexFormat UGetVertexFormat();
+unsigned UGetVertexSize();
+void USetLodScale(float scale);
+float UGetLodScale();
+void USetCulling(bool enabled);
+bool UGetCulling();
+void USetOcclusionCulling(bool enabled);
+bool UGetOcclusionCulling();
+const OcclusionBuffer& UGetOcclusionBuffer();
+void USetAsyncTextureLoading(bool enabled);
+bool UGetAsyncTextureLoading();
+void USetFlipTexturesOnDecode(bool enabled);
+bool UGetFlipTexturesOnDecode();
+void USetPixelBufferUploads(bool enabled);
+bool UGetPixelBufferUploads();
+void USetBakedTextures(bool enabled);
+bool UGetBakedTextures();
+void USetTextureFormat(Texture_Format format);
+Texture_Format UGetTextureFormat();
+void USetTextureUploadBudget(double milliseconds);
+bool UTexturesLoading();
+void UFinishTextureLoading();
+const TextureLoadStats& UGetTextureLoadStats();
+bool UPickInstance(const glm::vec3& origin, const glm::vec3& direction, uint32_t& instance);
+void UQueryInstancesInSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& instances);
+void UCreateAllMeshes();
+void UCreatePrimitiveMeshes(Scene_Mesh mesh, const std::vector<MeshData>& chain);
+void UDestroyMesh(GLMesh& mesh);
+bool UCreateTexture(const char* filename, GLuint& textureId);
+void UDestroyTexture(GLuint textureId);
+void URender(bool& isPerspectiveView);
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint& programId);
+void UDestroyShaderProgram(GLuint programId);
+
+#endif
@@ -0,0 +1,330 @@
+#include <iostream>         // cout, cerr
+#include <fstream>          // ifstream, ofstream
+#include <sstream>          // istringstream
+#include <cstring>          // memcmp, strcmp
+#include <cstdlib>          // strtof
+#include <map>
+
+#include "scene.h"
+
+using namespace std; // Standard namespace
+
+/* Text format (.scene), one statement per line, '#' starts a comment:
+ *
+ *   light position=3,8,8 color=1,1,1
+ *   texture <name> <path relative to RESOURCE_DIR> [mirrored]
+ *   object mesh=<plane|cube|cylinder|sphere|torus> texture=<name|none> position=x,y,z rotation=x,y,z scale=x,y,z uv=u[,v]
+ *
+ * Binary format (.sceneb), little endian: a SceneFileHeader, then per texture a uint32 flags word,
+ * a uint32 path length and the path bytes, then the SceneInstance array exactly as laid out in memory.
+ */
+
+// Unnamed namespace
+namespace
+{
+    const char SCENE_MAGIC[4] = { 'S', 'C', 'N', 'B' };
+    const uint32_t SCENE_VERSION = 1;
+    const uint32_t TEXTURE_FLAG_MIRRORED = 1;
+
+    struct SceneFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t instanceSize;      // sizeof(SceneInstance), guards against layout changes
+        uint32_t textureCount;
+        uint32_t instanceCount;
+        float lightPosition[3];
+        float lightColor[3];
+    };
+
+    const char* const MESH_NAMES[SCENE_MESH_COUNT] = { "plane", "cube", "cylinder", "sphere", "torus" };
+}
+
+bool UParseFloats(const string& text, float* values, int count);
+bool ULoadSceneBinary(const string& filename, SceneDescription& scene);
+
+
+// Loads a compiled scene when the file starts with the binary magic, otherwise parses it as text
+bool ULoadScene(const string& filename, SceneDescription& scene)
+{
+    ifstream file(filename, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Failed to open scene " << filename << endl;
+        return false;
+    }
+
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    file.close();
+
+    if (memcmp(magic, SCENE_MAGIC, sizeof(magic)) == 0)
+        return ULoadSceneBinary(filename, scene);
+    return UParseSceneText(filename, scene);
+}
+
+
+// Parses the authoring format described at the top of this file
+bool UParseSceneText(const string& filename, SceneDescription& scene)
+{
+    ifstream file(filename);
+    if (!file.is_open())
+    {
+        cout << "Failed to open scene " << filename << endl;
+        return false;
+    }
+
+    scene = SceneDescription();
+    map<string, int32_t> textureIndices;
+    string line;
+    int lineNumber = 0;
+
+    while (getline(file, line))
+    {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != string::npos)
+            line.erase(comment);
+
+        istringstream tokens(line);
+        string keyword;
+        if (!(tokens >> keyword))
+            continue;
+
+        bool ok = true;
+        if (keyword == "texture")
+        {
+            string name, option;
+            SceneTexture texture;
+            texture.mirrored = false;
+            ok = (bool)(tokens >> name >> texture.path);
+            if (ok && tokens >> option)
+            {
+                // "mirrored" is the only option; anything else is most likely a typo
+                texture.mirrored = option == "mirrored";
+                ok = texture.mirrored && !(tokens >> option);
+            }
+
+            textureIndices[name] = (int32_t)scene.textures.size();
+            scene.textures.push_back(texture);
+        }
+        else if (keyword == "light")
+        {
+            string field;
+            while (ok && tokens >> field)
+            {
+                if (field.compare(0, 9, "position=") == 0)
+                    ok = UParseFloats(field.substr(9), &scene.lightPosition.x, 3);
+                else if (field.compare(0, 6, "color=") == 0)
+                    ok = UParseFloats(field.substr(6), &scene.lightColor.x, 3);
+                else
+                    ok = false;
+            }
+        }
+        else if (keyword == "object")
+        {
+            SceneInstance instance;
+            instance.mesh = SCENE_MESH_CUBE;
+            instance.texture = SCENE_NO_TEXTURE;
+            instance.position = glm::vec3(0.0f);
+            instance.rotation = glm::vec3(0.0f);
+            instance.scale = glm::vec3(1.0f);
+            instance.uvScale = glm::vec2(1.0f);
+
+            string field;
+            while (ok && tokens >> field)
+            {
+                size_t equals = field.find('=');
+                string key = field.substr(0, equals);
+                string value = equals == string::npos ? "" : field.substr(equals + 1);
+
+                if (key == "mesh")
+                {
+                    ok = false;
+                    for (uint32_t mesh = 0; mesh < SCENE_MESH_COUNT; ++mesh)
+                    {
+                        if (value == MESH_NAMES[mesh])
+                        {
+                            instance.mesh = mesh;
+                            ok = true;
+                        }
+                    }
+                }
+                else if (key == "texture")
+                {
+                    if (value != "none")
+                    {
+                        map<string, int32_t>::const_iterator it = textureIndices.find(value);
+                        ok = it != textureIndices.end();
+                        if (ok)
+                            instance.texture = it->second;
+                    }
+                }
+                else if (key == "position")
+                    ok = UParseFloats(value, &instance.position.x, 3);
+                else if (key == "rotation")
+                    ok = UParseFloats(value, &instance.rotation.x, 3);
+                else if (key == "scale")
+                    ok = UParseFloats(value, &instance.scale.x, 3);
+                else if (key == "uv")
+                {
+                    // a single value scales both axes
+                    ok = UParseFloats(value, &instance.uvScale.x, 2);
+                    if (!ok && UParseFloats(value, &instance.uvScale.x, 1))
+                    {
+                        instance.uvScale.y = instance.uvScale.x;
+                        ok = true;
+                    }
+                }
+                else
+                    ok = false;
+            }
+            if (ok)
+                scene.instances.push_back(instance);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            cout << filename << ":" << lineNumber << ": invalid scene statement: " << line << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Writes the compiled format described at the top of this file
+bool USaveSceneBinary(const string& filename, const SceneDescription& scene)
+{
+    ofstream file(filename, ios::binary);
+    if (!file.is_open())
+    {
+        cout << "Failed to write scene " << filename << endl;
+        return false;
+    }
+
+    SceneFileHeader header;
+    memcpy(header.magic, SCENE_MAGIC, sizeof(header.magic));
+    header.version = SCENE_VERSION;
+    header.instanceSize = sizeof(SceneInstance);
+    header.textureCount = (uint32_t)scene.textures.size();
+    header.instanceCount = (uint32_t)scene.instances.size();
+    for (int i = 0; i < 3; ++i)
+    {
+        header.lightPosition[i] = scene.lightPosition[i];
+        header.lightColor[i] = scene.lightColor[i];
+    }
+    file.write((const char*)&header, sizeof(header));
+
+    for (const SceneTexture& texture : scene.textures)
+    {
+        uint32_t flags = texture.mirrored ? TEXTURE_FLAG_MIRRORED : 0;
+        uint32_t length = (uint32_t)texture.path.size();
+        file.write((const char*)&flags, sizeof(flags));
+        file.write((const char*)&length, sizeof(length));
+        file.write(texture.path.data(), length);
+    }
+
+    // The instances are already packed: write the whole array at once
+    file.write((const char*)scene.instances.data(), scene.instances.size() * sizeof(SceneInstance));
+    return file.good();
+}
+
+
+// Reads a compiled scene: a header, the texture table, then one bulk read of the instance array
+bool ULoadSceneBinary(const string& filename, SceneDescription& scene)
+{
+    ifstream file(filename, ios::binary | ios::ate);
+    const uint64_t fileSize = file.is_open() ? (uint64_t)file.tellg() : 0;
+    file.seekg(0);
+    SceneFileHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, SCENE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        cout << "Failed to read scene header of " << filename << endl;
+        return false;
+    }
+    if (header.version != SCENE_VERSION || header.instanceSize != sizeof(SceneInstance))
+    {
+        cout << "Scene " << filename << " was compiled by an incompatible version, recompile it" << endl;
+        return false;
+    }
+
+    scene = SceneDescription();
+    scene.lightPosition = glm::vec3(header.lightPosition[0], header.lightPosition[1], header.lightPosition[2]);
+    scene.lightColor = glm::vec3(header.lightColor[0], header.lightColor[1], header.lightColor[2]);
+
+    // The counts and lengths come from the file: each is checked against the bytes left before anything is sized
+    // from it, so a damaged file fails here rather than asking for gigabytes
+    const uint64_t textureEntryBytes = 2 * sizeof(uint32_t);
+    uint64_t remaining = fileSize - sizeof(header);
+    bool truncated = header.textureCount > remaining / textureEntryBytes;
+    if (!truncated)
+        scene.textures.resize(header.textureCount);
+    for (SceneTexture& texture : scene.textures)
+    {
+        uint32_t flags = 0, length = 0;
+        file.read((char*)&flags, sizeof(flags));
+        file.read((char*)&length, sizeof(length));
+        remaining -= textureEntryBytes;
+        if (!file || length > remaining)
+        {
+            truncated = true;
+            break;
+        }
+        texture.mirrored = (flags & TEXTURE_FLAG_MIRRORED) != 0;
+        texture.path.resize(length);
+        file.read(&texture.path[0], length);
+        remaining -= length;
+    }
+
+    truncated = truncated || !file || header.instanceCount > remaining / sizeof(SceneInstance);
+    if (!truncated)
+    {
+        scene.instances.resize(header.instanceCount);
+        file.read((char*)scene.instances.data(), scene.instances.size() * sizeof(SceneInstance));
+    }
+    if (truncated || !file)
+    {
+        cout << "Scene " << filename << " is truncated" << endl;
+        return false;
+    }
+
+    for (const SceneInstance& instance : scene.instances)
+    {
+        if (instance.mesh >= SCENE_MESH_COUNT || instance.texture < SCENE_NO_TEXTURE
+            || instance.texture >= (int32_t)scene.textures.size())
+        {
+            cout << "Scene " << filename << " references a missing mesh or texture" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Parses "a,b,c" into exactly count floats
+bool UParseFloats(const string& text, float* values, int count)
+{
+    const char* cursor = text.c_str();
+    for (int i = 0; i < count; ++i)
+    {
+        char* end = nullptr;
+        values[i] = strtof(cursor, &end);
+        if (end == cursor)
+            return false;
+
+        cursor = end;
+        if (i + 1 < count)
+        {
+            if (*cursor != ',')
+                return false;
+            ++cursor;
+        }
+    }
+    return *cursor == '\0';
+}
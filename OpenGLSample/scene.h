@@ -0,0 +1,66 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Folder holding the textures. CMake points this at the source tree so the binaries run from any directory
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "../resources"
+#endif
+
+// Scene drawn when no --scene option is given
+#define DEFAULT_SCENE_FILE RESOURCE_DIR "/scenes/desk.scene"
+
+// Built-in meshes an instance can reference
+enum Scene_Mesh : uint32_t {
+    SCENE_MESH_PLANE,
+    SCENE_MESH_CUBE,
+    SCENE_MESH_CYLINDER,
+    SCENE_MESH_SPHERE,
+    SCENE_MESH_TORUS,
+    SCENE_MESH_COUNT
+};
+
+// Texture index of instances drawn with the unlit lamp shader
+const int32_t SCENE_NO_TEXTURE = -1;
+
+// A texture used by the scene, loaded from RESOURCE_DIR
+struct SceneTexture
+{
+    std::string path;       // relative to RESOURCE_DIR, e.g. "textures/wood.jpg"
+    bool mirrored;          // GL_MIRRORED_REPEAT instead of GL_REPEAT
+};
+
+// One placed object. Plain data so the compiled scene file can be read straight into an array.
+struct SceneInstance
+{
+    uint32_t mesh;          // Scene_Mesh
+    int32_t texture;        // index into SceneDescription::textures, or SCENE_NO_TEXTURE for a lamp
+    glm::vec3 position;
+    glm::vec3 rotation;     // Euler angles in degrees, applied as X * Y * Z
+    glm::vec3 scale;
+    glm::vec2 uvScale;
+};
+
+// Everything needed to build and draw a scene, with the instances packed contiguously
+struct SceneDescription
+{
+    std::vector<SceneTexture> textures;
+    std::vector<SceneInstance> instances;
+    glm::vec3 lightPosition = glm::vec3(3.0f, 8.0f, 8.0f);
+    glm::vec3 lightColor = glm::vec3(1.0f);
+};
+
+/* Scene file function prototypes to:
+ * load a scene from either the text authoring format or the compiled binary format,
+ * parse the text format, and write the compiled binary format
+ */
+bool ULoadScene(const std::string& filename, SceneDescription& scene);
+bool UParseSceneText(const std::string& filename, SceneDescription& scene);
+bool USaveSceneBinary(const std::string& filename, const SceneDescription& scene);
+
+#endif
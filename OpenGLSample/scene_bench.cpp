@@ -0,0 +1,454 @@
+#include <iostream>         // cout, cerr
+#include <fstream>          // ofstream
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp
+#include <chrono>           // steady_clock
+#include <string>
+#include <vector>
+#include <algorithm>        // sort
+#include <cmath>            // log10
+#include <GL/glew.h>        // GLEW library
+
+#include "renderer.h"       // Scene meshes, textures, shaders and URender
+#include "headless.h"       // Offscreen context, no window needed
+#include "camera_path.h"    // Scripted camera motion
+#include "software_renderer.h"  // CPU rasterizer the GL frames are compared against
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Frames rendered before and during the measurement
+    int gWarmupFrames = 10;
+    int gBenchFrames = 500;
+
+    // Simulated time step between frames, so every run walks the path identically
+    const float FRAME_STEP = 1.0f / 60.0f;
+
+    // Scene to draw, path file to replay (empty: orbit the scene) and where to write the report (empty: stdout)
+    string gSceneFile = DEFAULT_SCENE_FILE;
+    string gPathFile;
+    string gOutputFile;
+
+    // --render-path: how the scene is submitted (empty: the renderer's default, multi-draw indirect when supported)
+    string gRenderPath;
+    const char* const RENDER_PATH_NAMES[] = { "individual", "instanced", "indirect" };
+
+    // --vertex-format: layout of the mesh vertices, to compare the vertex bandwidth of both
+    UVertexFormat gVertexFormat = VERTEX_FORMAT_PACKED;
+    const char* const VERTEX_FORMAT_NAMES[] = { "float", "packed" };
+
+    // --animate: number of instances spun every frame, to measure the cost of moving objects
+    int gAnimatedInstances = 0;
+
+    // --lod-scale: screen sizes at which instances switch to coarser detail levels, relative to the renderer's (0: finest only)
+    float gLodScale = 1.0f;
+
+    // --no-cull: draw every instance, to measure what frustum culling saves
+    bool gCulling = true;
+
+    // --no-occlusion: keep frustum culling but draw instances hidden behind others
+    bool gOcclusion = true;
+
+    // --occlusion-image: PGM file the last frame's occlusion depth buffer is written to
+    string gOcclusionImageFile;
+
+    // --sync-textures: UCreateScene waits for every texture instead of returning with placeholders;
+    // --stream-textures: start measuring at once while the textures are still loading, instead of waiting for them;
+    // --upload-budget: milliseconds per frame the renderer may spend uploading textures (negative: the renderer's default);
+    // --flip-on-decode: flip images on the CPU after decoding them rather than in the copy into the texture array;
+    // --no-pbo: upload every texture as a temporary texture blitted into the array instead of through pixel buffers;
+    // --no-baked: decode every image file even where texture_baker left a current bake;
+    // --texture-format: rgba8, or bc1 or bc3 to block compress the texture array
+    bool gAsyncTextures = true;
+    bool gStreamTextures = false;
+    double gUploadBudgetMs = -1.0;
+    bool gFlipOnDecode = false;
+    bool gPixelBuffers = true;
+    bool gBakedTextures = true;
+    Texture_Format gTextureFormat = TEXTURE_FORMAT_RGBA8;
+
+    // --software-diff: frames along the path rendered by both GL and the software renderer and compared (0: none),
+    // --min-psnr: lowest PSNR in dB any of them may have before the run fails (0: report only). The default is well
+    // below what matching renderers reach (36 to 40 dB on the shipped scenes) but above a real divergence, such as
+    // one of them sampling the wrong mip level (about 30 dB).
+    // --diff-image: PPM file the least similar frame's difference, amplified, is written to
+    int gDiffFrames = 0;
+    double gMinPsnr = 32.0;
+    string gDiffImageFile;
+
+    // Differences larger than this in any channel count a pixel as differing
+    const int DIFF_PIXEL_TOLERANCE = 16;
+
+    bool isPerspectiveView = true;
+
+    // Min/median/p99/max of a series of frame times in milliseconds
+    struct TimingSummary
+    {
+        double min, median, p99, max, mean;
+    };
+}
+
+TimingSummary USummarize(vector<double> samples);
+void UWriteTiming(ostream& out, const char* name, const TimingSummary& timing);
+
+
+// Drives the camera along a scripted path for a fixed number of frames and reports frame times and GL work as JSON
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            gBenchFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            gWarmupFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+            gSceneFile = argv[++i];
+        else if (strcmp(argv[i], "--render-path") == 0 && i + 1 < argc)
+            gRenderPath = argv[++i];
+        else if (strcmp(argv[i], "--vertex-format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "float") == 0)
+        {
+            gVertexFormat = VERTEX_FORMAT_FLOAT;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--vertex-format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "packed") == 0)
+        {
+            gVertexFormat = VERTEX_FORMAT_PACKED;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--animate") == 0 && i + 1 < argc)
+            gAnimatedInstances = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lod-scale") == 0 && i + 1 < argc)
+            gLodScale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--no-cull") == 0)
+            gCulling = false;
+        else if (strcmp(argv[i], "--no-occlusion") == 0)
+            gOcclusion = false;
+        else if (strcmp(argv[i], "--occlusion-image") == 0 && i + 1 < argc)
+            gOcclusionImageFile = argv[++i];
+        else if (strcmp(argv[i], "--sync-textures") == 0)
+            gAsyncTextures = false;
+        else if (strcmp(argv[i], "--stream-textures") == 0)
+            gStreamTextures = true;
+        else if (strcmp(argv[i], "--upload-budget") == 0 && i + 1 < argc)
+            gUploadBudgetMs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--flip-on-decode") == 0)
+            gFlipOnDecode = true;
+        else if (strcmp(argv[i], "--no-pbo") == 0)
+            gPixelBuffers = false;
+        else if (strcmp(argv[i], "--no-baked") == 0)
+            gBakedTextures = false;
+        else if (strcmp(argv[i], "--texture-format") == 0 && i + 1 < argc && UParseTextureFormat(argv[i + 1], gTextureFormat))
+            ++i;
+        else if (strcmp(argv[i], "--software-diff") == 0 && i + 1 < argc)
+            gDiffFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--min-psnr") == 0 && i + 1 < argc)
+            gMinPsnr = atof(argv[++i]);
+        else if (strcmp(argv[i], "--diff-image") == 0 && i + 1 < argc)
+            gDiffImageFile = argv[++i];
+        else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc)
+            gPathFile = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            gOutputFile = argv[++i];
+        else
+        {
+            cerr << "usage: scene_bench [--frames N] [--warmup N] [--scene file] [--animate N] [--render-path individual|instanced|indirect] [--vertex-format float|packed] [--lod-scale S] [--no-cull] [--no-occlusion] [--occlusion-image depth.pgm] [--sync-textures] [--stream-textures] [--upload-budget ms] [--flip-on-decode] [--no-pbo] [--no-baked] [--texture-format rgba8|bc1|bc3] [--software-diff N] [--min-psnr dB] [--diff-image diff.ppm] [--path camera.path] [--output report.json]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (gBenchFrames <= 0)
+        gBenchFrames = 1;
+
+    // Camera path: a recorded one from the viewer, or a circle around the desk
+    CameraPath path;
+    if (!gPathFile.empty())
+    {
+        if (!path.Load(gPathFile))
+        {
+            cerr << "Failed to load camera path " << gPathFile << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        path = CameraPath::Orbit(glm::vec3(0.0f, 0.0f, 0.5f), 5.0f, 2.0f, 10.0f);
+    }
+
+    if (!UInitializeHeadless())
+        return EXIT_FAILURE;
+
+    USetVertexFormat(gVertexFormat);
+    USetAsyncTextureLoading(gAsyncTextures);
+    USetFlipTexturesOnDecode(gFlipOnDecode);
+    USetPixelBufferUploads(gPixelBuffers);
+    USetBakedTextures(gBakedTextures);
+    USetTextureFormat(gTextureFormat);
+    if (gUploadBudgetMs >= 0.0)
+        USetTextureUploadBudget(gUploadBudgetMs);
+
+    // Startup: until UCreateScene returns, and until the last texture is in place
+    chrono::steady_clock::time_point createStart = chrono::steady_clock::now();
+    if (!UCreateScene(gSceneFile))
+        return EXIT_FAILURE;
+    const double sceneCreateMs = chrono::duration<double, milli>(chrono::steady_clock::now() - createStart).count();
+    if (!gStreamTextures)
+        UFinishTextureLoading();
+    USetLodScale(gLodScale);
+    USetCulling(gCulling);
+    USetOcclusionCulling(gOcclusion);
+
+    if (!gRenderPath.empty())
+    {
+        int path = 0;
+        while (path < 3 && gRenderPath != RENDER_PATH_NAMES[path])
+            ++path;
+        if (path == 3)
+        {
+            cerr << "Unknown render path " << gRenderPath << endl;
+            return EXIT_FAILURE;
+        }
+        if (!USetRenderPath((URenderPath)path))
+        {
+            cerr << "Render path " << gRenderPath << " is not supported by this driver" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int frame = 0; frame < gWarmupFrames; ++frame)
+    {
+        path.Apply(gCamera, frame * FRAME_STEP);
+        URender(isPerspectiveView);
+        glFinish();
+    }
+
+    // CPU time spent moving the animated instances and inside URender, and the full frame including the wait for the GL to finish it
+    vector<double> cpuTimes, frameTimes;
+    cpuTimes.reserve(gBenchFrames);
+    frameTimes.reserve(gBenchFrames);
+    unsigned long long drawCalls = 0, stateChanges = 0, vertexBytes = 0, triangles = 0, visibleInstances = 0, culledInstances = 0;
+    unsigned long long occludedInstances = 0, occluders = 0, occluderTriangles = 0, textureUploads = 0;
+    unsigned long long lodInstances[PRIMITIVE_MAX_LODS] = {};
+    URenderStats totals;
+
+    TransformStore& transforms = UGetTransforms();
+    const uint32_t animated = (uint32_t)min<size_t>(max(gAnimatedInstances, 0), transforms.Size());
+
+    for (int frame = 0; frame < gBenchFrames; ++frame)
+    {
+        path.Apply(gCamera, frame * FRAME_STEP);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < animated; ++i)
+        {
+            glm::vec3 rotation = transforms.Rotation(i);
+            rotation.y += 1.0f;
+            transforms.SetRotation(i, rotation);
+        }
+        URender(isPerspectiveView);
+        chrono::steady_clock::time_point submitted = chrono::steady_clock::now();
+        glFinish();
+        chrono::steady_clock::time_point finished = chrono::steady_clock::now();
+
+        cpuTimes.push_back(chrono::duration<double, milli>(submitted - start).count());
+        frameTimes.push_back(chrono::duration<double, milli>(finished - start).count());
+
+        drawCalls += gRenderStats.drawCalls;
+        vertexBytes += gRenderStats.vertexBytes;
+        triangles += gRenderStats.triangles;
+        visibleInstances += gRenderStats.visibleInstances;
+        culledInstances += gRenderStats.culledInstances;
+        occludedInstances += gRenderStats.occludedInstances;
+        occluders += gRenderStats.occluders;
+        occluderTriangles += gRenderStats.occluderTriangles;
+        textureUploads += gRenderStats.textureUploads;
+        for (unsigned level = 0; level < PRIMITIVE_MAX_LODS; ++level)
+            lodInstances[level] += gRenderStats.lodInstances[level];
+        stateChanges += gRenderStats.StateChanges();
+        totals.programBinds += gRenderStats.programBinds;
+        totals.vertexArrayBinds += gRenderStats.vertexArrayBinds;
+        totals.textureUnitChanges += gRenderStats.textureUnitChanges;
+        totals.textureBinds += gRenderStats.textureBinds;
+        totals.textureParameterChanges += gRenderStats.textureParameterChanges;
+        totals.bufferBinds += gRenderStats.bufferBinds;
+        totals.uniformUploads += gRenderStats.uniformUploads;
+        totals.bufferUploads += gRenderStats.bufferUploads;
+        totals.transformUpdates += gRenderStats.transformUpdates;
+        totals.avoidedBinds += gRenderStats.avoidedBinds;
+    }
+
+    if (!gOcclusionImageFile.empty() && !UWriteOcclusionImage(UGetOcclusionBuffer(), gOcclusionImageFile))
+        cerr << "Failed to write occlusion image " << gOcclusionImageFile << endl;
+
+    // Software comparison: after the measurement so it does not disturb the timings. Both renderers draw the same
+    // frames of the path, with the animated instances where the benchmark left them.
+    // Worst and average PSNR, largest channel difference, mean absolute difference and share of differing pixels
+    double worstPsnr = 0.0, meanPsnr = 0.0, meanDifference = 0.0, differingPixels = 0.0;
+    int maxDifference = 0;
+    if (gDiffFrames > 0)
+    {
+        UFinishTextureLoading();
+        USoftwareSetJobSystem(UGetJobSystem());     // one worker per core, not one per core per renderer
+        USoftwareSetLodScale(gLodScale);
+        if (!USoftwareCreateScene(gSceneFile))
+            return EXIT_FAILURE;
+        TransformStore& softwareTransforms = USoftwareGetTransforms();
+        for (uint32_t i = 0; i < animated; ++i)
+            softwareTransforms.SetRotation(i, transforms.Rotation(i));
+
+        SoftwareFramebuffer software, difference;
+        software.Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+        difference.Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+        vector<uint8_t> hardware(software.color.size());
+        worstPsnr = 1e9;
+        for (int sample = 0; sample < gDiffFrames; ++sample)
+        {
+            const int frame = (int)((long long)sample * gBenchFrames / gDiffFrames);
+            path.Apply(gCamera, frame * FRAME_STEP);
+            URender(isPerspectiveView);
+            glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, hardware.data());
+            USoftwareRender(gCamera, isPerspectiveView, software);
+
+            double squaredError = 0.0, absoluteError = 0.0;
+            size_t differing = 0;
+            for (size_t pixel = 0; pixel < hardware.size(); pixel += 4)
+            {
+                int largest = 0;
+                for (size_t channel = 0; channel < 3; ++channel)
+                {
+                    const int delta = abs((int)hardware[pixel + channel] - (int)software.color[pixel + channel]);
+                    squaredError += delta * delta;
+                    absoluteError += delta;
+                    largest = max(largest, delta);
+                }
+                maxDifference = max(maxDifference, largest);
+                differing += largest > DIFF_PIXEL_TOLERANCE;
+            }
+            const double samples = hardware.size() / 4 * 3.0;
+            const double psnr = squaredError > 0.0 ? 10.0 * log10(255.0 * 255.0 * samples / squaredError) : 99.0;
+            meanPsnr += psnr / gDiffFrames;
+            meanDifference += absoluteError / samples / gDiffFrames;
+            differingPixels += (double)differing / (hardware.size() / 4) / gDiffFrames;
+
+            // The least similar frame's difference, amplified to be visible
+            if (psnr < worstPsnr)
+            {
+                worstPsnr = psnr;
+                for (size_t i = 0; i < hardware.size(); ++i)
+                    difference.color[i] = (uint8_t)min(abs((int)hardware[i] - (int)software.color[i]) * 8, 255);
+            }
+        }
+        USoftwareDestroyScene();
+
+        if (!gDiffImageFile.empty() && !UWriteFramebufferImage(difference, gDiffImageFile))
+            cerr << "Failed to write difference image " << gDiffImageFile << endl;
+    }
+
+    // Report
+    // ------
+    ofstream outputFile;
+    if (!gOutputFile.empty())
+        outputFile.open(gOutputFile);
+    ostream& out = gOutputFile.empty() ? cout : outputFile;
+
+    double frames = gBenchFrames;
+    out << "{\n";
+    out << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n";
+    out << "  \"frames\": " << gBenchFrames << ",\n";
+    out << "  \"scene\": \"" << gSceneFile << "\",\n";
+    out << "  \"instances\": " << UGetScene().instances.size() << ",\n";
+    out << "  \"render_path\": \"" << RENDER_PATH_NAMES[UGetRenderPath()] << "\",\n";
+    out << "  \"vertex_format\": \"" << VERTEX_FORMAT_NAMES[UGetVertexFormat()] << "\",\n";
+    out << "  \"vertex_size_bytes\": " << UGetVertexSize() << ",\n";
+    out << "  \"lod_scale\": " << UGetLodScale() << ",\n";
+    out << "  \"culling\": \"" << (UGetCulling() ? "bvh" : "off") << "\",\n";
+    out << "  \"occlusion\": \"" << (UGetOcclusionCulling() ? "software_hiz" : "off") << "\",\n";
+    out << "  \"occlusion_buffer\": \"" << OCCLUSION_WIDTH << "x" << OCCLUSION_HEIGHT << "\",\n";
+    out << "  \"animated_instances\": " << animated << ",\n";
+    out << "  \"camera_path\": \"" << (gPathFile.empty() ? "orbit" : gPathFile) << "\",\n";
+    const TextureLoadStats& textureLoad = UGetTextureLoadStats();
+    out << "  \"texture_loading\": { \"mode\": \"" << (gAsyncTextures ? (gStreamTextures ? "streamed" : "async") : "sync")
+        << "\", \"flip\": \"" << (UGetFlipTexturesOnDecode() ? "decode" : "copy")
+        << "\", \"upload\": \"" << (UGetPixelBufferUploads() ? "pbo" : "blit") << "\", \"pixel_buffer_slots\": " << textureLoad.pixelBufferSlots
+        << ", \"textures\": " << textureLoad.textures << ", \"baked\": " << textureLoad.baked
+        << ", \"format\": \"" << UTextureFormatName(UGetTextureFormat()) << "\", \"texture_bytes\": " << textureLoad.textureBytes << ", \"decode_threads\": " << textureLoad.decodeThreads
+        << ", \"scene_create_ms\": " << sceneCreateMs << ", \"textures_ready_ms\": " << textureLoad.readyMs
+        << ", \"slowest_decode_ms\": " << textureLoad.slowestDecodeMs << ", \"total_decode_ms\": " << textureLoad.totalDecodeMs
+        << ", \"slowest_upload_ms\": " << textureLoad.slowestUploadMs << ", \"total_upload_ms\": " << textureLoad.totalUploadMs << " },\n";
+    UWriteTiming(out, "cpu_frame_ms", USummarize(cpuTimes));
+    UWriteTiming(out, "gpu_wait_frame_ms", USummarize(frameTimes));
+    out << "  \"per_frame\": {\n";
+    out << "    \"draw_calls\": " << drawCalls / frames << ",\n";
+    out << "    \"state_changes\": " << stateChanges / frames << ",\n";
+    out << "    \"program_binds\": " << totals.programBinds / frames << ",\n";
+    out << "    \"vertex_array_binds\": " << totals.vertexArrayBinds / frames << ",\n";
+    out << "    \"texture_unit_changes\": " << totals.textureUnitChanges / frames << ",\n";
+    out << "    \"texture_binds\": " << totals.textureBinds / frames << ",\n";
+    out << "    \"texture_parameter_changes\": " << totals.textureParameterChanges / frames << ",\n";
+    out << "    \"buffer_binds\": " << totals.bufferBinds / frames << ",\n";
+    out << "    \"uniform_uploads\": " << totals.uniformUploads / frames << ",\n";
+    out << "    \"buffer_uploads\": " << totals.bufferUploads / frames << ",\n";
+    out << "    \"transform_updates\": " << totals.transformUpdates / frames << ",\n";
+    out << "    \"avoided_binds\": " << totals.avoidedBinds / frames << ",\n";
+    out << "    \"vertex_bytes\": " << vertexBytes / frames << ",\n";
+    out << "    \"triangles\": " << triangles / frames << ",\n";
+    out << "    \"visible_instances\": " << visibleInstances / frames << ",\n";
+    out << "    \"culled_instances\": " << culledInstances / frames << ",\n";
+    out << "    \"occluded_instances\": " << occludedInstances / frames << ",\n";
+    out << "    \"occluders\": " << occluders / frames << ",\n";
+    out << "    \"occluder_triangles\": " << occluderTriangles / frames << ",\n";
+    out << "    \"texture_uploads\": " << textureUploads / frames << ",\n";
+    out << "    \"lod_instances\": [";
+    for (unsigned level = 0; level < PRIMITIVE_MAX_LODS; ++level)
+        out << (level ? ", " : " ") << lodInstances[level] / frames;
+    out << " ]\n";
+    out << "  }" << (gDiffFrames > 0 ? ",\n" : "\n");
+    if (gDiffFrames > 0)
+    {
+        out << "  \"software_diff\": { \"frames\": " << gDiffFrames << ", \"min_psnr_db\": " << worstPsnr << ", \"mean_psnr_db\": " << meanPsnr
+            << ", \"max_difference\": " << maxDifference << ", \"mean_difference\": " << meanDifference
+            << ", \"differing_pixels\": " << differingPixels << ", \"threads\": " << gSoftwareRenderStats.threads << " }\n";
+    }
+    out << "}" << endl;
+
+    UDestroyScene();
+    UDestroyHeadless();
+
+    if (gDiffFrames > 0 && worstPsnr < gMinPsnr)
+    {
+        cerr << "Software renderer differs from GL: " << worstPsnr << " dB PSNR, below " << gMinPsnr << " dB" << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+// Sorts the samples and picks min, median, 99th percentile (nearest rank) and max
+TimingSummary USummarize(vector<double> samples)
+{
+    TimingSummary timing = {};
+    if (samples.empty())
+        return timing;
+
+    sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    size_t p99Rank = (size_t)ceil(0.99 * count);
+
+    timing.min = samples.front();
+    timing.median = count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+    timing.p99 = samples[max<size_t>(p99Rank, 1) - 1];
+    timing.max = samples.back();
+    for (double sample : samples)
+        timing.mean += sample;
+    timing.mean /= count;
+    return timing;
+}
+
+
+// Writes one timing summary as a JSON object member
+void UWriteTiming(ostream& out, const char* name, const TimingSummary& timing)
+{
+    out << "  \"" << name << "\": { \"min\": " << timing.min << ", \"median\": " << timing.median
+        << ", \"p99\": " << timing.p99 << ", \"max\": " << timing.max << ", \"mean\": " << timing.mean << " },\n";
+}
@@ -0,0 +1,84 @@
+#include <iostream>         // cout, cerr
+#include <cstdlib>          // EXIT_FAILURE, atoi, atof
+#include <cstring>          // strcmp
+#include <string>
+#include <vector>
+
+#include "scene.h"          // Scene file loading and saving
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // --grid: copies of the scene per side, laid out on the XZ plane to build large benchmark scenes
+    int gGridSize = 1;
+    float gGridSpacing = 8.0f;
+
+    // --unique-textures: every copy gets its own entries in the texture table (same files), so a grid of N x N
+    // desks has N * N times as many textures to load, as a scene streaming many distinct textures would
+    bool gUniqueTextures = false;
+}
+
+
+// Compiles a text scene into the binary format the renderer loads without parsing,
+// optionally replicating it on a grid: scene_compiler desk.scene desk.sceneb --grid 32 [--unique-textures]
+int main(int argc, char* argv[])
+{
+    vector<string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc)
+            gGridSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--spacing") == 0 && i + 1 < argc)
+            gGridSpacing = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--unique-textures") == 0)
+            gUniqueTextures = true;
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.size() != 2 || gGridSize <= 0)
+    {
+        cerr << "usage: scene_compiler <input.scene> <output.sceneb> [--grid N] [--spacing units] [--unique-textures]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    SceneDescription scene;
+    if (!ULoadScene(files[0], scene))
+        return EXIT_FAILURE;
+
+    if (gGridSize > 1)
+    {
+        // Centre the grid on the original scene so the default camera still looks at the middle
+        const vector<SceneInstance> source = scene.instances;
+        const vector<SceneTexture> sourceTextures = scene.textures;
+        const float origin = -0.5f * (gGridSize - 1) * gGridSpacing;
+
+        scene.instances.clear();
+        scene.instances.reserve(source.size() * gGridSize * gGridSize);
+        for (int z = 0; z < gGridSize; ++z)
+        {
+            for (int x = 0; x < gGridSize; ++x)
+            {
+                const glm::vec3 offset(origin + x * gGridSpacing, 0.0f, origin + z * gGridSpacing);
+                const int32_t firstTexture = gUniqueTextures ? (int32_t)((z * gGridSize + x) * sourceTextures.size()) : 0;
+                if (gUniqueTextures && firstTexture > 0)
+                    scene.textures.insert(scene.textures.end(), sourceTextures.begin(), sourceTextures.end());
+                for (SceneInstance instance : source)
+                {
+                    instance.position += offset;
+                    if (instance.texture != SCENE_NO_TEXTURE)
+                        instance.texture += firstTexture;
+                    scene.instances.push_back(instance);
+                }
+            }
+        }
+    }
+
+    if (!USaveSceneBinary(files[1], scene))
+        return EXIT_FAILURE;
+
+    cout << "INFO: Wrote " << scene.instances.size() << " instances and " << scene.textures.size()
+         << " textures to " << files[1] << endl;
+    return EXIT_SUCCESS;
+}
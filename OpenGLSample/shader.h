@@ -10,10 +10,14 @@
 #include <sstream>
 #include <iostream>
 
+#include "uniform_table.h"
+
 class Shader
 {
 public:
 	unsigned int ID;
+	// active uniforms of the program, queried once after linking
+	UniformTable uniforms;
 	// constructor generates the shader on the fly
 	// ------------------------------------------------------------------------
 	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
@@ -90,6 +94,7 @@ public:
 			glAttachShader(ID, geometry);
 		glLinkProgram(ID);
 		checkCompileErrors(ID, "PROGRAM");
+		uniforms.Build(ID);
 		// delete the shaders as they're linked into our program now and no longer necessery
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
@@ -103,63 +108,128 @@ public:
 	{
 		glUseProgram(ID);
 	}
-	// utility uniform functions
+	// cached location of a uniform, -1 if the program does not use it. Resolve the locations a frame needs once,
+	// after construction, and pass them to the setters below: per frame that is a plain glUniform call.
+	// ------------------------------------------------------------------------
+	GLint getLocation(const std::string &name) const
+	{
+		return uniforms.Location(name);
+	}
+	// utility uniform functions taking a location from getLocation (or uniforms.Resolve)
+	// ------------------------------------------------------------------------
+	void setBool(GLint location, bool value) const
+	{
+		glUniform1i(location, (int)value);
+	}
+	// ------------------------------------------------------------------------
+	void setInt(GLint location, int value) const
+	{
+		glUniform1i(location, value);
+	}
+	// ------------------------------------------------------------------------
+	void setFloat(GLint location, float value) const
+	{
+		glUniform1f(location, value);
+	}
+	// ------------------------------------------------------------------------
+	void setVec2(GLint location, const glm::vec2 &value) const
+	{
+		glUniform2fv(location, 1, &value[0]);
+	}
+	void setVec2(GLint location, float x, float y) const
+	{
+		glUniform2f(location, x, y);
+	}
+	// ------------------------------------------------------------------------
+	void setVec3(GLint location, const glm::vec3 &value) const
+	{
+		glUniform3fv(location, 1, &value[0]);
+	}
+	void setVec3(GLint location, float x, float y, float z) const
+	{
+		glUniform3f(location, x, y, z);
+	}
+	// ------------------------------------------------------------------------
+	void setVec4(GLint location, const glm::vec4 &value) const
+	{
+		glUniform4fv(location, 1, &value[0]);
+	}
+	void setVec4(GLint location, float x, float y, float z, float w) const
+	{
+		glUniform4f(location, x, y, z, w);
+	}
+	// ------------------------------------------------------------------------
+	void setMat2(GLint location, const glm::mat2 &mat) const
+	{
+		glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+	}
+	// ------------------------------------------------------------------------
+	void setMat3(GLint location, const glm::mat3 &mat) const
+	{
+		glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+	}
+	// ------------------------------------------------------------------------
+	void setMat4(GLint location, const glm::mat4 &mat) const
+	{
+		glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+	}
+	// the same by name, for setup code: each call looks the name up in the table
 	// ------------------------------------------------------------------------
 	void setBool(const std::string &name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+		setBool(uniforms.Location(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string &name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+		setInt(uniforms.Location(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string &name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+		setFloat(uniforms.Location(name), value);
 	}
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string &name, const glm::vec2 &value) const
 	{
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec2(uniforms.Location(name), value);
 	}
 	void setVec2(const std::string &name, float x, float y) const
 	{
-		glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+		setVec2(uniforms.Location(name), x, y);
 	}
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string &name, const glm::vec3 &value) const
 	{
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec3(uniforms.Location(name), value);
 	}
 	void setVec3(const std::string &name, float x, float y, float z) const
 	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+		setVec3(uniforms.Location(name), x, y, z);
 	}
 	// ------------------------------------------------------------------------
 	void setVec4(const std::string &name, const glm::vec4 &value) const
 	{
-		glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		setVec4(uniforms.Location(name), value);
 	}
-	void setVec4(const std::string &name, float x, float y, float z, float w)
+	void setVec4(const std::string &name, float x, float y, float z, float w) const
 	{
-		glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+		setVec4(uniforms.Location(name), x, y, z, w);
 	}
 	// ------------------------------------------------------------------------
 	void setMat2(const std::string &name, const glm::mat2 &mat) const
 	{
-		glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat2(uniforms.Location(name), mat);
 	}
 	// ------------------------------------------------------------------------
 	void setMat3(const std::string &name, const glm::mat3 &mat) const
 	{
-		glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat3(uniforms.Location(name), mat);
 	}
 	// ------------------------------------------------------------------------
 	void setMat4(const std::string &name, const glm::mat4 &mat) const
 	{
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		setMat4(uniforms.Location(name), mat);
 	}
 
 private:
@@ -0,0 +1,70 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Widest instruction set the compiler was allowed to use: AVX with -march=native (or /arch:AVX),
+// otherwise SSE, which every x86-64 target has. Neither defined: callers fall back to scalar loops.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_SSE
+#endif
+
+#include <cstddef>
+
+// The few float operations the culling and rasterizing loops need, SIMD_WIDTH lanes at a time.
+// Comparisons return all-ones lanes where true, for USimdAnd, USimdSelect and USimdMask.
+#if defined(SIMD_AVX)
+typedef __m256 SimdFloat;
+const size_t SIMD_WIDTH = 8;
+inline SimdFloat USimdLoad(const float* values) { return _mm256_loadu_ps(values); }
+inline void USimdStore(float* values, SimdFloat a) { _mm256_storeu_ps(values, a); }
+inline SimdFloat USimdSplat(float value) { return _mm256_set1_ps(value); }
+inline SimdFloat USimdRamp() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+inline SimdFloat USimdAdd(SimdFloat a, SimdFloat b) { return _mm256_add_ps(a, b); }
+inline SimdFloat USimdMul(SimdFloat a, SimdFloat b) { return _mm256_mul_ps(a, b); }
+inline SimdFloat USimdMulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+inline SimdFloat USimdNegate(SimdFloat a) { return _mm256_sub_ps(_mm256_setzero_ps(), a); }
+inline SimdFloat USimdMin(SimdFloat a, SimdFloat b) { return _mm256_min_ps(a, b); }
+inline SimdFloat USimdGreaterEqual(SimdFloat a, SimdFloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+inline SimdFloat USimdGreater(SimdFloat a, SimdFloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline SimdFloat USimdAnd(SimdFloat a, SimdFloat b) { return _mm256_and_ps(a, b); }
+inline SimdFloat USimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm256_blendv_ps(b, a, mask); }
+inline SimdFloat USimdTrue() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+inline int USimdMask(SimdFloat a) { return _mm256_movemask_ps(a); }
+#elif defined(SIMD_SSE)
+typedef __m128 SimdFloat;
+const size_t SIMD_WIDTH = 4;
+inline SimdFloat USimdLoad(const float* values) { return _mm_loadu_ps(values); }
+inline void USimdStore(float* values, SimdFloat a) { _mm_storeu_ps(values, a); }
+inline SimdFloat USimdSplat(float value) { return _mm_set1_ps(value); }
+inline SimdFloat USimdRamp() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+inline SimdFloat USimdAdd(SimdFloat a, SimdFloat b) { return _mm_add_ps(a, b); }
+inline SimdFloat USimdMul(SimdFloat a, SimdFloat b) { return _mm_mul_ps(a, b); }
+inline SimdFloat USimdMulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline SimdFloat USimdNegate(SimdFloat a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+inline SimdFloat USimdMin(SimdFloat a, SimdFloat b) { return _mm_min_ps(a, b); }
+inline SimdFloat USimdGreaterEqual(SimdFloat a, SimdFloat b) { return _mm_cmpge_ps(a, b); }
+inline SimdFloat USimdGreater(SimdFloat a, SimdFloat b) { return _mm_cmpgt_ps(a, b); }
+inline SimdFloat USimdAnd(SimdFloat a, SimdFloat b) { return _mm_and_ps(a, b); }
+inline SimdFloat USimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline SimdFloat USimdTrue() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+inline int USimdMask(SimdFloat a) { return _mm_movemask_ps(a); }
+#else
+const size_t SIMD_WIDTH = 1;
+#endif
+
+// "avx", "sse" or "scalar"
+inline const char* USimdInstructionSet()
+{
+#if defined(SIMD_AVX)
+    return "avx";
+#elif defined(SIMD_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <iostream>         // cout, cerr
+#include <fstream>          // ofstream
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp
+#include <chrono>           // steady_clock
+#include <cmath>            // ceil
+#include <string>
+#include <thread>           // hardware_concurrency
+#include <vector>
+#include <algorithm>        // sort
+
+#include "software_renderer.h"  // CPU rasterizer, no GL needed
+#include "camera_path.h"    // Scripted camera motion
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Frames rendered before and during the measurement of every thread count
+    int gWarmupFrames = 3;
+    int gBenchFrames = 60;
+
+    // Simulated time step between frames, as scene_bench
+    const float FRAME_STEP = 1.0f / 60.0f;
+
+    // Size of the frames, the viewer's window size
+    const int FRAME_WIDTH = 800;
+    const int FRAME_HEIGHT = 600;
+
+    // Scene to draw, path file to replay (empty: orbit the scene), where to write the report (empty: stdout)
+    // and the last frame (empty: nowhere)
+    string gSceneFile = DEFAULT_SCENE_FILE;
+    string gPathFile;
+    string gOutputFile;
+    string gImageFile;
+
+    // --threads: measure this thread count only (0: 1, 2, 4... up to every hardware thread)
+    unsigned gThreads = 0;
+
+    // --lod-scale: as scene_bench
+    float gLodScale = 1.0f;
+
+    // Frame times at one thread count, with the average time of each stage and the work per frame
+    struct ThreadRun
+    {
+        unsigned threads;
+        double minMs, medianMs, p99Ms;
+        double geometryMs, rasterMs;
+        double triangles, binnedTriangles, shadedPixels, visibleInstances;
+    };
+}
+
+
+// Renders the scene on the CPU along the camera path at increasing thread counts and reports frame times,
+// speedups and the pipeline's work per frame as JSON. Needs no GPU, display or GL library.
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            gBenchFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            gWarmupFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+            gSceneFile = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            gThreads = (unsigned)max(atoi(argv[++i]), 0);
+        else if (strcmp(argv[i], "--lod-scale") == 0 && i + 1 < argc)
+            gLodScale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc)
+            gPathFile = argv[++i];
+        else if (strcmp(argv[i], "--image") == 0 && i + 1 < argc)
+            gImageFile = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            gOutputFile = argv[++i];
+        else
+        {
+            cerr << "usage: software_bench [--frames N] [--warmup N] [--scene file] [--threads N] [--lod-scale S] [--path camera.path] [--image frame.ppm] [--output report.json]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (gBenchFrames <= 0)
+        gBenchFrames = 1;
+
+    CameraPath path;
+    if (!gPathFile.empty())
+    {
+        if (!path.Load(gPathFile))
+        {
+            cerr << "Failed to load camera path " << gPathFile << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        path = CameraPath::Orbit(glm::vec3(0.0f, 0.0f, 0.5f), 5.0f, 2.0f, 10.0f);
+    }
+
+    // Thread counts to measure: doubling up to the hardware's, which is always included
+    const unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    if (gThreads > 0)
+        threadCounts.push_back(gThreads);
+    else
+    {
+        for (unsigned threads = 1; threads < hardwareThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+    USoftwareSetThreads(threadCounts.back());
+    if (!USoftwareCreateScene(gSceneFile))
+        return EXIT_FAILURE;
+    const double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+    USoftwareSetLodScale(gLodScale);
+
+    Camera camera;
+    SoftwareFramebuffer framebuffer;
+    framebuffer.Resize(FRAME_WIDTH, FRAME_HEIGHT);
+
+    vector<ThreadRun> runs;
+    for (unsigned threads : threadCounts)
+    {
+        USoftwareSetThreads(threads);
+        for (int frame = 0; frame < gWarmupFrames; ++frame)
+        {
+            path.Apply(camera, frame * FRAME_STEP);
+            USoftwareRender(camera, true, framebuffer);
+        }
+
+        ThreadRun run = {};
+        run.threads = threads;
+        vector<double> frameTimes;
+        for (int frame = 0; frame < gBenchFrames; ++frame)
+        {
+            path.Apply(camera, frame * FRAME_STEP);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            USoftwareRender(camera, true, framebuffer);
+            frameTimes.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+
+            run.geometryMs += gSoftwareRenderStats.geometryMs / gBenchFrames;
+            run.rasterMs += gSoftwareRenderStats.rasterMs / gBenchFrames;
+            run.triangles += (double)gSoftwareRenderStats.triangles / gBenchFrames;
+            run.binnedTriangles += (double)gSoftwareRenderStats.binnedTriangles / gBenchFrames;
+            run.shadedPixels += (double)gSoftwareRenderStats.shadedPixels / gBenchFrames;
+            run.visibleInstances += (double)gSoftwareRenderStats.visibleInstances / gBenchFrames;
+        }
+
+        sort(frameTimes.begin(), frameTimes.end());
+        const size_t count = frameTimes.size();
+        run.minMs = frameTimes.front();
+        run.medianMs = count % 2 ? frameTimes[count / 2] : 0.5 * (frameTimes[count / 2 - 1] + frameTimes[count / 2]);
+        run.p99Ms = frameTimes[max<size_t>((size_t)ceil(0.99 * count), 1) - 1];
+        runs.push_back(run);
+    }
+
+    if (!gImageFile.empty() && !UWriteFramebufferImage(framebuffer, gImageFile))
+        cerr << "Failed to write image " << gImageFile << endl;
+
+    // Report
+    // ------
+    ofstream outputFile;
+    if (!gOutputFile.empty())
+        outputFile.open(gOutputFile);
+    ostream& out = gOutputFile.empty() ? cout : outputFile;
+
+    out << "{\n";
+    out << "  \"renderer\": \"software\",\n";
+    out << "  \"frames\": " << gBenchFrames << ",\n";
+    out << "  \"scene\": \"" << gSceneFile << "\",\n";
+    out << "  \"resolution\": \"" << FRAME_WIDTH << "x" << FRAME_HEIGHT << "\",\n";
+    out << "  \"tile_size\": " << SOFTWARE_TILE_SIZE << ",\n";
+    out << "  \"hardware_threads\": " << hardwareThreads << ",\n";
+    out << "  \"scene_load_ms\": " << loadMs << ",\n";
+    out << "  \"camera_path\": \"" << (gPathFile.empty() ? "orbit" : gPathFile) << "\",\n";
+    out << "  \"runs\": [\n";
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        const ThreadRun& run = runs[r];
+        out << "    { \"threads\": " << run.threads << ", \"frame_ms\": { \"min\": " << run.minMs << ", \"median\": " << run.medianMs
+            << ", \"p99\": " << run.p99Ms << " }, \"speedup\": " << runs.front().medianMs / run.medianMs
+            << ", \"geometry_ms\": " << run.geometryMs << ", \"raster_ms\": " << run.rasterMs << ",\n";
+        out << "      \"per_frame\": { \"visible_instances\": " << run.visibleInstances << ", \"triangles\": " << run.triangles
+            << ", \"binned_triangles\": " << run.binnedTriangles << ", \"shaded_pixels\": " << run.shadedPixels << " } }"
+            << (r + 1 < runs.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}" << endl;
+
+    USoftwareDestroyScene();
+
+    return EXIT_SUCCESS;
+}
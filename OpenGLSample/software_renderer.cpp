@@ -0,0 +1,927 @@
+#include <iostream>         // cout
+#include <fstream>          // ofstream
+#include <algorithm>        // min, max, fill
+#include <chrono>           // steady_clock
+#include <cmath>            // ceil, floor, pow, log2
+#include <limits>           // numeric_limits
+#include <memory>           // unique_ptr
+#include <utility>          // swap
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "stb_image.h"      // Image loading Utility functions
+
+#include "software_renderer.h"
+#include "frustum.h"        // View frustum culling
+#include "mesh_optimizer.h" // Same triangle order as the GL meshes
+#include "simd.h"           // SSE or AVX wrappers
+#include "image.h"          // Resampling to the layer size
+#include "texture_container.h"  // Baked textures
+#include "job_system.h"     // Work-stealing jobs
+
+using namespace std; // Standard namespace
+
+/* CPU rendering of the scene, for machines without a GPU. The pipeline is a sort-middle tiled rasterizer:
+ *
+ *   1. Geometry: the visible instances are split into runs of about equal triangle counts, one task each.
+ *      A task transforms its vertices, clips its triangles, snaps them to the GPU's subpixel grid and appends
+ *      each one to the bin of every screen tile its bounds overlap. Tasks keep their own bins, so nothing is shared.
+ *   2. Tiles: one task per tile walks the bins of every geometry task in order, keeps the nearest triangle at each
+ *      pixel (edge functions and depth evaluated SIMD_WIDTH pixels at a time), then shades each pixel once with
+ *      the Phong model of the GL fragment shader, interpolating the vertex attributes perspective-correctly.
+ *
+ * Both stages run as jobs on a work-stealing job system. Bins are read in the geometry tasks' order whichever thread filled
+ * them, so the picture does not depend on the thread count. Edge functions are evaluated directly at every pixel
+ * rather than stepped, and a pixel exactly on an edge belongs to the triangle whose edge is a top or left one,
+ * so triangles sharing an edge neither overlap nor leave gaps.
+ */
+
+// Work done by the last USoftwareRender call
+SoftwareRenderStats gSoftwareRenderStats;
+
+// Unnamed namespace
+namespace
+{
+    // Width and height every texture is resampled to, like the layers of the GL renderer's texture array
+    const int TEXTURE_LAYER_SIZE = 1024;
+
+    // Clip distances of URender's projections
+    const float NEAR_PLANE = 0.1f;
+    const float FAR_PLANE = 100.0f;
+
+    // Triangles are only clipped against the sides of the view once they reach this many half screens past its
+    // center; closer ones are rasterized whole and their outside pixels skipped, which is cheaper than clipping
+    const float GUARD_BAND = 4.0f;
+
+    // Vertices snap to 1/256 pixel, the GPU's 8 bits of subpixel precision
+    const float SUBPIXEL_STEPS = 256.0f;
+
+    // The visibility buffer refers to a triangle by its geometry task (high 8 bits) and its index in the task
+    const size_t MAX_GEOMETRY_TASKS = 256;
+    const uint32_t TRIANGLE_INDEX_BITS = 24;
+    const uint32_t NO_TRIANGLE = 0xFFFFFFFFu;
+
+    // Geometry tasks per thread, so that threads that finish early can steal some
+    const size_t GEOMETRY_TASKS_PER_THREAD = 4;
+
+    // The Phong terms of fragmentShaderSource
+    const float AMBIENT_STRENGTH = 0.22f;
+    const float SPECULAR_INTENSITY = 0.9f;
+    const float HIGHLIGHT_SIZE = 16.0f;
+
+    // Detail levels of a primitive, reordered like the GL meshes, and the bounds of all of them
+    struct SoftwareMesh
+    {
+        vector<MeshData> levels;
+        glm::vec4 sphere = glm::vec4(0.0f);     // center in xyz, radius in w
+        glm::vec3 boxCenter = glm::vec3(0.0f);
+        glm::vec3 boxExtent = glm::vec3(0.0f);
+    };
+
+    // Vertex after the vertex stage: clip-space position and what the fragment stage interpolates
+    struct ShadedVertex
+    {
+        glm::vec4 clip;
+        glm::vec3 world;
+        glm::vec3 normal;
+        glm::vec2 uv;           // scaled by the instance's uv scale
+    };
+
+    // Triangle ready to rasterize: snapped window coordinates, counter-clockwise, and the pixels its bounds cover
+    struct RasterTriangle
+    {
+        float x[3], y[3], z[3], inverseW[3];
+        uint32_t vertex[3];     // in the geometry task's vertex list
+        uint32_t instance;
+        int minX, maxX, minY, maxY;
+    };
+
+    // A run of visible instances and what the geometry stage made of them
+    struct GeometryTask
+    {
+        size_t first = 0, end = 0;              // range of gVisibleInstances
+        vector<ShadedVertex> vertices;
+        vector<RasterTriangle> triangles;
+        vector<vector<uint32_t>> bins;          // triangle indices, one list per tile
+    };
+
+    // Nearest depth and triangle at every pixel of the tile a thread is working on
+    struct TileBuffer
+    {
+        float depth[SOFTWARE_TILE_SIZE * SOFTWARE_TILE_SIZE];
+        uint32_t triangle[SOFTWARE_TILE_SIZE * SOFTWARE_TILE_SIZE];
+    };
+
+    // Camera, light and screen of the frame being rendered
+    struct FrameSetup
+    {
+        glm::mat4 viewProjection;
+        glm::vec3 cameraPosition;
+        int width, height;
+        int tilesX, tilesY;
+    };
+
+    // Signed distance of a clip-space point to one of the planes triangles are clipped against: near, far,
+    // then the four sides of the guard band. Inside is positive.
+    const int CLIP_PLANE_COUNT = 6;
+    inline float UClipDistance(const glm::vec4& clip, int plane)
+    {
+        switch (plane)
+        {
+        case 0: return clip.z + clip.w;
+        case 1: return clip.w - clip.z;
+        case 2: return GUARD_BAND * clip.w + clip.x;
+        case 3: return GUARD_BAND * clip.w - clip.x;
+        case 4: return GUARD_BAND * clip.w + clip.y;
+        default: return GUARD_BAND * clip.w - clip.y;
+        }
+    }
+
+    // Edge function of the edge from a to b: A * x + B * y + C, positive on the left (inside a counter-clockwise triangle).
+    // A pixel center exactly on the edge is inside only for top edges (horizontal, interior below) and left edges
+    // (going down, in GL's y-up window coordinates).
+    struct EdgeFunction
+    {
+        float a, b, c;
+        bool topLeft;
+
+        EdgeFunction(float fromX, float fromY, float toX, float toY)
+            : a(fromY - toY), b(toX - fromX), c(fromX * toY - fromY * toX),
+              topLeft(toY < fromY || (toY == fromY && toX < fromX))
+        {
+        }
+    };
+
+    // Every Scene_Mesh primitive
+    SoftwareMesh gMeshes[SCENE_MESH_COUNT];
+
+    // One RGBA8 layer per scene texture, row 0 at the bottom like a GL texture, followed by its mip chain
+    vector<vector<uint8_t>> gTextureLayers;
+
+    SceneDescription gScene;
+    TransformStore gTransforms;
+
+    // World bounds of every instance, refreshed when its transform changes, whether it is in the view this frame,
+    // and the detail level it is drawn with
+    BoundingSpheres gInstanceSpheres;
+    BoundingBoxes gInstanceBoxes;
+    vector<uint8_t> gInstanceVisible;
+    vector<uint8_t> gInstanceLods;
+    vector<uint32_t> gVisibleInstances;
+    float gLodScale = 1.0f;
+
+    // Worker threads: gOwnedJobs, created on first use with gThreads threads (0: every hardware thread), or the
+    // job system given to USoftwareSetJobSystem, so a program running both renderers keeps one worker per core
+    unique_ptr<JobSystem> gOwnedJobs;
+    JobSystem* gJobs = nullptr;
+    unsigned gThreads = 0;
+
+    vector<GeometryTask> gGeometryTasks;
+    vector<TileBuffer> gTileBuffers;            // one per thread
+    vector<unsigned> gTileShadedPixels;         // one per tile
+}
+
+
+/* Internal function prototypes to:
+ * load a texture into a layer,
+ * build a primitive's detail levels, update the instance bounds, pick the visible instances and their detail levels,
+ * run the geometry stage of one task, clip and set up its triangles,
+ * rasterize, shade and write out one tile, sample one level of a texture layer, and filter between its levels
+ */
+bool ULoadTextureLayer(const string& texturePath, vector<uint8_t>& layer);
+void UCreateSoftwareMesh(Scene_Mesh mesh);
+void UUpdateSoftwareBounds();
+void USelectVisibleInstances(const glm::mat4& viewProjection, const glm::mat4& projection, const glm::vec3& cameraPosition);
+void URunGeometryTask(GeometryTask& task, const FrameSetup& frame);
+void UClipTriangle(GeometryTask& task, const FrameSetup& frame, const uint32_t* vertices, uint32_t instance);
+void USetupTriangle(GeometryTask& task, const FrameSetup& frame, uint32_t v0, uint32_t v1, uint32_t v2, uint32_t instance);
+void URasterizeTile(size_t tile, TileBuffer& buffer, const FrameSetup& frame);
+void URasterizeTriangle(const RasterTriangle& triangle, uint32_t reference, TileBuffer& buffer, int tileX, int tileY);
+unsigned UShadeTile(size_t tile, const TileBuffer& buffer, const FrameSetup& frame, SoftwareFramebuffer& framebuffer);
+glm::vec3 USampleLevel(const uint8_t* level, int size, const glm::vec2& uv);
+glm::vec3 USampleLayer(const vector<uint8_t>& layer, const glm::vec2& uv, const glm::vec2& uvDx, const glm::vec2& uvDy);
+glm::vec3 UShadePixel(const RasterTriangle& triangle, const GeometryTask& task, float centerX, float centerY, const FrameSetup& frame);
+
+
+// Loads the scene file, then generates its meshes and loads its textures, one job each
+bool USoftwareCreateScene(const string& sceneFile)
+{
+    USoftwareDestroyScene();
+    if (!ULoadScene(sceneFile, gScene))
+        return false;
+
+    gTransforms.Reserve(gScene.instances.size());
+    for (const SceneInstance& instance : gScene.instances)
+        gTransforms.Add(instance.position, instance.rotation, instance.scale);
+
+    if (!gJobs)
+        USoftwareSetThreads(gThreads);
+
+    gJobs->ParallelFor(SCENE_MESH_COUNT, 1, [](size_t begin, size_t end, unsigned)
+        {
+            for (size_t mesh = begin; mesh < end; ++mesh)
+                UCreateSoftwareMesh((Scene_Mesh)mesh);
+        });
+
+    gTextureLayers.resize(gScene.textures.size());
+    vector<uint8_t> loaded(gScene.textures.size(), 0);
+    gJobs->ParallelFor(gScene.textures.size(), 1, [&](size_t begin, size_t end, unsigned)
+        {
+            for (size_t texture = begin; texture < end; ++texture)
+                loaded[texture] = ULoadTextureLayer(gScene.textures[texture].path, gTextureLayers[texture]);
+        });
+    for (size_t texture = 0; texture < gScene.textures.size(); ++texture)
+    {
+        if (!loaded[texture])
+        {
+            cout << "Failed to load texture " << RESOURCE_DIR "/" << gScene.textures[texture].path << endl;
+            return false;
+        }
+    }
+
+    const size_t count = gScene.instances.size();
+    gInstanceSpheres.Resize(count);
+    gInstanceBoxes.Resize(count);
+    gInstanceVisible.assign(count, 0);
+    gInstanceLods.assign(count, 0);
+    return true;
+}
+
+
+// Releases the scene's meshes, textures and per-instance data; the threads stay for the next scene
+void USoftwareDestroyScene()
+{
+    gScene = SceneDescription();
+    gTransforms.Clear();
+    for (SoftwareMesh& mesh : gMeshes)
+        mesh = SoftwareMesh();
+    gTextureLayers.clear();
+    gInstanceSpheres.Resize(0);
+    gInstanceBoxes.Resize(0);
+    gInstanceVisible.clear();
+    gInstanceLods.clear();
+    gVisibleInstances.clear();
+    gGeometryTasks.clear();
+}
+
+
+// Transforms of the scene's instances, in scene order
+TransformStore& USoftwareGetTransforms()
+{
+    return gTransforms;
+}
+
+
+// Restarts the job system with this many threads, the caller included; 0 uses every hardware thread
+void USoftwareSetThreads(unsigned threads)
+{
+    gThreads = threads;
+    gJobs = nullptr;
+    gOwnedJobs.reset();
+    gOwnedJobs.reset(new JobSystem(threads));
+    gJobs = gOwnedJobs.get();
+    gTileBuffers.resize(gJobs->ThreadCount());
+}
+
+
+// Renders with another job system, such as the GL renderer's, and stops the software renderer's own threads.
+// jobs must outlive the frames rendered with it; USoftwareSetThreads goes back to owned threads.
+void USoftwareSetJobSystem(JobSystem& jobs)
+{
+    gOwnedJobs.reset();
+    gJobs = &jobs;
+    gThreads = jobs.ThreadCount();
+    gTileBuffers.resize(gJobs->ThreadCount());
+}
+
+
+// Threads rendering the frames, the caller included
+unsigned USoftwareGetThreads()
+{
+    if (!gJobs)
+        USoftwareSetThreads(gThreads);
+    return gJobs->ThreadCount();
+}
+
+
+// Scales the screen sizes at which instances switch to coarser detail levels, like USetLodScale
+void USoftwareSetLodScale(float scale)
+{
+    gLodScale = max(scale, 0.0f);
+}
+
+
+// Renders the scene as URender would: same projection, culling, detail levels, depth test and Phong shading
+void USoftwareRender(const Camera& camera, bool isPerspectiveView, SoftwareFramebuffer& framebuffer)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    if (!gJobs)
+        USoftwareSetThreads(gThreads);
+    gSoftwareRenderStats = SoftwareRenderStats();
+    gSoftwareRenderStats.threads = gJobs->ThreadCount();
+
+    FrameSetup frame;
+    frame.width = framebuffer.width;
+    frame.height = framebuffer.height;
+    frame.tilesX = (frame.width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    frame.tilesY = (frame.height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    frame.cameraPosition = camera.Position;
+    if (frame.width <= 0 || frame.height <= 0)
+        return;
+    framebuffer.color.resize((size_t)frame.width * frame.height * 4);
+
+    const glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 projection;
+    if (isPerspectiveView)
+        projection = glm::perspective(glm::radians(camera.Zoom), (float)frame.width / (float)frame.height, NEAR_PLANE, FAR_PLANE);
+    else
+        projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, NEAR_PLANE, FAR_PLANE);
+    frame.viewProjection = projection * view;
+
+    gTransforms.Update(*gJobs);
+    UUpdateSoftwareBounds();
+    USelectVisibleInstances(frame.viewProjection, projection, frame.cameraPosition);
+
+    // Split the visible instances into runs of about the same number of triangles
+    size_t totalTriangles = 0;
+    for (uint32_t instance : gVisibleInstances)
+        totalTriangles += gMeshes[gScene.instances[instance].mesh].levels[gInstanceLods[instance]].TriangleCount();
+    const size_t taskCount = min(MAX_GEOMETRY_TASKS, max<size_t>(1, min(gVisibleInstances.size(), gJobs->ThreadCount() * GEOMETRY_TASKS_PER_THREAD)));
+    const size_t trianglesPerTask = (totalTriangles + taskCount - 1) / taskCount;
+
+    const size_t tileCount = (size_t)frame.tilesX * frame.tilesY;
+    gGeometryTasks.resize(taskCount);
+    size_t next = 0;
+    for (size_t t = 0; t < taskCount; ++t)
+    {
+        GeometryTask& task = gGeometryTasks[t];
+        task.first = next;
+        size_t triangles = 0;
+        while (next < gVisibleInstances.size() && (triangles < trianglesPerTask || t + 1 == taskCount))
+        {
+            const uint32_t instance = gVisibleInstances[next++];
+            triangles += gMeshes[gScene.instances[instance].mesh].levels[gInstanceLods[instance]].TriangleCount();
+        }
+        task.end = next;
+        task.bins.resize(tileCount);
+    }
+
+    gJobs->ParallelFor(taskCount, 1, [&](size_t begin, size_t end, unsigned)
+        {
+            for (size_t task = begin; task < end; ++task)
+                URunGeometryTask(gGeometryTasks[task], frame);
+        });
+
+    for (const GeometryTask& task : gGeometryTasks)
+    {
+        gSoftwareRenderStats.triangles += (unsigned)task.triangles.size();
+        for (const vector<uint32_t>& bin : task.bins)
+            gSoftwareRenderStats.binnedTriangles += (unsigned)bin.size();
+    }
+    const chrono::steady_clock::time_point binned = chrono::steady_clock::now();
+
+    gTileShadedPixels.assign(tileCount, 0);
+    gJobs->ParallelFor(tileCount, 1, [&](size_t begin, size_t end, unsigned thread)
+        {
+            for (size_t tile = begin; tile < end; ++tile)
+            {
+                URasterizeTile(tile, gTileBuffers[thread], frame);
+                gTileShadedPixels[tile] = UShadeTile(tile, gTileBuffers[thread], frame, framebuffer);
+            }
+        });
+    for (unsigned pixels : gTileShadedPixels)
+        gSoftwareRenderStats.shadedPixels += pixels;
+
+    const chrono::steady_clock::time_point finished = chrono::steady_clock::now();
+    gSoftwareRenderStats.geometryMs = chrono::duration<double, milli>(binned - start).count();
+    gSoftwareRenderStats.rasterMs = chrono::duration<double, milli>(finished - binned).count();
+}
+
+
+// Writes the framebuffer top row first, as a binary PPM
+bool UWriteFramebufferImage(const SoftwareFramebuffer& framebuffer, const string& filename)
+{
+    ofstream file(filename, ios::binary);
+    if (!file)
+        return false;
+
+    file << "P6 " << framebuffer.width << " " << framebuffer.height << " 255\n";
+    vector<char> row((size_t)framebuffer.width * 3);
+    for (int y = framebuffer.height - 1; y >= 0; --y)
+    {
+        const uint8_t* pixel = &framebuffer.color[(size_t)y * framebuffer.width * 4];
+        for (int x = 0; x < framebuffer.width; ++x, pixel += 4)
+        {
+            row[x * 3] = (char)pixel[0];
+            row[x * 3 + 1] = (char)pixel[1];
+            row[x * 3 + 2] = (char)pixel[2];
+        }
+        file.write(row.data(), row.size());
+    }
+    return (bool)file;
+}
+
+
+// Loads a texture (a path below RESOURCE_DIR) flipped to GL's bottom-up rows and shrunk like the GL renderer builds
+// its texture array, with the same mip chain, from its bake if there is a current one
+bool ULoadTextureLayer(const string& texturePath, vector<uint8_t>& layer)
+{
+    layer.resize(UMipChainBytes(TEXTURE_LAYER_SIZE));
+    if (UReadBakedTexture(texturePath, TEXTURE_LAYER_SIZE, TEXTURE_FORMAT_RGBA8, layer.data()))
+        return true;
+
+    int width, height, channels;
+    unsigned char* image = stbi_load((string(RESOURCE_DIR "/") + texturePath).c_str(), &width, &height, &channels, 4);
+    if (!image)
+        return false;
+
+    UResampleToLayer(image, width, height, true, TEXTURE_LAYER_SIZE, layer.data());
+    UGenerateMipChain(layer.data(), TEXTURE_LAYER_SIZE);
+    stbi_image_free(image);
+    return true;
+}
+
+
+// Generates a primitive's detail levels and reorders them like UCreatePrimitiveMeshes, so both renderers
+// draw the same triangles; the bounds cover every level, as the GL renderer's do
+void UCreateSoftwareMesh(Scene_Mesh mesh)
+{
+    SoftwareMesh& software = gMeshes[mesh];
+    software.levels = UGenerateLodChain((Primitive_Shape)mesh);
+
+    glm::vec3 low(numeric_limits<float>::max()), high(-numeric_limits<float>::max());
+    for (MeshData& level : software.levels)
+    {
+        UOptimizeVertexCache(level.indices, level.VertexCount());
+        UOptimizeVertexFetch(level.vertices, level.indices, PRIMITIVE_FLOATS_PER_VERTEX);
+        for (size_t v = 0; v < level.vertices.size(); v += PRIMITIVE_FLOATS_PER_VERTEX)
+        {
+            const glm::vec3 position(level.vertices[v], level.vertices[v + 1], level.vertices[v + 2]);
+            low = glm::min(low, position);
+            high = glm::max(high, position);
+        }
+    }
+
+    software.boxCenter = 0.5f * (low + high);
+    software.boxExtent = 0.5f * (high - low);
+    float radius = 0.0f;
+    for (const MeshData& level : software.levels)
+        for (size_t v = 0; v < level.vertices.size(); v += PRIMITIVE_FLOATS_PER_VERTEX)
+            radius = max(radius, glm::length(glm::vec3(level.vertices[v], level.vertices[v + 1], level.vertices[v + 2]) - software.boxCenter));
+    software.sphere = glm::vec4(software.boxCenter, radius);
+}
+
+
+// World bounding sphere and box of the instances whose matrix the last transform update rebuilt
+void UUpdateSoftwareBounds()
+{
+    for (uint32_t index : gTransforms.Updated())
+    {
+        const SoftwareMesh& mesh = gMeshes[gScene.instances[index].mesh];
+        const glm::mat4& model = gTransforms.Matrix(index);
+        const glm::vec3 scale = glm::abs(gTransforms.Scale(index));
+        const glm::vec3 center = glm::vec3(model * glm::vec4(glm::vec3(mesh.sphere), 1.0f));
+        gInstanceSpheres.Set(index, center, mesh.sphere.w * max(scale.x, max(scale.y, scale.z)));
+
+        const glm::mat3 absolute(glm::abs(glm::vec3(model[0])), glm::abs(glm::vec3(model[1])), glm::abs(glm::vec3(model[2])));
+        gInstanceBoxes.Set(index, glm::vec3(model * glm::vec4(mesh.boxCenter, 1.0f)), absolute * mesh.boxExtent);
+    }
+}
+
+
+// Culls the instance boxes against the view frustum and picks the detail level of the rest from the screen size
+// of their bounding sphere, with the GL renderer's thresholds
+void USelectVisibleInstances(const glm::mat4& viewProjection, const glm::mat4& projection, const glm::vec3& cameraPosition)
+{
+    const size_t visibleCount = UCullBoxes(UExtractFrustum(viewProjection), gInstanceBoxes, gInstanceVisible.data());
+    gSoftwareRenderStats.visibleInstances = (unsigned)visibleCount;
+    gSoftwareRenderStats.culledInstances = (unsigned)(gInstanceVisible.size() - visibleCount);
+
+    const bool perspective = projection[3][3] == 0.0f;
+    const float focalLength = projection[1][1];
+    gVisibleInstances.clear();
+    for (uint32_t i = 0; i < gScene.instances.size(); ++i)
+    {
+        if (!gInstanceVisible[i])
+            continue;
+
+        const float radius = gInstanceSpheres.radius[i];
+        const glm::vec3 center(gInstanceSpheres.x[i], gInstanceSpheres.y[i], gInstanceSpheres.z[i]);
+        float size = radius * focalLength;
+        if (perspective)
+        {
+            const float distance = glm::length(center - cameraPosition);
+            size = distance > radius ? size / distance : numeric_limits<float>::max();
+        }
+
+        const uint32_t levels = (uint32_t)gMeshes[gScene.instances[i].mesh].levels.size();
+        uint32_t level = 0;
+        while (level + 1 < levels && size < PRIMITIVE_LOD_SCREEN_SIZES[level] * gLodScale)
+            ++level;
+        gInstanceLods[i] = (uint8_t)level;
+        gSoftwareRenderStats.lodInstances[level]++;
+        gVisibleInstances.push_back(i);
+    }
+}
+
+
+// Vertex stage and triangle setup of a run of instances: transforms every vertex once, then clips, sets up
+// and bins the triangles
+void URunGeometryTask(GeometryTask& task, const FrameSetup& frame)
+{
+    task.vertices.clear();
+    task.triangles.clear();
+    for (vector<uint32_t>& bin : task.bins)
+        bin.clear();
+
+    for (size_t i = task.first; i < task.end; ++i)
+    {
+        const uint32_t instance = gVisibleInstances[i];
+        const SceneInstance& sceneInstance = gScene.instances[instance];
+        const MeshData& mesh = gMeshes[sceneInstance.mesh].levels[gInstanceLods[instance]];
+
+        // The vertex shader's transforms: clip position, world position and the normal matrix
+        const glm::mat4& model = gTransforms.Matrix(instance);
+        const glm::mat4 modelViewProjection = frame.viewProjection * model;
+        const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+
+        const uint32_t base = (uint32_t)task.vertices.size();
+        task.vertices.resize(base + mesh.VertexCount());
+        for (size_t v = 0; v < mesh.VertexCount(); ++v)
+        {
+            const float* source = &mesh.vertices[v * PRIMITIVE_FLOATS_PER_VERTEX];
+            const glm::vec4 position(source[0], source[1], source[2], 1.0f);
+            ShadedVertex& vertex = task.vertices[base + v];
+            vertex.clip = modelViewProjection * position;
+            vertex.world = glm::vec3(model * position);
+            vertex.normal = normalMatrix * glm::vec3(source[3], source[4], source[5]);
+            vertex.uv = glm::vec2(source[6], source[7]) * sceneInstance.uvScale;
+        }
+
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+        {
+            const uint32_t triangle[3] = { base + mesh.indices[t], base + mesh.indices[t + 1], base + mesh.indices[t + 2] };
+            UClipTriangle(task, frame, triangle, instance);
+        }
+    }
+}
+
+
+// Skips a triangle entirely outside one clip plane, sets up a triangle inside all of them directly, and clips
+// the others into a polygon (new vertices interpolate every attribute in clip space) drawn as a fan
+void UClipTriangle(GeometryTask& task, const FrameSetup& frame, const uint32_t* vertices, uint32_t instance)
+{
+    unsigned outside[3] = {};
+    for (int corner = 0; corner < 3; ++corner)
+        for (int plane = 0; plane < CLIP_PLANE_COUNT; ++plane)
+            outside[corner] |= (UClipDistance(task.vertices[vertices[corner]].clip, plane) < 0.0f) << plane;
+
+    if (outside[0] & outside[1] & outside[2])
+        return;
+    if ((outside[0] | outside[1] | outside[2]) == 0)
+    {
+        USetupTriangle(task, frame, vertices[0], vertices[1], vertices[2], instance);
+        return;
+    }
+
+    // Each plane adds at most one vertex
+    uint32_t polygon[3 + CLIP_PLANE_COUNT], clipped[3 + CLIP_PLANE_COUNT];
+    int count = 3;
+    copy(vertices, vertices + 3, polygon);
+    const unsigned crossed = outside[0] | outside[1] | outside[2];
+    for (int plane = 0; plane < CLIP_PLANE_COUNT && count >= 3; ++plane)
+    {
+        if (!(crossed & (1u << plane)))
+            continue;
+
+        int clippedCount = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t current = polygon[i];
+            const uint32_t next = polygon[(i + 1) % count];
+            const float currentDistance = UClipDistance(task.vertices[current].clip, plane);
+            const float nextDistance = UClipDistance(task.vertices[next].clip, plane);
+            if (currentDistance >= 0.0f)
+                clipped[clippedCount++] = current;
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+            {
+                const float t = currentDistance / (currentDistance - nextDistance);
+                const ShadedVertex a = task.vertices[current], b = task.vertices[next];
+                ShadedVertex vertex;
+                vertex.clip = a.clip + (b.clip - a.clip) * t;
+                vertex.world = a.world + (b.world - a.world) * t;
+                vertex.normal = a.normal + (b.normal - a.normal) * t;
+                vertex.uv = a.uv + (b.uv - a.uv) * t;
+                clipped[clippedCount++] = (uint32_t)task.vertices.size();
+                task.vertices.push_back(vertex);
+            }
+        }
+        copy(clipped, clipped + clippedCount, polygon);
+        count = clippedCount;
+    }
+
+    for (int i = 1; i + 1 < count; ++i)
+        USetupTriangle(task, frame, polygon[0], polygon[i], polygon[i + 1], instance);
+}
+
+
+// Projects a clipped triangle to the window, snaps it to the subpixel grid, makes it counter-clockwise
+// (both faces are drawn, as the GL renderer does not cull) and bins it into every tile its bounds overlap
+void USetupTriangle(GeometryTask& task, const FrameSetup& frame, uint32_t v0, uint32_t v1, uint32_t v2, uint32_t instance)
+{
+    RasterTriangle triangle;
+    const uint32_t corners[3] = { v0, v1, v2 };
+    for (int i = 0; i < 3; ++i)
+    {
+        const glm::vec4& clip = task.vertices[corners[i]].clip;
+        const float inverseW = 1.0f / clip.w;
+        triangle.x[i] = floor((clip.x * inverseW * 0.5f + 0.5f) * frame.width * SUBPIXEL_STEPS + 0.5f) / SUBPIXEL_STEPS;
+        triangle.y[i] = floor((clip.y * inverseW * 0.5f + 0.5f) * frame.height * SUBPIXEL_STEPS + 0.5f) / SUBPIXEL_STEPS;
+        triangle.z[i] = clip.z * inverseW * 0.5f + 0.5f;
+        triangle.inverseW[i] = inverseW;
+        triangle.vertex[i] = corners[i];
+    }
+
+    const float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+    if (!(area > 0.0f || area < 0.0f))
+        return;     // degenerate or not a number
+    if (area < 0.0f)
+    {
+        swap(triangle.x[1], triangle.x[2]);
+        swap(triangle.y[1], triangle.y[2]);
+        swap(triangle.z[1], triangle.z[2]);
+        swap(triangle.inverseW[1], triangle.inverseW[2]);
+        swap(triangle.vertex[1], triangle.vertex[2]);
+    }
+
+    // Pixels whose centers fall in the triangle's bounds
+    triangle.minX = max(0, (int)ceil(min(triangle.x[0], min(triangle.x[1], triangle.x[2])) - 0.5f));
+    triangle.maxX = min(frame.width - 1, (int)floor(max(triangle.x[0], max(triangle.x[1], triangle.x[2])) - 0.5f));
+    triangle.minY = max(0, (int)ceil(min(triangle.y[0], min(triangle.y[1], triangle.y[2])) - 0.5f));
+    triangle.maxY = min(frame.height - 1, (int)floor(max(triangle.y[0], max(triangle.y[1], triangle.y[2])) - 0.5f));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+        return;
+    triangle.instance = instance;
+
+    const uint32_t index = (uint32_t)task.triangles.size();
+    task.triangles.push_back(triangle);
+    for (int tileY = triangle.minY / SOFTWARE_TILE_SIZE; tileY <= triangle.maxY / SOFTWARE_TILE_SIZE; ++tileY)
+        for (int tileX = triangle.minX / SOFTWARE_TILE_SIZE; tileX <= triangle.maxX / SOFTWARE_TILE_SIZE; ++tileX)
+            task.bins[(size_t)tileY * frame.tilesX + tileX].push_back(index);
+}
+
+
+// Clears the tile's depth and triangle buffers, then draws the tile's bins of every geometry task, in task order
+void URasterizeTile(size_t tile, TileBuffer& buffer, const FrameSetup& frame)
+{
+    fill(buffer.depth, buffer.depth + SOFTWARE_TILE_SIZE * SOFTWARE_TILE_SIZE, 1.0f);
+    fill(buffer.triangle, buffer.triangle + SOFTWARE_TILE_SIZE * SOFTWARE_TILE_SIZE, NO_TRIANGLE);
+
+    const int tileX = (int)(tile % frame.tilesX) * SOFTWARE_TILE_SIZE;
+    const int tileY = (int)(tile / frame.tilesX) * SOFTWARE_TILE_SIZE;
+    for (uint32_t t = 0; t < gGeometryTasks.size(); ++t)
+    {
+        const GeometryTask& task = gGeometryTasks[t];
+        for (uint32_t index : task.bins[tile])
+            URasterizeTriangle(task.triangles[index], (t << TRIANGLE_INDEX_BITS) | index, buffer, tileX, tileY);
+    }
+}
+
+
+// Keeps the triangle at every pixel of the tile whose center it covers and where it is nearer than what is there
+// (GL_LESS). Rows are walked SIMD_WIDTH pixels at a time; the edge functions are evaluated at every group, not
+// stepped, so neighbouring triangles get exactly opposite values along their shared edge.
+void URasterizeTriangle(const RasterTriangle& triangle, uint32_t reference, TileBuffer& buffer, int tileX, int tileY)
+{
+    const int minX = max(triangle.minX, tileX), maxX = min(triangle.maxX, tileX + SOFTWARE_TILE_SIZE - 1);
+    const int minY = max(triangle.minY, tileY), maxY = min(triangle.maxY, tileY + SOFTWARE_TILE_SIZE - 1);
+
+    const EdgeFunction e0(triangle.x[1], triangle.y[1], triangle.x[2], triangle.y[2]);
+    const EdgeFunction e1(triangle.x[2], triangle.y[2], triangle.x[0], triangle.y[0]);
+    const EdgeFunction e2(triangle.x[0], triangle.y[0], triangle.x[1], triangle.y[1]);
+
+    // Each edge function is the opposite vertex's barycentric weight times the area, so they also give the depth plane
+    const float inverseArea = 1.0f / (e0.a * triangle.x[0] + e0.b * triangle.y[0] + e0.c);
+    const float zA = (e0.a * triangle.z[0] + e1.a * triangle.z[1] + e2.a * triangle.z[2]) * inverseArea;
+    const float zB = (e0.b * triangle.z[0] + e1.b * triangle.z[1] + e2.b * triangle.z[2]) * inverseArea;
+    const float zC = (e0.c * triangle.z[0] + e1.c * triangle.z[1] + e2.c * triangle.z[2]) * inverseArea;
+
+    // Whole SIMD groups of the tile row: lanes outside the triangle's bounds fail the edge tests
+    const int startX = minX - (minX - tileX) % (int)SIMD_WIDTH;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const float centerY = y + 0.5f;
+        float* depthRow = &buffer.depth[(y - tileY) * SOFTWARE_TILE_SIZE];
+        uint32_t* triangleRow = &buffer.triangle[(y - tileY) * SOFTWARE_TILE_SIZE];
+        int x = startX;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+        const SimdFloat row0 = USimdSplat(e0.b * centerY + e0.c);
+        const SimdFloat row1 = USimdSplat(e1.b * centerY + e1.c);
+        const SimdFloat row2 = USimdSplat(e2.b * centerY + e2.c);
+        const SimdFloat rowZ = USimdSplat(zB * centerY + zC);
+        const SimdFloat a0 = USimdSplat(e0.a), a1 = USimdSplat(e1.a), a2 = USimdSplat(e2.a), aZ = USimdSplat(zA);
+        const SimdFloat zero = USimdSplat(0.0f);
+        for (; x <= maxX; x += (int)SIMD_WIDTH)
+        {
+            const SimdFloat centerX = USimdAdd(USimdRamp(), USimdSplat(x + 0.5f));
+            const SimdFloat w0 = USimdMulAdd(a0, centerX, row0);
+            const SimdFloat w1 = USimdMulAdd(a1, centerX, row1);
+            const SimdFloat w2 = USimdMulAdd(a2, centerX, row2);
+            const SimdFloat inside = USimdAnd(USimdAnd(e0.topLeft ? USimdGreaterEqual(w0, zero) : USimdGreater(w0, zero),
+                                                       e1.topLeft ? USimdGreaterEqual(w1, zero) : USimdGreater(w1, zero)),
+                                              e2.topLeft ? USimdGreaterEqual(w2, zero) : USimdGreater(w2, zero));
+            if (!USimdMask(inside))
+                continue;
+
+            const SimdFloat z = USimdMulAdd(aZ, centerX, rowZ);
+            const SimdFloat depth = USimdLoad(depthRow + x - tileX);
+            const SimdFloat nearer = USimdAnd(inside, USimdGreater(depth, z));
+            const int mask = USimdMask(nearer);
+            if (!mask)
+                continue;
+
+            USimdStore(depthRow + x - tileX, USimdSelect(nearer, z, depth));
+            for (int lane = 0; lane < (int)SIMD_WIDTH; ++lane)
+                if (mask & (1 << lane))
+                    triangleRow[x - tileX + lane] = reference;
+        }
+#else
+        for (; x <= maxX; ++x)
+        {
+            const float centerX = x + 0.5f;
+            const float w0 = e0.a * centerX + (e0.b * centerY + e0.c);
+            const float w1 = e1.a * centerX + (e1.b * centerY + e1.c);
+            const float w2 = e2.a * centerX + (e2.b * centerY + e2.c);
+            if ((e0.topLeft ? w0 >= 0.0f : w0 > 0.0f) && (e1.topLeft ? w1 >= 0.0f : w1 > 0.0f) && (e2.topLeft ? w2 >= 0.0f : w2 > 0.0f))
+            {
+                const float z = zA * centerX + (zB * centerY + zC);
+                if (z < depthRow[x - tileX])
+                {
+                    depthRow[x - tileX] = z;
+                    triangleRow[x - tileX] = reference;
+                }
+            }
+        }
+#endif
+    }
+}
+
+
+// Shades every pixel of the tile covered by a triangle, clears the others to black, and writes the tile out.
+// Returns the number of pixels shaded.
+unsigned UShadeTile(size_t tile, const TileBuffer& buffer, const FrameSetup& frame, SoftwareFramebuffer& framebuffer)
+{
+    const int tileX = (int)(tile % frame.tilesX) * SOFTWARE_TILE_SIZE;
+    const int tileY = (int)(tile / frame.tilesX) * SOFTWARE_TILE_SIZE;
+    const int endX = min(frame.width, tileX + SOFTWARE_TILE_SIZE);
+    const int endY = min(frame.height, tileY + SOFTWARE_TILE_SIZE);
+
+    unsigned shaded = 0;
+    for (int y = tileY; y < endY; ++y)
+    {
+        uint8_t* pixel = &framebuffer.color[((size_t)y * frame.width + tileX) * 4];
+        for (int x = tileX; x < endX; ++x, pixel += 4)
+        {
+            glm::vec3 color(0.0f);
+            const uint32_t reference = buffer.triangle[(y - tileY) * SOFTWARE_TILE_SIZE + (x - tileX)];
+            if (reference != NO_TRIANGLE)
+            {
+                const GeometryTask& task = gGeometryTasks[reference >> TRIANGLE_INDEX_BITS];
+                const RasterTriangle& triangle = task.triangles[reference & ((1u << TRIANGLE_INDEX_BITS) - 1)];
+                color = glm::clamp(UShadePixel(triangle, task, x + 0.5f, y + 0.5f, frame), 0.0f, 1.0f);
+                ++shaded;
+            }
+
+            // Unsigned normalized conversion, as the GL framebuffer stores it
+            pixel[0] = (uint8_t)(color.r * 255.0f + 0.5f);
+            pixel[1] = (uint8_t)(color.g * 255.0f + 0.5f);
+            pixel[2] = (uint8_t)(color.b * 255.0f + 0.5f);
+            pixel[3] = 255;
+        }
+    }
+    return shaded;
+}
+
+
+// Bilinear sample of one size x size level with GL_REPEAT wrapping
+glm::vec3 USampleLevel(const uint8_t* level, int size, const glm::vec2& uv)
+{
+    const float sampleX = uv.x * size - 0.5f;
+    const float sampleY = uv.y * size - 0.5f;
+    const float floorX = floor(sampleX), floorY = floor(sampleY);
+    const float fx = sampleX - floorX, fy = sampleY - floorY;
+
+    // The level size is a power of two: masking wraps negative coordinates too
+    const int mask = size - 1;
+    const int x0 = (int)floorX & mask, x1 = (x0 + 1) & mask;
+    const int y0 = (int)floorY & mask, y1 = (y0 + 1) & mask;
+    const uint8_t* t00 = &level[((size_t)y0 * size + x0) * 4];
+    const uint8_t* t10 = &level[((size_t)y0 * size + x1) * 4];
+    const uint8_t* t01 = &level[((size_t)y1 * size + x0) * 4];
+    const uint8_t* t11 = &level[((size_t)y1 * size + x1) * 4];
+
+    glm::vec3 color;
+    for (int c = 0; c < 3; ++c)
+    {
+        const float bottom = t00[c] + (t10[c] - t00[c]) * fx;
+        const float top = t01[c] + (t11[c] - t01[c]) * fx;
+        color[c] = (bottom + (top - bottom) * fy) * (1.0f / 255.0f);
+    }
+    return color;
+}
+
+
+// Samples a layer as the GL texture array's GL_LINEAR_MIPMAP_LINEAR filter does: the level of detail comes from the
+// uv change to the next pixel in x and y, like textureGrad; level 0 is magnified bilinearly, and minified pixels blend
+// the bilinear samples of the two nearest levels
+glm::vec3 USampleLayer(const vector<uint8_t>& layer, const glm::vec2& uv, const glm::vec2& uvDx, const glm::vec2& uvDy)
+{
+    const float texelsPerPixel = max(glm::length(uvDx), glm::length(uvDy)) * TEXTURE_LAYER_SIZE;
+    const float lod = texelsPerPixel > 1.0f ? log2(texelsPerPixel) : 0.0f;
+    const int maxLevel = (int)log2((float)TEXTURE_LAYER_SIZE);
+    if (lod <= 0.0f)
+        return USampleLevel(layer.data(), TEXTURE_LAYER_SIZE, uv);
+
+    const int level0 = min((int)lod, maxLevel), level1 = min(level0 + 1, maxLevel);
+    const float blend = min(lod, (float)maxLevel) - level0;
+    size_t offset = 0;
+    int size = TEXTURE_LAYER_SIZE;
+    for (int level = 0; level < level0; ++level, size /= 2)
+        offset += (size_t)size * size * 4;
+
+    const glm::vec3 fine = USampleLevel(&layer[offset], size, uv);
+    if (level1 == level0 || blend <= 0.0f)
+        return fine;
+    const glm::vec3 coarse = USampleLevel(&layer[offset + (size_t)size * size * 4], size / 2, uv);
+    return fine + (coarse - fine) * blend;
+}
+
+
+// The fragment shaders at one pixel center: perspective-correct attributes, then fragmentShaderSource's Phong model
+// for textured instances and plain white for lamps
+glm::vec3 UShadePixel(const RasterTriangle& triangle, const GeometryTask& task, float centerX, float centerY, const FrameSetup& frame)
+{
+    const SceneInstance& instance = gScene.instances[triangle.instance];
+    if (instance.texture == SCENE_NO_TEXTURE)
+        return glm::vec3(1.0f);
+
+    // Screen-space barycentric weights, then weighted by 1/w so that attributes interpolate linearly in world space
+    const EdgeFunction e0(triangle.x[1], triangle.y[1], triangle.x[2], triangle.y[2]);
+    const EdgeFunction e1(triangle.x[2], triangle.y[2], triangle.x[0], triangle.y[0]);
+    const EdgeFunction e2(triangle.x[0], triangle.y[0], triangle.x[1], triangle.y[1]);
+    float weights[3] = {
+        (e0.a * centerX + e0.b * centerY + e0.c) * triangle.inverseW[0],
+        (e1.a * centerX + e1.b * centerY + e1.c) * triangle.inverseW[1],
+        (e2.a * centerX + e2.b * centerY + e2.c) * triangle.inverseW[2]
+    };
+    const float inverseSum = 1.0f / (weights[0] + weights[1] + weights[2]);
+
+    // The uv at another point of the triangle's plane, for the texture's screen-space derivatives
+    const auto interpolateUV = [&](float x, float y)
+    {
+        const float w[3] = {
+            (e0.a * x + e0.b * y + e0.c) * triangle.inverseW[0],
+            (e1.a * x + e1.b * y + e1.c) * triangle.inverseW[1],
+            (e2.a * x + e2.b * y + e2.c) * triangle.inverseW[2]
+        };
+        const glm::vec2 sum = task.vertices[triangle.vertex[0]].uv * w[0] + task.vertices[triangle.vertex[1]].uv * w[1]
+                            + task.vertices[triangle.vertex[2]].uv * w[2];
+        return sum / (w[0] + w[1] + w[2]);
+    };
+
+    glm::vec3 fragmentPosition(0.0f), normal(0.0f);
+    glm::vec2 uv(0.0f);
+    for (int i = 0; i < 3; ++i)
+    {
+        const ShadedVertex& vertex = task.vertices[triangle.vertex[i]];
+        const float weight = weights[i] * inverseSum;
+        fragmentPosition += vertex.world * weight;
+        normal += vertex.normal * weight;
+        uv += vertex.uv * weight;
+    }
+
+    // Ambient, diffuse and specular terms
+    const glm::vec3 lightColor = gScene.lightColor;
+    const glm::vec3 ambient = AMBIENT_STRENGTH * lightColor;
+
+    const glm::vec3 norm = glm::normalize(normal);
+    const glm::vec3 lightDirection = glm::normalize(gScene.lightPosition - fragmentPosition);
+    const float impact = max(glm::dot(norm, lightDirection), 0.0f);
+    const glm::vec3 diffuse = impact * lightColor;
+
+    const glm::vec3 viewDirection = glm::normalize(frame.cameraPosition - fragmentPosition);
+    const glm::vec3 reflectDirection = glm::reflect(-lightDirection, norm);
+    const float specularComponent = pow(max(glm::dot(viewDirection, reflectDirection), 0.0f), HIGHLIGHT_SIZE);
+    const glm::vec3 specular = SPECULAR_INTENSITY * specularComponent * lightColor;
+
+    // Derivatives of the unfolded coordinates, as the shader passes dFdx(uv) and dFdy(uv) to textureGrad
+    const glm::vec2 uvDx = interpolateUV(centerX + 1.0f, centerY) - uv;
+    const glm::vec2 uvDy = interpolateUV(centerX, centerY + 1.0f) - uv;
+
+    // Mirrored textures fold the coordinates like the shader's mirroredRepeat
+    if (gScene.textures[instance.texture].mirrored)
+        uv = glm::vec2(1.0f) - glm::abs(uv - 2.0f * glm::floor(uv * 0.5f) - glm::vec2(1.0f));
+    const glm::vec3 textureColor = USampleLayer(gTextureLayers[instance.texture], uv, uvDx, uvDy);
+
+    return (ambient + diffuse + specular) * textureColor;
+}
@@ -0,0 +1,69 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "camera.h"             // Camera class
+#include "primitives.h"         // Detail levels
+#include "scene.h"              // Scene file loading
+#include "transform_store.h"    // Cached model matrices
+
+// Pixels per side of the screen tiles triangles are binned into; each tile is rasterized and shaded by one thread
+const int SOFTWARE_TILE_SIZE = 32;
+
+// Color buffer the software renderer draws into: RGBA8, row 0 at the bottom like glReadPixels returns it
+struct SoftwareFramebuffer
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> color;
+
+    void Resize(int width, int height)
+    {
+        this->width = width;
+        this->height = height;
+        color.assign((size_t)width * height * 4, 0);
+    }
+};
+
+// Work done by the last USoftwareRender call
+struct SoftwareRenderStats
+{
+    unsigned threads = 0;
+    unsigned visibleInstances = 0;     // instances whose bounding box intersects the view frustum
+    unsigned culledInstances = 0;
+    unsigned lodInstances[PRIMITIVE_MAX_LODS] = {};
+    unsigned triangles = 0;            // triangles set up for rasterization, after clipping
+    unsigned binnedTriangles = 0;      // triangle references in the tile bins: triangles x tiles they overlap
+    unsigned shadedPixels = 0;
+    double geometryMs = 0.0;           // transform, clip, set up and bin
+    double rasterMs = 0.0;             // depth test and shade the tiles
+};
+
+// Work done by the last USoftwareRender call
+extern SoftwareRenderStats gSoftwareRenderStats;
+
+/* Software renderer function prototypes to:
+ * load a scene for the CPU: its meshes and detail levels, and its textures resampled like the GL texture array,
+ * release it,
+ * get the transforms of its instances, in scene order,
+ * set the number of threads (0: every hardware thread), or share another job system's,
+ * set the detail level scale (as USetLodScale),
+ * render a frame seen by the camera into the framebuffer, with the GL renderer's projection and Phong shading,
+ * and write a framebuffer as a binary PPM image
+ */
+bool USoftwareCreateScene(const std::string& sceneFile = DEFAULT_SCENE_FILE);
+void USoftwareDestroyScene();
+TransformStore& USoftwareGetTransforms();
+void USoftwareSetThreads(unsigned threads);
+void USoftwareSetJobSystem(JobSystem& jobs);
+unsigned USoftwareGetThreads();
+void USoftwareSetLodScale(float scale);
+void USoftwareRender(const Camera& camera, bool isPerspectiveView, SoftwareFramebuffer& framebuffer);
+bool UWriteFramebufferImage(const SoftwareFramebuffer& framebuffer, const std::string& filename);
+
+#endif
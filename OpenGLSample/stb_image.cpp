@@ -0,0 +1,3 @@
+// The stb_image implementation, compiled once for both the GL and the software renderer
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"      // Image loading Utility functions
@@ -0,0 +1,197 @@
+#include <iostream>         // cout, cerr
+#include <sstream>          // ostringstream
+#include <iomanip>          // setprecision
+#include <cstdlib>          // EXIT_FAILURE, atoi
+#include <cstring>          // strcmp, memcpy
+#include <chrono>           // steady_clock
+#include <cmath>            // floor, log2
+#include <atomic>
+#include <mutex>
+#include <algorithm>        // sort, unique
+#include <string>
+#include <vector>
+
+#include "scene.h"          // Scene file loading
+#include "image.h"          // Mip chain size
+#include "texture_container.h"  // Baked texture files
+#include "texture_compression.h"    // BC1 and BC3 encoding
+#include "job_system.h"     // Bakes run in parallel
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // --output: folder the bakes go to, where the renderers look for them by default
+    string gOutputDir = BAKED_TEXTURE_DIR;
+
+    // --size: width and height of the baked layers, the renderers' TEXTURE_LAYER_SIZE. A power of two of at least 4,
+    // so every mip level down to 4x4 is a whole number of compression blocks.
+    int gLayerSize = 1024;
+
+    // --format: formats every texture is baked in, each to its own file (default: rgba8)
+    vector<Texture_Format> gFormats;
+
+    // --force: bake every texture again, even those whose bake is current
+    bool gForce = false;
+
+    // --threads: bakes running at once (0: every hardware thread)
+    unsigned gThreads = 0;
+
+    // What happened to one texture
+    enum Bake_Result {
+        BAKE_CURRENT,       // the bake's source stamp matches the file
+        BAKE_RESTAMPED,     // the file's stamp changed but not its contents: only the header was rewritten
+        BAKE_BAKED,         // decoded, resampled (and compressed) and written
+        BAKE_FAILED
+    };
+
+    // Texels block compressed and the time spent on them, over every texture, for the throughput summary
+    atomic<uint64_t> gCompressedPixels(0);
+    atomic<uint64_t> gCompressionMicroseconds(0);
+
+    // Keeps the per-texture report lines whole while bakes run in parallel
+    mutex gReportMutex;
+}
+
+
+// Brings the bake of one texture (a path below RESOURCE_DIR) in one format up to date. A bake whose source stamp
+// matches is left alone without reading the source; one whose stamp differs is only rebaked if the source's content
+// hash changed too, so a checkout or copy that touches every file costs one hash per texture rather than a decode.
+// Block formats are compressed with the rows split over jobs, if given, and report their PSNR and speed.
+Bake_Result UBakeIfNeeded(const string& texturePath, Texture_Format format, JobSystem* jobs)
+{
+    const string source = string(RESOURCE_DIR "/") + texturePath;
+    const string target = UBakedTexturePath(texturePath, format, gOutputDir);
+
+    TextureContainerHeader header = {};
+    header.format = format;
+    header.size = (uint32_t)gLayerSize;
+    header.levels = 1 + (uint32_t)floor(log2((double)gLayerSize));
+    if (!UFileStamp(source, header.sourceSize, header.sourceTime))
+    {
+        cerr << "Missing texture " << source << endl;
+        return BAKE_FAILED;
+    }
+
+    vector<uint8_t> data;
+    if (!gForce)
+    {
+        MappedFile mapped;
+        const TextureContainerHeader* baked = UMapTextureContainer(target, mapped);
+        if (baked && baked->format == header.format && baked->size == header.size && baked->levels == header.levels
+            && baked->dataSize == UTextureChainBytes(format, gLayerSize))
+        {
+            if (baked->sourceSize == header.sourceSize && baked->sourceTime == header.sourceTime)
+                return BAKE_CURRENT;
+
+            if (!UHashFile(source, header.sourceHash))
+                return BAKE_FAILED;
+            if (baked->sourceHash == header.sourceHash)
+            {
+                // Copied out first: the new file replaces the mapped one
+                data.resize(baked->dataSize);
+                memcpy(data.data(), mapped.Data() + baked->dataOffset, data.size());
+                mapped.Close();
+                return UWriteTextureContainer(target, header, data.data()) ? BAKE_RESTAMPED : BAKE_FAILED;
+            }
+        }
+    }
+
+    if (!UHashFile(source, header.sourceHash) || !UBakeTexture(source, gLayerSize, data))
+    {
+        cerr << "Failed to bake texture " << source << endl;
+        return BAKE_FAILED;
+    }
+
+    if (format != TEXTURE_FORMAT_RGBA8)
+    {
+        vector<uint8_t> blocks(UTextureChainBytes(format, gLayerSize));
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        UCompressMipChain(data.data(), gLayerSize, format, blocks.data(), jobs);
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        const uint64_t pixels = UMipChainBytes(gLayerSize) / 4;
+        gCompressedPixels += pixels;
+        gCompressionMicroseconds += (uint64_t)(seconds * 1e6);
+
+        ostringstream line;
+        line << fixed << setprecision(2) << "INFO: " << texturePath << " " << UTextureFormatName(format) << ": "
+             << UCompressionPSNR(data.data(), gLayerSize, format, blocks.data()) << " dB PSNR, "
+             << seconds * 1000.0 << " ms, " << pixels / seconds / 1e6 << " Mpixel/s" << endl;
+        {
+            lock_guard<mutex> lock(gReportMutex);
+            cout << line.str();
+        }
+        data.swap(blocks);
+    }
+    return UWriteTextureContainer(target, header, data.data()) ? BAKE_BAKED : BAKE_FAILED;
+}
+
+
+// Bakes the textures of scene files, each image resampled to the layer size with its mip chain, into containers the
+// renderers read in place of the images: texture_baker desk.scene [more.scene...] [--format bc1] [--output dir] [--force]
+int main(int argc, char* argv[])
+{
+    vector<string> sceneFiles;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        Texture_Format format;
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            gOutputDir = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            gLayerSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            usage = usage || !UParseTextureFormat(argv[++i], format);
+            gFormats.push_back(format);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            gThreads = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--force") == 0)
+            gForce = true;
+        else
+            sceneFiles.push_back(argv[i]);
+    }
+    if (usage || sceneFiles.empty() || gLayerSize < 4 || (gLayerSize & (gLayerSize - 1)) != 0)
+    {
+        cerr << "usage: texture_baker <scene files...> [--format rgba8|bc1|bc3]... [--output dir] [--size power of two] [--threads N] [--force]" << endl;
+        return EXIT_FAILURE;
+    }
+    if (gFormats.empty())
+        gFormats.push_back(TEXTURE_FORMAT_RGBA8);
+
+    // Scenes share textures, and replicated ones list the same file many times: bake each once
+    vector<string> textures;
+    for (const string& sceneFile : sceneFiles)
+    {
+        SceneDescription scene;
+        if (!ULoadScene(sceneFile, scene))
+            return EXIT_FAILURE;
+        for (const SceneTexture& texture : scene.textures)
+            textures.push_back(texture.path);
+    }
+    sort(textures.begin(), textures.end());
+    textures.erase(unique(textures.begin(), textures.end()), textures.end());
+
+    // One job per texture and format; with fewer of those than threads, the compression's block rows are shared out too
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    const size_t bakes = textures.size() * gFormats.size();
+    atomic<unsigned> counts[BAKE_FAILED + 1] = {};
+    JobSystem jobs(gThreads);
+    JobSystem* rowJobs = bakes < jobs.ThreadCount() ? &jobs : nullptr;
+    jobs.ParallelFor(bakes, 1, [&](size_t begin, size_t end, unsigned)
+        {
+            for (size_t bake = begin; bake < end; ++bake)
+                counts[UBakeIfNeeded(textures[bake / gFormats.size()], gFormats[bake % gFormats.size()], rowJobs)]++;
+        });
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "INFO: " << textures.size() << " textures, " << bakes << " bakes in " << gOutputDir << ": " << counts[BAKE_BAKED] << " baked, "
+         << counts[BAKE_RESTAMPED] << " restamped, " << counts[BAKE_CURRENT] << " up to date, " << counts[BAKE_FAILED]
+         << " failed in " << seconds << " s" << endl;
+    if (gCompressionMicroseconds > 0)
+        cout << "INFO: compressed " << gCompressedPixels / 1e6 << " Mpixel in " << gCompressionMicroseconds / 1e6
+             << " s of encoding on " << jobs.ThreadCount() << " threads" << endl;
+    return counts[BAKE_FAILED] == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,586 @@
+#include <cstring>          // memcpy, memset
+#include <cmath>            // sqrt, fabs, log10
+#include <algorithm>        // min, max, swap
+#include <limits>           // numeric_limits
+
+#include "texture_compression.h"
+#include "simd.h"           // SSE or AVX wrappers
+#include "job_system.h"     // Block rows in parallel
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // Block rows a job compresses at a time
+    const size_t COMPRESSION_GRAIN = 8;
+
+    // Weight of the first endpoint in each BC1 palette entry, by index
+    const float BC1_WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+    // A block's 16 pixels as floats, one array per channel, so the index searches compare SIMD_WIDTH pixels per step
+    struct BlockPixels
+    {
+        alignas(32) float r[16];
+        alignas(32) float g[16];
+        alignas(32) float b[16];
+        alignas(32) float a[16];
+    };
+}
+
+
+/* Internal function prototypes to:
+ * load a block into floats, round a color to RGB565 and expand it back,
+ * find every pixel's nearest palette color or alpha, fit and write a BC1 color block or a BC3 alpha block,
+ * and compress a range of block rows of one image
+ */
+void ULoadBlock(const uint8_t* pixels, size_t rowBytes, BlockPixels& block);
+uint16_t UPackColor565(const float color[3]);
+void UUnpackColor565(uint16_t packed, float color[3]);
+float USelectColorIndices(const BlockPixels& block, const float palette[4][3], uint8_t indices[16]);
+float USelectAlphaIndices(const BlockPixels& block, const float palette[8], uint8_t indices[16]);
+float UWriteColorBlock(const BlockPixels& block, const float first[3], const float second[3], uint8_t* output, uint8_t indices[16]);
+void UEncodeColorBlock(const BlockPixels& block, uint8_t* output);
+void UEncodeAlphaBlock(const BlockPixels& block, uint8_t* output);
+void UCompressBlockRows(const uint8_t* pixels, int size, Texture_Format format, uint8_t* blocks, size_t firstRow, size_t endRow);
+
+
+// Name used by the tools' --format options and in reports
+const char* UTextureFormatName(Texture_Format format)
+{
+    switch (format)
+    {
+    case TEXTURE_FORMAT_BC1:
+        return "bc1";
+    case TEXTURE_FORMAT_BC3:
+        return "bc3";
+    case TEXTURE_FORMAT_RGBA8:
+    default:
+        return "rgba8";
+    }
+}
+
+
+bool UParseTextureFormat(const string& name, Texture_Format& format)
+{
+    for (Texture_Format candidate : { TEXTURE_FORMAT_RGBA8, TEXTURE_FORMAT_BC1, TEXTURE_FORMAT_BC3 })
+    {
+        if (name == UTextureFormatName(candidate))
+        {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Bytes of one size x size level; block formats round up to whole 4x4 blocks
+size_t UTextureLevelBytes(Texture_Format format, int size)
+{
+    const size_t blocks = (size_t)max((size + 3) / 4, 1);
+    switch (format)
+    {
+    case TEXTURE_FORMAT_BC1:
+        return blocks * blocks * BC1_BLOCK_BYTES;
+    case TEXTURE_FORMAT_BC3:
+        return blocks * blocks * BC3_BLOCK_BYTES;
+    case TEXTURE_FORMAT_RGBA8:
+    default:
+        return (size_t)size * size * 4;
+    }
+}
+
+
+// Bytes of a size x size level followed by all its mips
+size_t UTextureChainBytes(Texture_Format format, int size)
+{
+    size_t bytes = 0;
+    for (; size >= 1; size /= 2)
+        bytes += UTextureLevelBytes(format, size);
+    return bytes;
+}
+
+
+// Encodes the 4x4 RGBA pixels at pixels (rows rowBytes apart) as an opaque BC1 block of 8 bytes
+void UEncodeBC1Block(const uint8_t* pixels, size_t rowBytes, uint8_t* block)
+{
+    BlockPixels loaded;
+    ULoadBlock(pixels, rowBytes, loaded);
+    UEncodeColorBlock(loaded, block);
+}
+
+
+// Encodes the 4x4 RGBA pixels at pixels (rows rowBytes apart) as a BC3 block of 16 bytes: alpha, then color
+void UEncodeBC3Block(const uint8_t* pixels, size_t rowBytes, uint8_t* block)
+{
+    BlockPixels loaded;
+    ULoadBlock(pixels, rowBytes, loaded);
+    UEncodeAlphaBlock(loaded, block);
+    UEncodeColorBlock(loaded, block + 8);
+}
+
+
+// Decodes a BC1 or BC3 block into 16 RGBA pixels, row after row, as the GPU would sample them
+void UDecodeBlock(Texture_Format format, const uint8_t* block, uint8_t* pixels)
+{
+    const uint8_t* color = format == TEXTURE_FORMAT_BC3 ? block + 8 : block;
+    const uint16_t packed0 = (uint16_t)(color[0] | color[1] << 8);
+    const uint16_t packed1 = (uint16_t)(color[2] | color[3] << 8);
+    float endpoints[2][3];
+    UUnpackColor565(packed0, endpoints[0]);
+    UUnpackColor565(packed1, endpoints[1]);
+
+    // BC3 color blocks always use four colors; BC1 switches to three and transparent black when packed0 <= packed1
+    uint8_t palette[4][4];
+    const bool fourColors = format == TEXTURE_FORMAT_BC3 || packed0 > packed1;
+    for (int k = 0; k < 4; ++k)
+    {
+        const float weight = fourColors ? BC1_WEIGHTS[k] : (k == 0 ? 1.0f : k == 1 ? 0.0f : 0.5f);
+        for (int c = 0; c < 3; ++c)
+            palette[k][c] = (uint8_t)(endpoints[0][c] * weight + endpoints[1][c] * (1.0f - weight) + 0.5f);
+        palette[k][3] = 255;
+    }
+    if (!fourColors)
+        memset(palette[3], 0, 4);
+
+    const uint32_t colorIndices = (uint32_t)color[4] | (uint32_t)color[5] << 8 | (uint32_t)color[6] << 16 | (uint32_t)color[7] << 24;
+    for (int i = 0; i < 16; ++i)
+        memcpy(pixels + i * 4, palette[(colorIndices >> (2 * i)) & 3], 4);
+
+    if (format != TEXTURE_FORMAT_BC3)
+        return;
+
+    const int alpha0 = block[0], alpha1 = block[1];
+    uint8_t alphas[8] = { (uint8_t)alpha0, (uint8_t)alpha1 };
+    for (int k = 2; k < 8; ++k)
+    {
+        if (alpha0 > alpha1)
+            alphas[k] = (uint8_t)(((8 - k) * alpha0 + (k - 1) * alpha1 + 3) / 7);
+        else
+            alphas[k] = k == 6 ? 0 : k == 7 ? 255 : (uint8_t)(((6 - k) * alpha0 + (k - 1) * alpha1 + 2) / 5);
+    }
+    uint64_t alphaIndices = 0;
+    for (int byte = 0; byte < 6; ++byte)
+        alphaIndices |= (uint64_t)block[2 + byte] << (8 * byte);
+    for (int i = 0; i < 16; ++i)
+        pixels[i * 4 + 3] = alphas[(alphaIndices >> (3 * i)) & 7];
+}
+
+
+// Compresses a square power-of-two RGBA image into blocks, UTextureLevelBytes(format, size) bytes. Images under 4x4
+// (the last mips) fill their one block by repeating their edge pixels. With jobs, the block rows are shared out.
+void UCompressImage(const uint8_t* pixels, int size, Texture_Format format, uint8_t* blocks, JobSystem* jobs)
+{
+    const size_t blockRows = (size_t)max((size + 3) / 4, 1);
+    if (!jobs || blockRows <= COMPRESSION_GRAIN)
+    {
+        UCompressBlockRows(pixels, size, format, blocks, 0, blockRows);
+        return;
+    }
+    jobs->ParallelFor(blockRows, COMPRESSION_GRAIN, [=](size_t begin, size_t end, unsigned)
+        {
+            UCompressBlockRows(pixels, size, format, blocks, begin, end);
+        });
+}
+
+
+// Compresses an RGBA level and its mip chain, packed as UGenerateMipChain leaves them, into
+// UTextureChainBytes(format, size) bytes of blocks, each level right after the previous one
+void UCompressMipChain(const uint8_t* levels, int size, Texture_Format format, uint8_t* blocks, JobSystem* jobs)
+{
+    for (; size >= 1; size /= 2)
+    {
+        UCompressImage(levels, size, format, blocks, jobs);
+        levels += (size_t)size * size * 4;
+        blocks += UTextureLevelBytes(format, size);
+    }
+}
+
+
+// Peak signal to noise ratio in dB of a compressed size x size image (size a multiple of 4) against its RGBA source,
+// over the color channels for BC1 and all four for BC3; infinity if they are identical
+double UCompressionPSNR(const uint8_t* pixels, int size, Texture_Format format, const uint8_t* blocks)
+{
+    const int channels = format == TEXTURE_FORMAT_BC3 ? 4 : 3;
+    const size_t blockBytes = format == TEXTURE_FORMAT_BC3 ? BC3_BLOCK_BYTES : BC1_BLOCK_BYTES;
+    const int blocksPerRow = size / 4;
+    double squaredError = 0.0;
+    uint8_t decoded[16 * 4];
+    for (int row = 0; row < blocksPerRow; ++row)
+    {
+        for (int column = 0; column < blocksPerRow; ++column)
+        {
+            UDecodeBlock(format, blocks + ((size_t)row * blocksPerRow + column) * blockBytes, decoded);
+            for (int y = 0; y < 4; ++y)
+            {
+                const uint8_t* source = pixels + (((size_t)row * 4 + y) * size + column * 4) * 4;
+                for (int x = 0; x < 4; ++x)
+                {
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        const double difference = (double)source[x * 4 + c] - decoded[(y * 4 + x) * 4 + c];
+                        squaredError += difference * difference;
+                    }
+                }
+            }
+        }
+    }
+
+    const double meanSquaredError = squaredError / ((double)size * size * channels);
+    if (meanSquaredError == 0.0)
+        return numeric_limits<double>::infinity();
+    return 10.0 * log10(255.0 * 255.0 / meanSquaredError);
+}
+
+
+// Splits a block's pixels into one float array per channel
+void ULoadBlock(const uint8_t* pixels, size_t rowBytes, BlockPixels& block)
+{
+    for (int y = 0; y < 4; ++y)
+    {
+        const uint8_t* row = pixels + y * rowBytes;
+        for (int x = 0; x < 4; ++x)
+        {
+            block.r[y * 4 + x] = row[x * 4];
+            block.g[y * 4 + x] = row[x * 4 + 1];
+            block.b[y * 4 + x] = row[x * 4 + 2];
+            block.a[y * 4 + x] = row[x * 4 + 3];
+        }
+    }
+}
+
+
+// Rounds a 0-255 color to 5, 6 and 5 bits, red in the top bits
+uint16_t UPackColor565(const float color[3])
+{
+    const int r = (int)(min(max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    const int g = (int)(min(max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+    const int b = (int)(min(max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)(r << 11 | g << 5 | b);
+}
+
+
+// The 0-255 color a GPU expands an RGB565 value to, replicating the top bits into the bottom ones
+void UUnpackColor565(uint16_t packed, float color[3])
+{
+    const int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (float)(r << 3 | r >> 2);
+    color[1] = (float)(g << 2 | g >> 4);
+    color[2] = (float)(b << 3 | b >> 2);
+}
+
+
+// Sets every pixel's index to the nearest of the four palette colors, SIMD_WIDTH pixels at a time, and returns
+// the block's summed squared error
+float USelectColorIndices(const BlockPixels& block, const float palette[4][3], uint8_t indices[16])
+{
+    alignas(32) float errors[16];
+    alignas(32) float chosen[16];
+    size_t i = 0;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+    for (; i + SIMD_WIDTH <= 16; i += SIMD_WIDTH)
+    {
+        const SimdFloat r = USimdLoad(&block.r[i]);
+        const SimdFloat g = USimdLoad(&block.g[i]);
+        const SimdFloat b = USimdLoad(&block.b[i]);
+        SimdFloat best = USimdSplat(numeric_limits<float>::max());
+        SimdFloat bestIndex = USimdSplat(0.0f);
+        for (int k = 0; k < 4; ++k)
+        {
+            const SimdFloat dr = USimdAdd(r, USimdSplat(-palette[k][0]));
+            const SimdFloat dg = USimdAdd(g, USimdSplat(-palette[k][1]));
+            const SimdFloat db = USimdAdd(b, USimdSplat(-palette[k][2]));
+            const SimdFloat distance = USimdMulAdd(dr, dr, USimdMulAdd(dg, dg, USimdMul(db, db)));
+            bestIndex = USimdSelect(USimdGreater(best, distance), USimdSplat((float)k), bestIndex);
+            best = USimdMin(best, distance);
+        }
+        USimdStore(&errors[i], best);
+        USimdStore(&chosen[i], bestIndex);
+    }
+#endif
+    for (; i < 16; ++i)
+    {
+        errors[i] = numeric_limits<float>::max();
+        for (int k = 0; k < 4; ++k)
+        {
+            const float dr = block.r[i] - palette[k][0], dg = block.g[i] - palette[k][1], db = block.b[i] - palette[k][2];
+            const float distance = dr * dr + dg * dg + db * db;
+            if (distance < errors[i])
+            {
+                errors[i] = distance;
+                chosen[i] = (float)k;
+            }
+        }
+    }
+
+    float error = 0.0f;
+    for (i = 0; i < 16; ++i)
+    {
+        error += errors[i];
+        indices[i] = (uint8_t)chosen[i];
+    }
+    return error;
+}
+
+
+// Sets every pixel's index to the nearest of the eight palette alphas, SIMD_WIDTH pixels at a time, and returns
+// the block's summed squared error
+float USelectAlphaIndices(const BlockPixels& block, const float palette[8], uint8_t indices[16])
+{
+    alignas(32) float errors[16];
+    alignas(32) float chosen[16];
+    size_t i = 0;
+#if defined(SIMD_AVX) || defined(SIMD_SSE)
+    for (; i + SIMD_WIDTH <= 16; i += SIMD_WIDTH)
+    {
+        const SimdFloat a = USimdLoad(&block.a[i]);
+        SimdFloat best = USimdSplat(numeric_limits<float>::max());
+        SimdFloat bestIndex = USimdSplat(0.0f);
+        for (int k = 0; k < 8; ++k)
+        {
+            const SimdFloat difference = USimdAdd(a, USimdSplat(-palette[k]));
+            const SimdFloat distance = USimdMul(difference, difference);
+            bestIndex = USimdSelect(USimdGreater(best, distance), USimdSplat((float)k), bestIndex);
+            best = USimdMin(best, distance);
+        }
+        USimdStore(&errors[i], best);
+        USimdStore(&chosen[i], bestIndex);
+    }
+#endif
+    for (; i < 16; ++i)
+    {
+        errors[i] = numeric_limits<float>::max();
+        for (int k = 0; k < 8; ++k)
+        {
+            const float difference = block.a[i] - palette[k];
+            if (difference * difference < errors[i])
+            {
+                errors[i] = difference * difference;
+                chosen[i] = (float)k;
+            }
+        }
+    }
+
+    float error = 0.0f;
+    for (i = 0; i < 16; ++i)
+    {
+        error += errors[i];
+        indices[i] = (uint8_t)chosen[i];
+    }
+    return error;
+}
+
+
+// Rounds two endpoint colors to RGB565, orders them for BC1's four-color mode (first > second), picks every pixel's
+// index against the colors a GPU decodes and writes the 8-byte block. Returns the squared error; indices receives
+// the pixels' palette entries.
+float UWriteColorBlock(const BlockPixels& block, const float first[3], const float second[3], uint8_t* output, uint8_t indices[16])
+{
+    uint16_t packed0 = UPackColor565(first);
+    uint16_t packed1 = UPackColor565(second);
+    if (packed0 < packed1)
+        swap(packed0, packed1);
+
+    float palette[4][3];
+    UUnpackColor565(packed0, palette[0]);
+    UUnpackColor565(packed1, palette[1]);
+    float error;
+    if (packed0 == packed1)
+    {
+        // Equal endpoints would switch the block to three colors, where index 3 is black: keep every pixel at 0
+        palette[2][0] = palette[3][0] = palette[0][0];
+        palette[2][1] = palette[3][1] = palette[0][1];
+        palette[2][2] = palette[3][2] = palette[0][2];
+        error = USelectColorIndices(block, palette, indices);
+        memset(indices, 0, 16);
+    }
+    else
+    {
+        for (int k = 2; k < 4; ++k)
+            for (int c = 0; c < 3; ++c)
+                palette[k][c] = (float)(int)(palette[0][c] * BC1_WEIGHTS[k] + palette[1][c] * (1.0f - BC1_WEIGHTS[k]) + 0.5f);
+        error = USelectColorIndices(block, palette, indices);
+    }
+
+    uint32_t packedIndices = 0;
+    for (int i = 0; i < 16; ++i)
+        packedIndices |= (uint32_t)indices[i] << (2 * i);
+    output[0] = (uint8_t)packed0;
+    output[1] = (uint8_t)(packed0 >> 8);
+    output[2] = (uint8_t)packed1;
+    output[3] = (uint8_t)(packed1 >> 8);
+    for (int byte = 0; byte < 4; ++byte)
+        output[4 + byte] = (uint8_t)(packedIndices >> (8 * byte));
+    return error;
+}
+
+
+// Fits a BC1 color block: the endpoints start at the extremes of the pixels along their principal axis, then one
+// least-squares pass moves them to where they best reproduce the pixels with the indices chosen; the better fit is kept
+void UEncodeColorBlock(const BlockPixels& block, uint8_t* output)
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+    {
+        mean[0] += block.r[i];
+        mean[1] += block.g[i];
+        mean[2] += block.b[i];
+    }
+    for (float& channel : mean)
+        channel /= 16.0f;
+
+    // Covariance rr, rg, rb, gg, gb, bb
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+    {
+        const float r = block.r[i] - mean[0], g = block.g[i] - mean[1], b = block.b[i] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // Principal axis by power iteration, starting from the covariance column of the widest channel
+    float axis[3];
+    if (covariance[0] >= covariance[3] && covariance[0] >= covariance[5])
+        axis[0] = covariance[0], axis[1] = covariance[1], axis[2] = covariance[2];
+    else if (covariance[3] >= covariance[5])
+        axis[0] = covariance[1], axis[1] = covariance[3], axis[2] = covariance[4];
+    else
+        axis[0] = covariance[2], axis[1] = covariance[4], axis[2] = covariance[5];
+    for (int iteration = 0; iteration < 4; ++iteration)
+    {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        const float scale = max(max(fabs(x), fabs(y)), fabs(z));
+        if (scale <= 0.0f)
+            break;
+        axis[0] = x / scale;
+        axis[1] = y / scale;
+        axis[2] = z / scale;
+    }
+
+    float first[3] = { mean[0], mean[1], mean[2] };
+    float second[3] = { mean[0], mean[1], mean[2] };
+    const float length = sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (length > 1e-6f)
+    {
+        for (float& component : axis)
+            component /= length;
+        float low = numeric_limits<float>::max(), high = -numeric_limits<float>::max();
+        for (int i = 0; i < 16; ++i)
+        {
+            const float t = (block.r[i] - mean[0]) * axis[0] + (block.g[i] - mean[1]) * axis[1] + (block.b[i] - mean[2]) * axis[2];
+            low = min(low, t);
+            high = max(high, t);
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            first[c] = mean[c] + high * axis[c];
+            second[c] = mean[c] + low * axis[c];
+        }
+    }
+
+    uint8_t indices[16];
+    float error = UWriteColorBlock(block, first, second, output, indices);
+    if (error == 0.0f)
+        return;
+
+    // Least squares: with w the first endpoint's weight in each pixel's palette entry, solve
+    // [sum w^2, sum w(1-w); sum w(1-w), sum (1-w)^2] [first; second] = [sum w p; sum (1-w) p] per channel
+    float ww = 0.0f, wv = 0.0f, vv = 0.0f;
+    float wp[3] = { 0.0f, 0.0f, 0.0f }, vp[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+    {
+        const float w = BC1_WEIGHTS[indices[i]], v = 1.0f - w;
+        const float pixel[3] = { block.r[i], block.g[i], block.b[i] };
+        ww += w * w;
+        wv += w * v;
+        vv += v * v;
+        for (int c = 0; c < 3; ++c)
+        {
+            wp[c] += w * pixel[c];
+            vp[c] += v * pixel[c];
+        }
+    }
+    const float determinant = ww * vv - wv * wv;
+    if (fabs(determinant) < 1e-6f)
+        return;
+    for (int c = 0; c < 3; ++c)
+    {
+        first[c] = (vv * wp[c] - wv * vp[c]) / determinant;
+        second[c] = (ww * vp[c] - wv * wp[c]) / determinant;
+    }
+
+    uint8_t refined[8], refinedIndices[16];
+    if (UWriteColorBlock(block, first, second, refined, refinedIndices) < error)
+        memcpy(output, refined, sizeof(refined));
+}
+
+
+// Fits a BC3 alpha block between the block's highest and lowest alpha, with the six values between them
+void UEncodeAlphaBlock(const BlockPixels& block, uint8_t* output)
+{
+    float high = block.a[0], low = block.a[0];
+    for (int i = 1; i < 16; ++i)
+    {
+        high = max(high, block.a[i]);
+        low = min(low, block.a[i]);
+    }
+    const int alpha0 = (int)high, alpha1 = (int)low;
+    output[0] = (uint8_t)alpha0;
+    output[1] = (uint8_t)alpha1;
+
+    uint8_t indices[16] = {};
+    if (alpha0 > alpha1)
+    {
+        float palette[8] = { (float)alpha0, (float)alpha1 };
+        for (int k = 2; k < 8; ++k)
+            palette[k] = (float)(((8 - k) * alpha0 + (k - 1) * alpha1 + 3) / 7);
+        USelectAlphaIndices(block, palette, indices);
+    }
+
+    uint64_t packedIndices = 0;
+    for (int i = 0; i < 16; ++i)
+        packedIndices |= (uint64_t)indices[i] << (3 * i);
+    for (int byte = 0; byte < 6; ++byte)
+        output[2 + byte] = (uint8_t)(packedIndices >> (8 * byte));
+}
+
+
+// Compresses block rows [firstRow, endRow) of a square image
+void UCompressBlockRows(const uint8_t* pixels, int size, Texture_Format format, uint8_t* blocks, size_t firstRow, size_t endRow)
+{
+    const int blocksPerRow = max((size + 3) / 4, 1);
+    const size_t blockBytes = format == TEXTURE_FORMAT_BC3 ? BC3_BLOCK_BYTES : BC1_BLOCK_BYTES;
+    uint8_t padded[16 * 4];
+    for (size_t row = firstRow; row < endRow; ++row)
+    {
+        for (int column = 0; column < blocksPerRow; ++column)
+        {
+            const uint8_t* source = padded;
+            size_t rowBytes = 16;
+            if (size >= 4)
+            {
+                source = pixels + ((row * 4) * size + column * 4) * 4;
+                rowBytes = (size_t)size * 4;
+            }
+            else
+            {
+                for (int y = 0; y < 4; ++y)
+                    for (int x = 0; x < 4; ++x)
+                        memcpy(padded + (y * 4 + x) * 4, pixels + ((size_t)min(y, size - 1) * size + min(x, size - 1)) * 4, 4);
+            }
+
+            uint8_t* block = blocks + (row * blocksPerRow + column) * blockBytes;
+            if (format == TEXTURE_FORMAT_BC3)
+                UEncodeBC3Block(source, rowBytes, block);
+            else
+                UEncodeBC1Block(source, rowBytes, block);
+        }
+    }
+}
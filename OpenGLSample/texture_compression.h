@@ -0,0 +1,39 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class JobSystem;
+
+// Pixel layouts a texture layer can be stored and uploaded in. The block formats cut a layer's memory (and the
+// bandwidth of sampling it) to 4 bits per pixel for BC1 and 8 for BC3, against 32 for RGBA8.
+enum Texture_Format : uint32_t {
+    TEXTURE_FORMAT_RGBA8,       // 4 bytes per pixel, bottom row first
+    TEXTURE_FORMAT_BC1,         // 8 bytes per 4x4 block: two RGB565 endpoints and a 2-bit index per pixel, opaque
+    TEXTURE_FORMAT_BC3,         // 16 bytes per 4x4 block: a BC1 color block after an alpha block with 3-bit indices
+};
+
+// Bytes of one encoded 4x4 block
+const size_t BC1_BLOCK_BYTES = 8;
+const size_t BC3_BLOCK_BYTES = 16;
+
+/* Texture compression function prototypes to:
+ * name a format and parse its name, size one level or a level and its mip chain in a format,
+ * encode a 4x4 block of RGBA pixels as BC1 or BC3 and decode a block back,
+ * compress a square RGBA image or a whole RGBA mip chain, splitting the block rows over the job system if given one,
+ * and measure the PSNR of a compressed image against its source (RGB for BC1, RGBA for BC3)
+ */
+const char* UTextureFormatName(Texture_Format format);
+bool UParseTextureFormat(const std::string& name, Texture_Format& format);
+size_t UTextureLevelBytes(Texture_Format format, int size);
+size_t UTextureChainBytes(Texture_Format format, int size);
+void UEncodeBC1Block(const uint8_t* pixels, size_t rowBytes, uint8_t* block);
+void UEncodeBC3Block(const uint8_t* pixels, size_t rowBytes, uint8_t* block);
+void UDecodeBlock(Texture_Format format, const uint8_t* block, uint8_t* pixels);
+void UCompressImage(const uint8_t* pixels, int size, Texture_Format format, uint8_t* blocks, JobSystem* jobs = nullptr);
+void UCompressMipChain(const uint8_t* levels, int size, Texture_Format format, uint8_t* blocks, JobSystem* jobs = nullptr);
+double UCompressionPSNR(const uint8_t* pixels, int size, Texture_Format format, const uint8_t* blocks);
+
+#endif
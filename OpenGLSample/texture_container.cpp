@@ -0,0 +1,209 @@
+#include <iostream>         // cout
+#include <fstream>          // ifstream, ofstream
+#include <cstring>          // memcmp, memcpy
+#include <algorithm>        // max
+#include <filesystem>       // file_size, last_write_time, create_directories, rename
+#include <system_error>     // error_code
+
+#include "stb_image.h"      // Image loading Utility functions
+
+#include "texture_container.h"
+#include "image.h"          // Resampling and mip generation
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    const char TEXTURE_CONTAINER_MAGIC[4] = { 'T', 'E', 'X', 'B' };
+    const uint32_t TEXTURE_CONTAINER_VERSION = 1;
+
+    // Bytes read at a time while hashing a file
+    const size_t HASH_CHUNK = 1 << 20;
+}
+
+
+// Where texture_baker writes the bake of a texture path relative to RESOURCE_DIR in a format, under directory.
+// The format is part of the name, so bakes of the same texture in different formats live side by side.
+string UBakedTexturePath(const string& texturePath, Texture_Format format, const string& directory)
+{
+    return directory + "/" + texturePath + "." + UTextureFormatName(format) + ".texb";
+}
+
+
+// Size and modification time of a file, false if it does not exist. The time is in the file system's own ticks,
+// only ever compared with another stamp taken on the same machine.
+bool UFileStamp(const string& filename, uint64_t& size, int64_t& time)
+{
+    error_code error;
+    size = (uint64_t)filesystem::file_size(filename, error);
+    if (error)
+        return false;
+    time = (int64_t)filesystem::last_write_time(filename, error).time_since_epoch().count();
+    return !error;
+}
+
+
+// 64-bit FNV-1a hash of a file's bytes
+bool UHashFile(const string& filename, uint64_t& hash)
+{
+    ifstream file(filename, ios::binary);
+    if (!file.is_open())
+        return false;
+
+    vector<char> chunk(HASH_CHUNK);
+    hash = 0xCBF29CE484222325ull;
+    while (file)
+    {
+        file.read(chunk.data(), chunk.size());
+        const streamsize count = file.gcount();
+        for (streamsize i = 0; i < count; ++i)
+        {
+            hash ^= (uint8_t)chunk[i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return true;
+}
+
+
+// Decodes an image file and resamples it the way the renderers fill a texture array layer, bottom row first, followed
+// by its mip chain: UMipChainBytes(size) bytes in levels
+bool UBakeTexture(const string& sourceFile, int size, vector<uint8_t>& levels)
+{
+    int width, height, channels;
+    unsigned char* image = stbi_load(sourceFile.c_str(), &width, &height, &channels, 4);
+    if (!image)
+        return false;
+
+    levels.resize(UMipChainBytes(size));
+    UResampleToLayer(image, width, height, true, size, levels.data());
+    UGenerateMipChain(levels.data(), size);
+    stbi_image_free(image);
+    return true;
+}
+
+
+// Writes a container holding header.levels levels of header.format, starting at header.size, from data. Fills in the
+// header's magic, version and data layout. The file is written under a temporary name and renamed over the old one,
+// so a program mapping the old bake never sees a half-written file.
+bool UWriteTextureContainer(const string& filename, TextureContainerHeader header, const uint8_t* data)
+{
+    memcpy(header.magic, TEXTURE_CONTAINER_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CONTAINER_VERSION;
+    header.reserved = 0;
+    header.dataOffset = TEXTURE_CONTAINER_ALIGNMENT;
+    header.dataSize = 0;
+    for (uint32_t level = 0; level < TEXTURE_CONTAINER_MAX_LEVELS; ++level)
+    {
+        header.levelOffsets[level] = level < header.levels ? header.dataSize : 0;
+        if (level < header.levels)
+            header.dataSize += UTextureLevelBytes((Texture_Format)header.format, (int)max(header.size >> level, 1u));
+    }
+
+    error_code error;
+    filesystem::create_directories(filesystem::path(filename).parent_path(), error);
+    const string temporary = filename + ".tmp";
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        if (!file.is_open())
+        {
+            cout << "Failed to write texture container " << filename << endl;
+            return false;
+        }
+        const vector<char> padding(header.dataOffset - sizeof(header), 0);
+        file.write((const char*)&header, sizeof(header));
+        file.write(padding.data(), padding.size());
+        file.write((const char*)data, header.dataSize);
+        if (!file)
+        {
+            cout << "Failed to write texture container " << filename << endl;
+            return false;
+        }
+    }
+    filesystem::rename(temporary, filename, error);
+    return !error;
+}
+
+
+// Maps a container and checks its magic, version and that every level lies inside the file; the header stays valid
+// while mapped is open. Returns nullptr for a missing or damaged file.
+const TextureContainerHeader* UMapTextureContainer(const string& filename, MappedFile& mapped)
+{
+    if (!mapped.Open(filename) || mapped.Size() < sizeof(TextureContainerHeader))
+        return nullptr;
+
+    const TextureContainerHeader* header = (const TextureContainerHeader*)mapped.Data();
+    if (memcmp(header->magic, TEXTURE_CONTAINER_MAGIC, sizeof(header->magic)) != 0 || header->version != TEXTURE_CONTAINER_VERSION
+        || header->levels == 0 || header->levels > TEXTURE_CONTAINER_MAX_LEVELS
+        || header->dataOffset > mapped.Size() || header->dataSize > mapped.Size() - header->dataOffset)
+    {
+        mapped.Close();
+        return nullptr;
+    }
+    return header;
+}
+
+
+// True if the source still has the size and modification time it had when baked, or is not there at all
+// (a build that ships only the bakes)
+bool UTextureContainerCurrent(const TextureContainerHeader& header, const string& sourceFile)
+{
+    uint64_t size;
+    int64_t time;
+    if (!UFileStamp(sourceFile, size, time))
+        return true;
+    return size == header.sourceSize && time == header.sourceTime;
+}
+
+
+// Copies the bake of a texture (a path relative to RESOURCE_DIR) into levels if there is a current one holding
+// the full mip chain of a size x size layer in format: UTextureChainBytes(format, size) bytes. False if it has to be
+// decoded instead.
+bool UReadBakedTexture(const string& texturePath, int size, Texture_Format format, uint8_t* levels)
+{
+    MappedFile mapped;
+    const TextureContainerHeader* header = UMapTextureContainer(UBakedTexturePath(texturePath, format), mapped);
+    if (!header || header->format != (uint32_t)format || header->size != (uint32_t)size
+        || header->dataSize != UTextureChainBytes(format, size) || !UTextureContainerCurrent(*header, string(RESOURCE_DIR "/") + texturePath))
+        return false;
+
+    memcpy(levels, mapped.Data() + header->dataOffset, header->dataSize);
+    return true;
+}
+
+
+// Fills levels with a texture's size x size layer and its mip chain in format, UTextureChainBytes(format, size) bytes:
+// with useBakes, from a current bake in that format, else from its RGBA8 bake; failing that, from the image file,
+// resampled and mipmapped. RGBA8 levels are block compressed here for the other formats. baked tells whether a
+// bake was used.
+bool ULoadTextureLevels(const string& texturePath, int size, Texture_Format format, bool useBakes, uint8_t* levels, bool& baked)
+{
+    baked = useBakes && UReadBakedTexture(texturePath, size, format, levels);
+    if (baked)
+        return true;
+
+    vector<uint8_t> decoded;
+    uint8_t* rgba = levels;
+    if (format != TEXTURE_FORMAT_RGBA8)
+    {
+        decoded.resize(UMipChainBytes(size));
+        rgba = decoded.data();
+    }
+
+    baked = useBakes && UReadBakedTexture(texturePath, size, TEXTURE_FORMAT_RGBA8, rgba);
+    if (!baked)
+    {
+        int width, height, channels;
+        unsigned char* image = stbi_load((string(RESOURCE_DIR "/") + texturePath).c_str(), &width, &height, &channels, 4);
+        if (!image)
+            return false;
+        UResampleToLayer(image, width, height, true, size, rgba);
+        UGenerateMipChain(rgba, size);
+        stbi_image_free(image);
+    }
+
+    if (format != TEXTURE_FORMAT_RGBA8)
+        UCompressMipChain(rgba, size, format, levels);
+    return true;
+}
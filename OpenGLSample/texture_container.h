@@ -0,0 +1,63 @@
+#ifndef TEXTURE_CONTAINER_H
+#define TEXTURE_CONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "scene.h"          // RESOURCE_DIR
+#include "mapped_file.h"    // Read-only file mapping
+#include "texture_compression.h"    // Texture_Format, block compression
+
+// Folder holding the baked textures, the paths below RESOURCE_DIR with the format and .texb appended. CMake points
+// this at the build tree, where the build runs texture_baker over the shipped scenes.
+#ifndef BAKED_TEXTURE_DIR
+#define BAKED_TEXTURE_DIR RESOURCE_DIR "/baked"
+#endif
+
+// Mip levels a container can describe (enough for 32768 x 32768)
+const uint32_t TEXTURE_CONTAINER_MAX_LEVELS = 16;
+
+// The pixel data starts on a page boundary, so a mapping hands it out page aligned
+const size_t TEXTURE_CONTAINER_ALIGNMENT = 4096;
+
+// Start of a .texb file. The pixel data follows at dataOffset: every mip level of a square image in format, largest
+// first, packed one after the other, so the data block has the same layout as the renderer's pixel buffer slots and
+// is uploaded with one copy. The source's size and modification time tell the runtime cheaply whether the
+// bake is current; its content hash tells texture_baker whether a source with a new time actually changed.
+struct TextureContainerHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t format;            // Texture_Format
+    uint32_t size;              // width and height of level 0
+    uint32_t levels;
+    uint32_t reserved;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t sourceHash;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint64_t levelOffsets[TEXTURE_CONTAINER_MAX_LEVELS];    // from dataOffset
+};
+
+/* Texture container function prototypes to:
+ * name the baked file of a texture in a format, read a file's size and modification time, hash its contents,
+ * bake an image file into a square RGBA8 layer of the given size with its full mip chain, bottom row first,
+ * write a container, map one after checking it is intact, check it was baked from the source as it is now,
+ * copy a current bake of a texture into memory, as the loaders do before falling back to decoding,
+ * and get a texture's levels in any format: from its bake in that format, by compressing its RGBA8 bake,
+ * or from its image file
+ */
+std::string UBakedTexturePath(const std::string& texturePath, Texture_Format format, const std::string& directory = BAKED_TEXTURE_DIR);
+bool UFileStamp(const std::string& filename, uint64_t& size, int64_t& time);
+bool UHashFile(const std::string& filename, uint64_t& hash);
+bool UBakeTexture(const std::string& sourceFile, int size, std::vector<uint8_t>& levels);
+bool UWriteTextureContainer(const std::string& filename, TextureContainerHeader header, const uint8_t* data);
+const TextureContainerHeader* UMapTextureContainer(const std::string& filename, MappedFile& mapped);
+bool UTextureContainerCurrent(const TextureContainerHeader& header, const std::string& sourceFile);
+bool UReadBakedTexture(const std::string& texturePath, int size, Texture_Format format, uint8_t* levels);
+bool ULoadTextureLevels(const std::string& texturePath, int size, Texture_Format format, bool useBakes, uint8_t* levels, bool& baked);
+
+#endif
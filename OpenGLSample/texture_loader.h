@@ -0,0 +1,183 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A texture file decoded into memory, bottom row first as glTexImage2D expects unless topRowFirst
+// (rows still in file order, left for the GPU copy to flip). The pixels are either allocated by the decoder
+// or live in slot bufferSlot of the renderer's pixel buffer ring. A mip chain image is already a layer followed
+// by its mips in the texture array's format, read from its texture container (baked) or resampled, and compressed
+// if the array is, on the loader thread.
+struct DecodedImage
+{
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    bool topRowFirst = false;
+    int bufferSlot = -1;
+    bool mipChain = false;
+    bool baked = false;
+};
+
+// One finished decode handed back to the GL thread: which file of the batch it is, the image (no pixels if the
+// file could not be decoded) and how long decoding took
+struct LoadedImage
+{
+    size_t index = 0;
+    DecodedImage image;
+    double decodeMs = 0.0;
+    LoadedImage* next = nullptr;
+};
+
+// Decodes a batch of image files on background threads while the caller keeps rendering. Each thread claims the
+// next file with an atomic counter, decodes it, and pushes the result onto a lock-free stack (one compare-and-swap);
+// the GL thread takes finished images with Take whenever it has time to upload them. The threads are the loader's
+// own rather than jobs, so a long decode never runs inside a frame's ParallelFor.
+class TextureLoader
+{
+public:
+    // decodes one file; must be safe to call from several threads at once
+    using DecodeFunction = std::function<bool(const std::string& file, DecodedImage& image)>;
+    // releases what DecodeFunction allocated
+    using FreeFunction = std::function<void(DecodedImage& image)>;
+
+    TextureLoader(DecodeFunction decode, FreeFunction release) : decode(decode), release(release) {}
+
+    ~TextureLoader() { Cancel(); }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // starts decoding files on threads threads (0: every hardware thread, at most one per file), cancelling any earlier batch
+    void Start(const std::vector<std::string>& files, unsigned threads = 0)
+    {
+        Cancel();
+        this->files = files;
+        nextFile.store(0);
+        taken = 0;
+        cancelled.store(false);
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = (unsigned)std::min<size_t>(threads, files.size());
+        for (unsigned thread = 0; thread < threads; ++thread)
+            workers.emplace_back(&TextureLoader::DecodeLoop, this);
+    }
+
+    // next finished image, or nullptr if none is ready yet. GL thread only; the caller frees it with Free
+    LoadedImage* Take()
+    {
+        if (!ready)
+        {
+            // grab everything pushed so far and reverse it, so images come out about in the order they finished
+            LoadedImage* stack = finished.exchange(nullptr, std::memory_order_acquire);
+            while (stack)
+            {
+                LoadedImage* next = stack->next;
+                stack->next = ready;
+                ready = stack;
+                stack = next;
+            }
+        }
+        LoadedImage* image = ready;
+        if (image)
+        {
+            ready = image->next;
+            ++taken;
+        }
+        return image;
+    }
+
+    void Free(LoadedImage* image)
+    {
+        if (image->image.pixels)
+            release(image->image);
+        delete image;
+    }
+
+    // files whose image has not been taken yet
+    size_t Remaining() const { return files.size() - taken; }
+    bool Done() const { return taken == files.size(); }
+
+    // GL thread: blocks until Take has an image to return, or returns at once if every image has been taken
+    void Wait()
+    {
+        if (ready || Done())
+            return;
+        std::unique_lock<std::mutex> lock(pushMutex);
+        pushed.wait(lock, [this] { return finished.load(std::memory_order_acquire) != nullptr; });
+    }
+
+    // blocks until every file is decoded and joins the threads; Take then returns the rest without waiting
+    void Finish()
+    {
+        for (std::thread& worker : workers)
+            worker.join();
+        workers.clear();
+    }
+
+    // stops after the decodes in flight and drops every image not taken yet
+    void Cancel()
+    {
+        cancelled.store(true);
+        Finish();
+        while (LoadedImage* image = Take())
+            Free(image);
+        files.clear();
+        taken = 0;
+    }
+
+private:
+    void DecodeLoop()
+    {
+        for (;;)
+        {
+            const size_t index = nextFile.fetch_add(1);
+            if (index >= files.size() || cancelled.load())
+                return;
+
+            LoadedImage* loaded = new LoadedImage;
+            loaded->index = index;
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (!decode(files[index], loaded->image))
+                loaded->image = DecodedImage();
+            loaded->decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            loaded->next = finished.load(std::memory_order_relaxed);
+            while (!finished.compare_exchange_weak(loaded->next, loaded, std::memory_order_release, std::memory_order_relaxed))
+                ;
+
+            // taking the lock orders the push before a Wait that checked the stack, so its wake-up is not lost
+            {
+                std::lock_guard<std::mutex> lock(pushMutex);
+            }
+            pushed.notify_one();
+        }
+    }
+
+    DecodeFunction decode;
+    FreeFunction release;
+
+    std::vector<std::string> files;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextFile{ 0 };
+    std::atomic<bool> cancelled{ false };
+
+    // pushed by the decoding threads; ready and taken belong to the GL thread
+    std::atomic<LoadedImage*> finished{ nullptr };
+    std::mutex pushMutex;
+    std::condition_variable pushed;
+    LoadedImage* ready = nullptr;
+    size_t taken = 0;
+};
+
+#endif
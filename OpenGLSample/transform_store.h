@@ -0,0 +1,140 @@
+#ifndef TRANSFORM_STORE_H
+#define TRANSFORM_STORE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "job_system.h"     // Parallel matrix rebuilds
+
+// Matrices one job rebuilds when Update runs on a job system; fewer dirty transforms than this stay on the caller
+const size_t TRANSFORM_UPDATE_GRAIN = 1024;
+
+// Positions, rotations and scales of every object kept in separate arrays (structure of arrays),
+// with the world matrices cached in one contiguous array.
+// A matrix is only rebuilt when one of its components changed since the last Update,
+// so a static scene costs nothing per frame.
+class TransformStore
+{
+public:
+    // appends a transform and returns its index; new transforms start dirty
+    uint32_t Add(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+    {
+        uint32_t index = (uint32_t)positions.size();
+        positions.push_back(position);
+        rotations.push_back(rotation);
+        scales.push_back(scale);
+        worlds.push_back(glm::mat4(1.0f));
+        dirty.push_back(0);
+        MarkDirty(index);
+        return index;
+    }
+
+    void Clear()
+    {
+        positions.clear();
+        rotations.clear();
+        scales.clear();
+        worlds.clear();
+        dirty.clear();
+        dirtyIndices.clear();
+        updatedIndices.clear();
+    }
+
+    void Reserve(size_t count)
+    {
+        positions.reserve(count);
+        rotations.reserve(count);
+        scales.reserve(count);
+        worlds.reserve(count);
+        dirty.reserve(count);
+    }
+
+    // setters flag the transform so the next Update rebuilds its matrix
+    void SetPosition(uint32_t index, const glm::vec3& position) { positions[index] = position; MarkDirty(index); }
+    void SetRotation(uint32_t index, const glm::vec3& rotation) { rotations[index] = rotation; MarkDirty(index); }
+    void SetScale(uint32_t index, const glm::vec3& scale) { scales[index] = scale; MarkDirty(index); }
+
+    // flags every transform, e.g. when the matrices are copied into a different buffer from now on
+    void Invalidate()
+    {
+        for (uint32_t index = 0; index < (uint32_t)positions.size(); ++index)
+            MarkDirty(index);
+    }
+
+    const glm::vec3& Position(uint32_t index) const { return positions[index]; }
+    const glm::vec3& Rotation(uint32_t index) const { return rotations[index]; }
+    const glm::vec3& Scale(uint32_t index) const { return scales[index]; }
+
+    // rebuilds the matrices of the dirty transforms only, returns how many were rebuilt
+    size_t Update()
+    {
+        updatedIndices.swap(dirtyIndices);
+        dirtyIndices.clear();
+
+        Rebuild(0, updatedIndices.size());
+        return updatedIndices.size();
+    }
+
+    // the same, with large batches (many moving objects) split across the job system's threads
+    size_t Update(JobSystem& jobs)
+    {
+        updatedIndices.swap(dirtyIndices);
+        dirtyIndices.clear();
+
+        jobs.ParallelFor(updatedIndices.size(), TRANSFORM_UPDATE_GRAIN, [this](size_t begin, size_t end, unsigned) { Rebuild(begin, end); });
+        return updatedIndices.size();
+    }
+
+    // indices rebuilt by the last Update, so callers can copy just those matrices to the GPU
+    const std::vector<uint32_t>& Updated() const { return updatedIndices; }
+
+    // world matrices, one per transform, contiguous and in Add order
+    const glm::mat4* Matrices() const { return worlds.data(); }
+    const glm::mat4& Matrix(uint32_t index) const { return worlds[index]; }
+    size_t Size() const { return positions.size(); }
+
+    // scale, then rotate about X, Y and Z (Euler degrees), then translate
+    static glm::mat4 Compose(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+    {
+        glm::mat4 rotationMatrix = glm::rotate(glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f))
+            * glm::rotate(glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f))
+            * glm::rotate(glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+
+        // transformations are applied right-to-left order
+        return glm::translate(position) * rotationMatrix * glm::scale(scale);
+    }
+
+private:
+    // rebuilds the matrices of updatedIndices[begin, end)
+    void Rebuild(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint32_t index = updatedIndices[i];
+            worlds[index] = Compose(positions[index], rotations[index], scales[index]);
+            dirty[index] = 0;
+        }
+    }
+
+    void MarkDirty(uint32_t index)
+    {
+        if (!dirty[index])
+        {
+            dirty[index] = 1;
+            dirtyIndices.push_back(index);
+        }
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> worlds;
+    std::vector<uint8_t> dirty;             // 1 while the index is queued in dirtyIndices
+    std::vector<uint32_t> dirtyIndices;     // waiting for the next Update
+    std::vector<uint32_t> updatedIndices;   // rebuilt by the last Update
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef UNIFORM_TABLE_H
+#define UNIFORM_TABLE_H
+
+// Include the GL loader (GLEW or glad) before this header
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reflection table of a linked program's active uniforms.
+// Built once after linking so per-frame code never asks the driver for a location by name.
+class UniformTable
+{
+public:
+    // one active uniform as reported by glGetActiveUniform
+    struct Uniform
+    {
+        std::string name;   // array uniforms are stored without their "[0]" suffix
+        GLint location;
+        GLenum type;
+        GLint size;         // number of array elements, 1 for plain uniforms
+    };
+
+    // queries GL_ACTIVE_UNIFORMS of the program and caches every location
+    void Build(GLuint program)
+    {
+        uniforms.clear();
+        indices.clear();
+
+        GLint count = 0, maxNameLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+        std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei length = 0;
+            Uniform uniform;
+            glGetActiveUniform(program, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &uniform.size, &uniform.type, nameBuffer.data());
+            uniform.name.assign(nameBuffer.data(), length);
+
+            // uniforms inside blocks have no location; they are set through buffers instead
+            uniform.location = glGetUniformLocation(program, uniform.name.c_str());
+            if (uniform.location < 0)
+                continue;
+
+            size_t bracket = uniform.name.find("[0]");
+            if (bracket != std::string::npos && bracket + 3 == uniform.name.size())
+                uniform.name.erase(bracket);
+
+            indices[uniform.name] = (int)uniforms.size();
+            uniforms.push_back(uniform);
+        }
+    }
+
+    // location of the named uniform, or -1 (ignored by glUniform*) when the program does not use it
+    GLint Location(const std::string& name) const
+    {
+        std::unordered_map<std::string, int>::const_iterator it = indices.find(name);
+        return it == indices.end() ? -1 : uniforms[it->second].location;
+    }
+
+    // resolves a list of names into locations, typically into an array indexed by an enum
+    void Resolve(const char* const names[], int count, GLint locations[]) const
+    {
+        for (int i = 0; i < count; ++i)
+            locations[i] = Location(names[i]);
+    }
+
+    const std::vector<Uniform>& Uniforms() const
+    {
+        return uniforms;
+    }
+
+private:
+    std::vector<Uniform> uniforms;
+    std::unordered_map<std::string, int> indices;
+};
+#endif
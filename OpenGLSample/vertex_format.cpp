@@ -0,0 +1,330 @@
+#include <algorithm>        // min, max
+#include <cmath>            // sqrt, fabs, lround
+#include <cstring>          // memcpy
+
+#include <glm/gtx/transform.hpp>
+
+#include "vertex_format.h"
+
+using namespace std; // Standard namespace
+
+// Unnamed namespace
+namespace
+{
+    // +1 for zero too, so encoded signs never vanish
+    float USignNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // [-1, 1] to a signed normalized integer with the given number of bits
+    int32_t UToSnorm(float value, int bits)
+    {
+        const float maxValue = (float)((1 << (bits - 1)) - 1);
+        return (int32_t)lround(clamp(value, -1.0f, 1.0f) * maxValue);
+    }
+
+    // [0, 1] to a 16-bit unsigned normalized integer
+    uint16_t UToUnorm16(float value)
+    {
+        return (uint16_t)lround(clamp(value, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    void UPackPosition(const glm::vec3& position, const VertexBounds& bounds, uint16_t packed[4])
+    {
+        const glm::vec3 normalized = (position - bounds.origin) / bounds.size;
+        packed[0] = UToUnorm16(normalized.x);
+        packed[1] = UToUnorm16(normalized.y);
+        packed[2] = UToUnorm16(normalized.z);
+        packed[3] = 0;
+    }
+}
+
+
+// Decodes an octahedral normal; the third component of the fetched attribute is unused
+const char* const PACKED_NORMAL_GLSL =
+    "vec3 decodeNormal(vec3 encoded)\n"
+    "{\n"
+    "    vec3 n = vec3(encoded.xy, 1.0 - abs(encoded.x) - abs(encoded.y));\n"
+    "    float t = max(-n.z, 0.0);\n"
+    "    n.x += n.x >= 0.0 ? -t : t;\n"
+    "    n.y += n.y >= 0.0 ? -t : t;\n"
+    "    return normalize(n);\n"
+    "}\n";
+
+// Rebuilds the dropped largest quaternion component and expands the quaternion into the three axes of the frame
+const char* const PACKED_TANGENT_FRAME_GLSL =
+    "void decodeTangentFrame(vec4 frame, float mirrored, out vec3 normal, out vec3 tangent, out vec3 bitangent)\n"
+    "{\n"
+    "    vec3 small = frame.xyz * 1.41421356 - 0.70710678;\n"
+    "    float largest = sqrt(max(1.0 - dot(small, small), 0.0));\n"
+    "    int index = int(frame.w * 3.0 + 0.5);\n"
+    "    vec4 q = index == 0 ? vec4(largest, small) : index == 1 ? vec4(small.x, largest, small.yz)\n"
+    "        : index == 2 ? vec4(small.xy, largest, small.z) : vec4(small, largest);\n"
+    "    tangent = vec3(1.0 - 2.0 * (q.y * q.y + q.z * q.z), 2.0 * (q.x * q.y + q.w * q.z), 2.0 * (q.x * q.z - q.w * q.y));\n"
+    "    bitangent = vec3(2.0 * (q.x * q.y - q.w * q.z), 1.0 - 2.0 * (q.x * q.x + q.z * q.z), 2.0 * (q.y * q.z + q.w * q.x));\n"
+    "    normal = vec3(2.0 * (q.x * q.z + q.w * q.y), 2.0 * (q.y * q.z - q.w * q.x), 1.0 - 2.0 * (q.x * q.x + q.y * q.y));\n"
+    "    bitangent *= mirrored > 0.5 ? -1.0 : 1.0;\n"
+    "}\n";
+
+
+glm::mat4 VertexBounds::Dequantization() const
+{
+    return glm::translate(origin) * glm::scale(glm::vec3(size));
+}
+
+
+// Smallest cube around the positions (the first three floats of each vertex), anchored at their minimum corner
+VertexBounds UComputeVertexBounds(const float* vertices, size_t count, size_t floatsPerVertex)
+{
+    VertexBounds bounds;
+    if (count == 0)
+        return bounds;
+
+    glm::vec3 lower(vertices[0], vertices[1], vertices[2]), upper = lower;
+    for (size_t i = 1; i < count; ++i)
+    {
+        const float* position = vertices + i * floatsPerVertex;
+        const glm::vec3 point(position[0], position[1], position[2]);
+        lower = glm::min(lower, point);
+        upper = glm::max(upper, point);
+    }
+
+    const glm::vec3 extent = upper - lower;
+    bounds.origin = lower;
+    bounds.size = max(max(extent.x, extent.y), extent.z);
+    if (bounds.size <= 0.0f)
+        bounds.size = 1.0f;
+    return bounds;
+}
+
+
+// IEEE 754 binary32 to binary16, rounding to nearest even; overflow becomes infinity
+uint16_t UFloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    // NaN and infinity
+    if (exponent == 0xFFu)
+        return (uint16_t)(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+
+    const int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 31)
+        return (uint16_t)(sign | 0x7C00u);
+
+    // Denormal or zero: shift the mantissa, with its implicit bit, into place
+    if (halfExponent <= 0)
+    {
+        if (halfExponent < -10)
+            return (uint16_t)sign;
+        mantissa |= 0x800000u;
+        const int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u)))
+            ++half;
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        ++half;     // may carry into the exponent, which rounds up to the next power of two or infinity
+    return (uint16_t)(sign | half);
+}
+
+
+// IEEE 754 binary16 to binary32
+float UHalfToFloat(uint16_t value)
+{
+    const uint32_t sign = (uint32_t)(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0x1Fu)
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    else if (exponent != 0)
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+        bits = sign;
+    else
+    {
+        // Denormal: normalize it
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400u) == 0)
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+
+// Projects a unit vector onto the octahedron |x| + |y| + |z| = 1 and unfolds the lower half onto the square
+glm::vec2 UEncodeOctahedral(const glm::vec3& normal)
+{
+    const float sum = fabs(normal.x) + fabs(normal.y) + fabs(normal.z);
+    const glm::vec3 n = normal / sum;
+    if (n.z >= 0.0f)
+        return glm::vec2(n.x, n.y);
+    return glm::vec2((1.0f - fabs(n.y)) * USignNotZero(n.x), (1.0f - fabs(n.x)) * USignNotZero(n.y));
+}
+
+
+// Inverse of UEncodeOctahedral, same as decodeNormal in PACKED_NORMAL_GLSL
+glm::vec3 UDecodeOctahedral(const glm::vec2& encoded)
+{
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - fabs(encoded.x) - fabs(encoded.y));
+    const float t = max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+
+// Stores the rotation taking the x, y, z axes to tangent, bitangent, normal as a unit quaternion in "smallest three"
+// form: the largest component is made positive and dropped, the other three (within +-1/sqrt(2)) get 10 bits each and
+// the 2-bit field says which one was dropped. A mirrored frame (bitangent opposite to normal x tangent) is reported
+// through mirrored, since a rotation cannot hold it.
+uint32_t UPackTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent, bool& mirrored)
+{
+    // Orthonormalize: the normal wins, the tangent is made perpendicular to it
+    const glm::vec3 n = glm::normalize(normal);
+    glm::vec3 t = tangent - n * glm::dot(n, tangent);
+    if (glm::dot(t, t) < 1e-12f)
+        t = fabs(n.x) < 0.9f ? glm::cross(n, glm::vec3(1.0f, 0.0f, 0.0f)) : glm::cross(n, glm::vec3(0.0f, 1.0f, 0.0f));
+    t = glm::normalize(t);
+    const glm::vec3 b = glm::cross(n, t);
+    mirrored = glm::dot(b, bitangent) < 0.0f;
+
+    // Rotation matrix with columns t, b, n to quaternion x, y, z, w
+    float q[4];
+    const float trace = t.x + b.y + n.z;
+    if (trace > 0.0f)
+    {
+        const float s = sqrt(trace + 1.0f) * 2.0f;
+        q[3] = 0.25f * s;
+        q[0] = (b.z - n.y) / s;
+        q[1] = (n.x - t.z) / s;
+        q[2] = (t.y - b.x) / s;
+    }
+    else if (t.x > b.y && t.x > n.z)
+    {
+        const float s = sqrt(1.0f + t.x - b.y - n.z) * 2.0f;
+        q[3] = (b.z - n.y) / s;
+        q[0] = 0.25f * s;
+        q[1] = (b.x + t.y) / s;
+        q[2] = (n.x + t.z) / s;
+    }
+    else if (b.y > n.z)
+    {
+        const float s = sqrt(1.0f + b.y - t.x - n.z) * 2.0f;
+        q[3] = (n.x - t.z) / s;
+        q[0] = (b.x + t.y) / s;
+        q[1] = 0.25f * s;
+        q[2] = (n.y + b.z) / s;
+    }
+    else
+    {
+        const float s = sqrt(1.0f + n.z - t.x - b.y) * 2.0f;
+        q[3] = (t.y - b.x) / s;
+        q[0] = (n.x + t.z) / s;
+        q[1] = (n.y + b.z) / s;
+        q[2] = 0.25f * s;
+    }
+
+    // q and -q are the same rotation: keep the one whose largest component is positive, then drop that component
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+        if (fabs(q[i]) > fabs(q[largest]))
+            largest = i;
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint32_t packed = (uint32_t)largest << 30;
+    int shift = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        const float normalized = (q[i] * sign + 0.70710678f) / 1.41421356f;
+        packed |= (uint32_t)lround(clamp(normalized, 0.0f, 1.0f) * 1023.0f) << shift;
+        shift += 10;
+    }
+    return packed;
+}
+
+
+// Inverse of UPackTangentFrame, same as decodeTangentFrame in PACKED_TANGENT_FRAME_GLSL
+void UUnpackTangentFrame(uint32_t packed, bool mirrored, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent)
+{
+    float small[3];
+    for (int i = 0; i < 3; ++i)
+        small[i] = ((packed >> (i * 10)) & 0x3FFu) / 1023.0f * 1.41421356f - 0.70710678f;
+    const float largest = sqrt(max(1.0f - small[0] * small[0] - small[1] * small[1] - small[2] * small[2], 0.0f));
+
+    const int index = (int)(packed >> 30);
+    float q[4];
+    for (int i = 0, j = 0; i < 4; ++i)
+        q[i] = i == index ? largest : small[j++];
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+
+    tangent = glm::vec3(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+    bitangent = glm::vec3(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)) * (mirrored ? -1.0f : 1.0f);
+    normal = glm::vec3(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+}
+
+
+PackedVertex UPackVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const VertexBounds& bounds)
+{
+    PackedVertex packed;
+    UPackPosition(position, bounds, packed.position);
+
+    const glm::vec2 octahedral = UEncodeOctahedral(normal);
+    packed.normal[0] = (int16_t)UToSnorm(octahedral.x, 16);
+    packed.normal[1] = (int16_t)UToSnorm(octahedral.y, 16);
+
+    packed.uv[0] = UFloatToHalf(uv.x);
+    packed.uv[1] = UFloatToHalf(uv.y);
+    return packed;
+}
+
+
+PackedTangentVertex UPackTangentVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv,
+    const glm::vec3& tangent, const glm::vec3& bitangent, const VertexBounds& bounds)
+{
+    PackedTangentVertex packed;
+    UPackPosition(position, bounds, packed.position);
+
+    bool mirrored = false;
+    packed.tangentFrame = UPackTangentFrame(normal, tangent, bitangent, mirrored);
+    packed.position[3] = mirrored ? 0xFFFFu : 0u;
+    packed.uv[0] = UFloatToHalf(uv.x);
+    packed.uv[1] = UFloatToHalf(uv.y);
+    return packed;
+}
+
+
+// Packs vertices in the built-in meshes' layout: 3 floats position, 3 floats normal, 2 floats uv
+std::vector<PackedVertex> UPackVertices(const float* vertices, size_t count, const VertexBounds& bounds)
+{
+    vector<PackedVertex> packed(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* vertex = vertices + i * 8;
+        packed[i] = UPackVertex(glm::vec3(vertex[0], vertex[1], vertex[2]), glm::vec3(vertex[3], vertex[4], vertex[5]),
+            glm::vec2(vertex[6], vertex[7]), bounds);
+    }
+    return packed;
+}
@@ -0,0 +1,61 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 16-byte vertex replacing the 32-byte position, normal, uv float layout of the built-in meshes
+struct PackedVertex
+{
+    uint16_t position[4];   // x, y, z as 16-bit unorm within the mesh's VertexBounds; w is padding
+    int16_t normal[2];      // octahedral-encoded unit normal, 16-bit snorm
+    uint16_t uv[2];         // half floats
+};
+
+// 16-byte vertex replacing the 56-byte mesh.h Vertex (position, normal, uv, tangent, bitangent)
+struct PackedTangentVertex
+{
+    uint16_t position[4];   // x, y, z as 16-bit unorm within the mesh's VertexBounds; w is 65535 for a mirrored frame
+    uint32_t tangentFrame;  // GL_UNSIGNED_INT_2_10_10_10_REV: quaternion as its three smallest components and the index of the largest
+    uint16_t uv[2];         // half floats
+};
+
+// Box the positions of one mesh are quantized in. It is a cube, so dequantizing is a translation and a
+// uniform scale that can be folded into the model matrix without skewing the normals.
+struct VertexBounds
+{
+    glm::vec3 origin = glm::vec3(0.0f);
+    float size = 1.0f;
+
+    // maps quantized positions (0..1 after unorm fetch) back to model space
+    glm::mat4 Dequantization() const;
+};
+
+/* Vertex packing function prototypes to:
+ * compute a mesh's quantization box, convert floats to half floats and back,
+ * encode and decode octahedral normals and quaternion tangent frames,
+ * and pack whole vertices
+ */
+VertexBounds UComputeVertexBounds(const float* vertices, size_t count, size_t floatsPerVertex);
+uint16_t UFloatToHalf(float value);
+float UHalfToFloat(uint16_t value);
+glm::vec2 UEncodeOctahedral(const glm::vec3& normal);
+glm::vec3 UDecodeOctahedral(const glm::vec2& encoded);
+uint32_t UPackTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent, bool& mirrored);
+void UUnpackTangentFrame(uint32_t packed, bool mirrored, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent);
+PackedVertex UPackVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const VertexBounds& bounds);
+PackedTangentVertex UPackTangentVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv,
+    const glm::vec3& tangent, const glm::vec3& bitangent, const VertexBounds& bounds);
+std::vector<PackedVertex> UPackVertices(const float* vertices, size_t count, const VertexBounds& bounds);
+
+// GLSL for the matching shader side, to paste after a shader's #version line:
+// decodeNormal(vec3) turns the fetched (x, y, 0) snorm attribute of a PackedVertex back into a unit normal,
+// decodeTangentFrame(vec4 frame, float mirrored, out normal, out tangent, out bitangent) expands a PackedTangentVertex
+// frame, with mirrored being the fetched position's w.
+extern const char* const PACKED_NORMAL_GLSL;
+extern const char* const PACKED_TANGENT_FRAME_GLSL;
+
+#endif